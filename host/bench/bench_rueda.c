@@ -0,0 +1,245 @@
+/*
+===============================================================================
+ Nombre      : bench_rueda.c
+ Description : Medición de la rueda de timers con miles de timers armados
+               (ver rueda.h), contra una lista recorrida en cada tick
+
+ Cada escenario verifica además que todos los timers venzan en su tick.
+ Los tiempos son de la PC: sirven para comparar escenarios y ver cómo
+ escala el costo con la cantidad de timers, no como valores absolutos
+ de la placa.
+===============================================================================
+*/
+
+#include <time.h>
+#include "prueba.h"
+#include "rueda.h"
+
+#define TIMERS_MAX 20000
+#define HORIZONTE (1UL << 16) // Ticks de los escenarios de una sola vez (~11 minutos a 100[Hz])
+#define PERIODO_MAX 1000 // [ticks]
+#define TICKS_PERIODICOS 100000
+
+typedef struct
+{
+	rueda_timer_t timer;
+	uint32_t esperado; // Tick del próximo vencimiento
+	uint32_t vencimientos;
+	uint32_t tarde; // Vencimientos fuera de su tick
+} medido_t;
+
+static medido_t medidos[TIMERS_MAX];
+static uint32_t vence_lista[TIMERS_MAX]; // Referencia: vencimientos en un arreglo
+
+/**
+ * @brief Tiempo de la PC [ns].
+ */
+static uint64_t ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+static void vencer(void *arg)
+{
+	medido_t *m = (medido_t *)arg;
+
+	if (rueda_ahora() != m->esperado)
+		m->tarde++;
+
+	m->vencimientos++;
+	m->esperado += m->timer.periodo;
+}
+
+/**
+ * @brief Avanza la rueda hasta el tick fin y devuelve la mayor
+ * 		  cantidad de timers vencidos en un mismo tick; en total deja
+ * 		  el tiempo de todos los ticks [ns].
+ *
+ * @details El peor tick no se mide en tiempo: en la PC lo dominan
+ * 			las interrupciones del sistema operativo.
+ */
+static uint32_t avanzar_hasta(uint32_t fin, uint64_t *total)
+{
+	uint32_t peor = 0;
+	uint64_t t0 = ns();
+
+	while (rueda_ahora() != fin)
+	{
+		uint32_t vencidos = rueda_avanzar();
+
+		if (vencidos > peor)
+			peor = vencidos;
+	}
+
+	*total = ns() - t0;
+
+	return peor;
+}
+
+/**
+ * @brief n timers de una sola vez con vencimientos al azar dentro de
+ * 		  HORIZONTE: costo de armar y de cada tick.
+ */
+static void una_vez(uint32_t n)
+{
+	uint64_t total;
+
+	rueda_init(0);
+
+	uint64_t t0 = ns();
+
+	for (uint32_t i = 0; i < n; i++)
+	{
+		uint32_t ticks = 1 + (prueba_azar() % HORIZONTE);
+
+		medidos[i].esperado = ticks;
+		medidos[i].vencimientos = 0;
+		medidos[i].tarde = 0;
+		rueda_armar(&medidos[i].timer, ticks, 0, vencer, &medidos[i]);
+	}
+
+	uint64_t armar = ns() - t0;
+	uint32_t peor = avanzar_hasta(HORIZONTE + 1, &total);
+	uint32_t tarde = 0, vencidos = 0;
+
+	for (uint32_t i = 0; i < n; i++)
+	{
+		tarde += medidos[i].tarde;
+		vencidos += medidos[i].vencimientos;
+	}
+
+	VERIFICAR_IGUAL(vencidos, n);
+	VERIFICAR_IGUAL(tarde, 0);
+
+	printf("  una vez     %6u timers: armar %5.1f[ns], tick %7.1f[ns], hasta %3u vencidos por tick\n",
+		n, (double)armar / n, (double)total / HORIZONTE, peor);
+}
+
+/**
+ * @brief La misma carga con un arreglo que se recorre entero en cada
+ * 		  tick, la alternativa sin rueda.
+ */
+static void una_vez_lista(uint32_t n)
+{
+	uint32_t vencidos = 0;
+
+	for (uint32_t i = 0; i < n; i++)
+		vence_lista[i] = 1 + (prueba_azar() % HORIZONTE);
+
+	uint64_t t0 = ns();
+
+	for (uint32_t ahora = 1; ahora <= HORIZONTE; ahora++)
+		for (uint32_t i = 0; i < n; i++)
+			if (vence_lista[i] == ahora)
+				vencidos++;
+
+	uint64_t total = ns() - t0;
+
+	VERIFICAR_IGUAL(vencidos, n);
+
+	printf("  lista       %6u timers:                    tick %7.1f[ns]\n", n, (double)total / HORIZONTE);
+}
+
+/**
+ * @brief n timers periódicos con períodos al azar de hasta
+ * 		  PERIODO_MAX ticks, TICKS_PERIODICOS ticks: todos los
+ * 		  vencimientos a tiempo y sin deriva.
+ */
+static void periodicos(uint32_t n)
+{
+	uint64_t total;
+
+	rueda_init(0);
+
+	for (uint32_t i = 0; i < n; i++)
+	{
+		uint32_t periodo = 1 + (prueba_azar() % PERIODO_MAX);
+
+		medidos[i].esperado = periodo;
+		medidos[i].vencimientos = 0;
+		medidos[i].tarde = 0;
+		rueda_armar(&medidos[i].timer, periodo, periodo, vencer, &medidos[i]);
+	}
+
+	uint32_t peor = avanzar_hasta(TICKS_PERIODICOS, &total);
+	uint32_t tarde = 0, faltan = 0;
+	uint64_t vencidos = 0;
+
+	for (uint32_t i = 0; i < n; i++)
+	{
+		tarde += medidos[i].tarde;
+		vencidos += medidos[i].vencimientos;
+		faltan += (medidos[i].vencimientos != (TICKS_PERIODICOS / medidos[i].timer.periodo));
+	}
+
+	VERIFICAR_IGUAL(tarde, 0);
+	VERIFICAR_IGUAL(faltan, 0);
+
+	printf("  periódicos  %6u timers:                    tick %7.1f[ns], hasta %3u vencidos por tick, %5.1f[ns] por vencido\n",
+		n, (double)total / TICKS_PERIODICOS, peor, (double)total / vencidos);
+
+	for (uint32_t i = 0; i < n; i++)
+		rueda_cancelar(&medidos[i].timer);
+}
+
+/**
+ * @brief n timeouts que se rearman antes de vencer (como el de
+ * 		  reposo con la cinta en uso): costo de rearmar, que
+ * 		  desenlaza y vuelve a insertar.
+ */
+static void rearmar(uint32_t n)
+{
+	const uint32_t vueltas = 20;
+
+	rueda_init(0);
+
+	for (uint32_t i = 0; i < n; i++)
+	{
+		medidos[i].vencimientos = 0;
+		rueda_armar(&medidos[i].timer, 1 + (prueba_azar() % HORIZONTE), 0, vencer, &medidos[i]);
+	}
+
+	uint64_t t0 = ns();
+
+	for (uint32_t v = 0; v < vueltas; v++)
+	{
+		for (uint32_t i = 0; i < n; i++)
+			rueda_armar(&medidos[i].timer, HORIZONTE / 2 + (prueba_azar() % HORIZONTE), 0, vencer, &medidos[i]);
+
+		rueda_avanzar();
+	}
+
+	uint64_t total = ns() - t0;
+	uint32_t vencidos = 0;
+
+	for (uint32_t i = 0; i < n; i++)
+	{
+		vencidos += medidos[i].vencimientos;
+		rueda_cancelar(&medidos[i].timer);
+	}
+
+	VERIFICAR_IGUAL(vencidos, 0);
+
+	printf("  rearmar     %6u timers: armar %5.1f[ns]\n", n, (double)total / ((uint64_t)n * vueltas));
+}
+
+int main(void)
+{
+	const uint32_t cantidades[] = { 1000, 5000, 20000 };
+
+	printf("rueda: %u niveles de %lu ranuras\n", RUEDA_NIVELES, RUEDA_RANURAS);
+
+	for (uint32_t c = 0; c < (sizeof(cantidades) / sizeof(cantidades[0])); c++)
+	{
+		una_vez(cantidades[c]);
+		una_vez_lista(cantidades[c]);
+		periodicos(cantidades[c]);
+		rearmar(cantidades[c]);
+	}
+
+	PRUEBA_FIN();
+}
@@ -0,0 +1,334 @@
+/*
+===============================================================================
+ Nombre      : decodificador.cpp
+ Description : Decodificador en la PC de las tramas que envía el equipo
+               (ver src/trama.h)
+===============================================================================
+*/
+
+#include "decodificador.h"
+
+namespace cinta
+{
+
+const size_t OVERHEAD = 4; // Encabezado (2) + CRC (2)
+const size_t CODIFICADA_MAX = PAYLOAD_MAX + OVERHEAD + 2;
+const size_t TELEMETRIA_SIZE = 24;
+const size_t ESTADO_SIZE = 46 + (2 * ZONAS);
+const size_t REGISTRO_SIZE = 8;
+const size_t SESION_ENCABEZADO = 6;
+
+static uint16_t u16(const uint8_t *p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t u32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE bit a bit (el firmware usa una tabla por nibble).
+ */
+uint16_t crc16(const uint8_t *datos, size_t len, uint16_t crc)
+{
+	for (size_t i = 0; i < len; i++)
+	{
+		crc ^= (uint16_t)(datos[i] << 8);
+
+		for (int b = 0; b < 8; b++)
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+	}
+
+	return crc;
+}
+
+std::vector<uint8_t> cobs_codificar(const std::vector<uint8_t> &datos)
+{
+	std::vector<uint8_t> out(1, 0);
+	size_t pos_codigo = 0;
+	uint8_t codigo = 1;
+
+	for (uint8_t b : datos)
+	{
+		if (b)
+		{
+			out.push_back(b);
+
+			if (++codigo < 0xff)
+				continue;
+		}
+
+		out[pos_codigo] = codigo;
+		pos_codigo = out.size();
+		out.push_back(0);
+		codigo = 1;
+	}
+
+	out[pos_codigo] = codigo;
+
+	return out;
+}
+
+bool cobs_decodificar(const uint8_t *in, size_t len, std::vector<uint8_t> &out)
+{
+	out.clear();
+
+	for (size_t i = 0; i < len;)
+	{
+		uint8_t codigo = in[i++];
+
+		if (!codigo || (i + codigo - 1 > len))
+			return false;
+
+		for (uint8_t j = 1; j < codigo; j++, i++)
+		{
+			if (!in[i])
+				return false;
+
+			out.push_back(in[i]);
+		}
+
+		if ((codigo != 0xff) && (i < len))
+			out.push_back(0);
+	}
+
+	return !out.empty();
+}
+
+std::vector<uint8_t> armar(uint8_t tipo, uint8_t seq, const std::vector<uint8_t> &payload)
+{
+	std::vector<uint8_t> cruda;
+
+	cruda.push_back((uint8_t)((VERSION << 4) | (tipo & 0xf)));
+	cruda.push_back(seq);
+	cruda.insert(cruda.end(), payload.begin(), payload.end());
+
+	uint16_t crc = crc16(cruda.data(), cruda.size());
+
+	cruda.push_back(crc & 0xff);
+	cruda.push_back(crc >> 8);
+
+	std::vector<uint8_t> out = cobs_codificar(cruda);
+
+	out.push_back(0);
+
+	return out;
+}
+
+bool leer(const Trama &t, Telemetria &out)
+{
+	if ((t.tipo != TELEMETRIA) || (t.payload.size() != TELEMETRIA_SIZE))
+		return false;
+
+	const uint8_t *p = t.payload.data();
+
+	out.ppm_x10 = u16(p);
+	out.velocidad = u16(p + 2);
+	out.temperatura = (int16_t)u16(p + 4);
+	out.distancia = u32(p + 6);
+	out.tiempo_s = u32(p + 10);
+	out.velocidad_medida = u16(p + 14);
+	out.error_velocidad = (int16_t)u16(p + 16);
+	out.energia = u16(p + 18);
+	out.ppm_media = u16(p + 20);
+	out.ritmo = u16(p + 22);
+
+	return true;
+}
+
+bool leer(const Trama &t, Sesion &out)
+{
+	if ((t.tipo != SESION) || (t.payload.size() < SESION_ENCABEZADO) || ((t.payload.size() - SESION_ENCABEZADO) % REGISTRO_SIZE))
+		return false;
+
+	const uint8_t *p = t.payload.data();
+
+	out.primero = u16(p);
+	out.total = u16(p + 2);
+	out.decimacion = u16(p + 4);
+	out.registros.clear();
+
+	for (size_t i = SESION_ENCABEZADO; i < t.payload.size(); i += REGISTRO_SIZE)
+	{
+		Registro r;
+
+		r.tiempo_s = u16(p + i);
+		r.ppm = p[i + 2];
+		r.velocidad = p[i + 3];
+		r.temperatura = (int16_t)u16(p + i + 4);
+		r.distancia = u16(p + i + 6);
+
+		out.registros.push_back(r);
+	}
+
+	return true;
+}
+
+bool leer(const Trama &t, Respuesta &out)
+{
+	if ((t.tipo != RESPUESTA) || (t.payload.size() < 2))
+		return false;
+
+	out.comando = t.payload[0];
+	out.resultado = t.payload[1];
+	out.datos.assign(t.payload.begin() + 2, t.payload.end());
+
+	return true;
+}
+
+bool leer(const Respuesta &r, Estado &out)
+{
+	if ((r.comando != CMD_ESTADO) || (r.resultado != RESP_OK) || (r.datos.size() != ESTADO_SIZE))
+		return false;
+
+	const uint8_t *p = r.datos.data();
+
+	out.encendida = p[0];
+	out.modo = p[1];
+	out.velocidad = u16(p + 2);
+	out.velocidad_medida = u16(p + 4);
+	out.distancia = u32(p + 6);
+	out.tiempo_s = u32(p + 10);
+	out.energia = u16(p + 14);
+	out.ppm_media = u16(p + 16);
+	out.latencia_max = u16(p + 18);
+
+	for (size_t i = 0; i < ZONAS; i++)
+		out.tiempo_zona[i] = u16(p + 20 + (2 * i));
+
+	out.reloj_mhz = p[20 + (2 * ZONAS)];
+	out.transicion_max_us = u16(p + 21 + (2 * ZONAS));
+
+	out.plan_latencia_max_us = u16(p + 23 + (2 * ZONAS));
+	out.teclado_ciclos_max = u16(p + 25 + (2 * ZONAS));
+	out.pulso_rechazados = u16(p + 27 + (2 * ZONAS));
+	out.estado_reintentos = u16(p + 29 + (2 * ZONAS));
+	out.uart_rx_descartadas = u16(p + 31 + (2 * ZONAS));
+	out.uart_rx_errores = u16(p + 33 + (2 * ZONAS));
+	out.uart_tx_descartadas = u16(p + 35 + (2 * ZONAS));
+	out.uart_tx_tramas_max = p[37 + (2 * ZONAS)];
+	out.cmd_invalidos = u16(p + 38 + (2 * ZONAS));
+	out.cmd_fuera_de_plazo = u16(p + 40 + (2 * ZONAS));
+	out.recuperacion_us = u32(p + 42 + (2 * ZONAS));
+
+	return true;
+}
+
+Decodificador::Decodificador() : leidas(0), desborde(false), cuentas()
+{
+	for (size_t i = 0; i < TIPOS; i++)
+	{
+		hay_seq[i] = false;
+		seq_anterior[i] = 0;
+	}
+}
+
+void Decodificador::agregar(const uint8_t *datos, size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+	{
+		if (datos[i] == 0)
+		{
+			cerrar();
+
+			continue;
+		}
+
+		if (actual.size() < CODIFICADA_MAX)
+			actual.push_back(datos[i]);
+		else
+			desborde = true;
+	}
+}
+
+bool Decodificador::siguiente(Trama &t)
+{
+	if (leidas == listas.size())
+	{
+		listas.clear();
+		leidas = 0;
+
+		return false;
+	}
+
+	t = listas[leidas++];
+
+	return true;
+}
+
+/**
+ * @brief Valida la trama acumulada hasta el delimitador.
+ *
+ * @details Las pérdidas se cuentan en los tipos con numeración
+ * 			corrida. Las respuestas llevan el seq del comando, la traza
+ * 			del arranque va siempre con 0 y cada volcado de la sesión
+ * 			empieza de nuevo en 0.
+ */
+void Decodificador::cerrar()
+{
+	std::vector<uint8_t> cruda;
+	bool vacia = actual.empty();
+	bool largo = desborde;
+	bool cobs = !largo && !vacia && cobs_decodificar(actual.data(), actual.size(), cruda);
+
+	actual.clear();
+	desborde = false;
+
+	if (vacia)
+		return;
+
+	if (largo || (cobs && ((cruda.size() < OVERHEAD) || (cruda.size() > PAYLOAD_MAX + OVERHEAD))))
+	{
+		cuentas.largo++;
+
+		return;
+	}
+
+	if (!cobs)
+	{
+		cuentas.cobs++;
+
+		return;
+	}
+
+	size_t n = cruda.size();
+
+	if (crc16(cruda.data(), n - 2) != u16(&cruda[n - 2]))
+	{
+		cuentas.crc++;
+
+		return;
+	}
+
+	if ((cruda[0] >> 4) != VERSION)
+	{
+		cuentas.version++;
+
+		return;
+	}
+
+	Trama t;
+
+	t.tipo = cruda[0] & 0xf;
+	t.seq = cruda[1];
+	t.payload.assign(cruda.begin() + 2, cruda.end() - 2);
+
+	if ((t.tipo == SESION) && (t.seq == 0))
+		hay_seq[t.tipo] = false;
+
+	if ((t.tipo == TELEMETRIA) || (t.tipo == SESION) || (t.tipo == PERFIL) || (t.tipo == LATENCIA))
+	{
+		if (hay_seq[t.tipo])
+			cuentas.perdidas += (uint8_t)(t.seq - seq_anterior[t.tipo] - 1);
+
+		hay_seq[t.tipo] = true;
+		seq_anterior[t.tipo] = t.seq;
+	}
+
+	cuentas.validas++;
+	listas.push_back(t);
+}
+
+}
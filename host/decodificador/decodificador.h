@@ -0,0 +1,186 @@
+/*
+===============================================================================
+ Nombre      : decodificador.h
+ Description : Decodificador en la PC de las tramas que envía el equipo
+               (ver src/trama.h)
+
+ Implementación independiente de la del firmware (COBS, CRC-16 y
+ campos), para que las pruebas de ida y vuelta contra trama.c detecten
+ diferencias entre los dos lados del protocolo.
+===============================================================================
+*/
+
+#ifndef DECODIFICADOR_H_
+#define DECODIFICADOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cinta
+{
+
+const uint8_t VERSION = 4;
+const size_t PAYLOAD_MAX = 64;
+
+enum Tipo
+{
+	TELEMETRIA = 0x1,
+	SESION = 0x2,
+	PERFIL = 0x3,
+	COMANDO = 0x4,
+	RESPUESTA = 0x5,
+	ARRANQUE = 0x6,
+	LATENCIA = 0x7,
+	TIPOS = 0x10
+};
+
+enum Comando
+{
+	CMD_ARRANCAR = 0x01,
+	CMD_DETENER = 0x02,
+	CMD_VELOCIDAD = 0x03,
+	CMD_ESTADO = 0x04,
+	CMD_TELEMETRIA = 0x05,
+	CMD_PERFIL = 0x06
+};
+
+enum Resultado
+{
+	RESP_OK = 0,
+	RESP_DESCONOCIDO = 1,
+	RESP_ARGUMENTO = 2,
+	RESP_APAGADA = 3
+};
+
+struct Trama
+{
+	uint8_t tipo;
+	uint8_t seq;
+	std::vector<uint8_t> payload;
+};
+
+struct Telemetria
+{
+	uint16_t ppm_x10;     // [décimas de pulsaciones/min]
+	uint16_t velocidad;   // [décimas de Km/h]
+	int16_t temperatura;  // [centésimas de ºC]
+	uint32_t distancia;   // [m]
+	uint32_t tiempo_s;    // [s]
+	uint16_t velocidad_medida; // [m/h]
+	int16_t error_velocidad;   // [m/h]
+	uint16_t energia;     // [kcal]
+	uint16_t ppm_media;   // [pulsaciones/min]
+	uint16_t ritmo;       // [s/km]
+};
+
+const size_t ZONAS = 7;
+
+struct Estado
+{
+	uint8_t encendida;
+	uint8_t modo;
+	uint16_t velocidad;
+	uint16_t velocidad_medida;
+	uint32_t distancia;
+	uint32_t tiempo_s;
+	uint16_t energia;
+	uint16_t ppm_media;
+	uint16_t latencia_max; // [us]
+	uint16_t tiempo_zona[ZONAS]; // [s]
+	uint8_t reloj_mhz;
+	uint16_t transicion_max_us;
+	uint16_t plan_latencia_max_us;
+	uint16_t teclado_ciclos_max; // [ciclos]
+	uint16_t pulso_rechazados;
+	uint16_t estado_reintentos;
+	uint16_t uart_rx_descartadas;
+	uint16_t uart_rx_errores;
+	uint16_t uart_tx_descartadas;
+	uint8_t uart_tx_tramas_max;
+	uint16_t cmd_invalidos;
+	uint16_t cmd_fuera_de_plazo;
+	uint32_t recuperacion_us;
+};
+
+struct Registro
+{
+	uint16_t tiempo_s;
+	uint8_t ppm;
+	uint8_t velocidad;
+	int16_t temperatura;
+	uint16_t distancia;
+};
+
+struct Sesion
+{
+	uint16_t primero;
+	uint16_t total;
+	uint16_t decimacion;
+	std::vector<Registro> registros;
+};
+
+struct Respuesta
+{
+	uint8_t comando;
+	uint8_t resultado;
+	std::vector<uint8_t> datos;
+};
+
+uint16_t crc16(const uint8_t *datos, size_t len, uint16_t crc = 0xffff);
+std::vector<uint8_t> cobs_codificar(const std::vector<uint8_t> &datos);
+bool cobs_decodificar(const uint8_t *in, size_t len, std::vector<uint8_t> &out);
+
+/**
+ * @brief Arma una trama codificada con su delimitador, por ejemplo
+ * 		  un comando para el equipo.
+ */
+std::vector<uint8_t> armar(uint8_t tipo, uint8_t seq, const std::vector<uint8_t> &payload);
+
+bool leer(const Trama &t, Telemetria &out);
+bool leer(const Trama &t, Sesion &out);
+bool leer(const Trama &t, Respuesta &out);
+bool leer(const Respuesta &r, Estado &out);
+
+/**
+ * @brief Separa el flujo de bytes recibido en tramas y las valida.
+ *
+ * @details Los bytes pueden llegar en pedazos de cualquier tamaño.
+ * 			Las tramas inválidas se cuentan y se descartan; las
+ * 			pérdidas se calculan por tipo a partir del seq.
+ */
+class Decodificador
+{
+public:
+	struct Contadores
+	{
+		uint32_t validas;
+		uint32_t cobs;
+		uint32_t largo;
+		uint32_t crc;
+		uint32_t version;
+		uint32_t perdidas;
+	};
+
+	Decodificador();
+
+	void agregar(const uint8_t *datos, size_t len);
+	bool siguiente(Trama &t);
+
+	const Contadores &contadores() const { return cuentas; }
+
+private:
+	void cerrar();
+
+	std::vector<uint8_t> actual;
+	std::vector<Trama> listas;
+	size_t leidas;
+	bool desborde;
+	bool hay_seq[TIPOS];
+	uint8_t seq_anterior[TIPOS];
+	Contadores cuentas;
+};
+
+}
+
+#endif /* DECODIFICADOR_H_ */
@@ -0,0 +1,18 @@
+/*
+===============================================================================
+ Nombre      : cr_section_macros.h
+ Description : Simulador: en la PC no hay bancos de RAM ni secciones
+               propias, todo queda en las secciones por defecto
+===============================================================================
+*/
+
+#ifndef CR_SECTION_MACROS_H_
+#define CR_SECTION_MACROS_H_
+
+#define __DATA(bank)
+#define __BSS(bank)
+#define __NOINIT(bank)
+#define __RAMFUNC(bank)
+#define __RAM_FUNC
+
+#endif /* CR_SECTION_MACROS_H_ */
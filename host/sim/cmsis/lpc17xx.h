@@ -0,0 +1,238 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx.h
+ Description : Simulador: reemplazo de lpc17xx.h y core_cm3.h para compilar
+               el firmware en la PC
+
+ Los bloques de registros son variables globales con la misma
+ distribución de campos que se usan en src/ (sólo los periféricos del
+ equipo). Los drivers simulados (lpc17xx_*.c de host/sim) los leen y
+ escriben como lo haría el hardware, así que los accesos directos del
+ firmware a un registro funcionan igual que en la placa. El NVIC, las
+ intrínsecas y el contador de ciclos están en nucleo.c.
+===============================================================================
+*/
+
+#ifndef LPC17XX_H
+#define LPC17XX_H
+
+#include <stdint.h>
+
+#define __I volatile
+#define __O volatile
+#define __IO volatile
+
+#define __NVIC_PRIO_BITS 5
+
+typedef enum
+{
+	NonMaskableInt_IRQn = -14,
+	SysTick_IRQn = -1,
+	WDT_IRQn = 0,
+	TIMER0_IRQn = 1,
+	TIMER1_IRQn = 2,
+	TIMER2_IRQn = 3,
+	TIMER3_IRQn = 4,
+	UART0_IRQn = 5,
+	UART1_IRQn = 6,
+	UART2_IRQn = 7,
+	UART3_IRQn = 8,
+	PWM1_IRQn = 9,
+	ADC_IRQn = 22,
+	DMA_IRQn = 26,
+	RIT_IRQn = 29,
+	QEI_IRQn = 31,
+	IRQn_CANTIDAD = 35
+} IRQn_Type;
+
+/*
+ Registros. Los de sólo lectura en la placa son escribibles acá:
+ los escribe el modelo del periférico.
+*/
+typedef struct
+{
+	__IO uint32_t FLASHCFG;
+	__IO uint32_t PLL0CON;
+	__IO uint32_t PLL0CFG;
+	__IO uint32_t PLL0STAT;
+	__IO uint32_t PLL0FEED;
+	__IO uint32_t PCONP;
+	__IO uint32_t CCLKCFG;
+	__IO uint32_t PCLKSEL0;
+	__IO uint32_t PCLKSEL1;
+} LPC_SC_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t IR;
+	__IO uint32_t TCR;
+	__IO uint32_t TC;
+	__IO uint32_t PR;
+	__IO uint32_t PC;
+	__IO uint32_t MCR;
+	__IO uint32_t MR0;
+	__IO uint32_t MR1;
+	__IO uint32_t MR2;
+	__IO uint32_t MR3;
+	__IO uint32_t CCR;
+	__IO uint32_t CR0;
+	__IO uint32_t CR1;
+	__IO uint32_t EMR;
+	__IO uint32_t CTCR;
+} LPC_TIM_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t IR;
+	__IO uint32_t TCR;
+	__IO uint32_t TC;
+	__IO uint32_t PR;
+	__IO uint32_t PC;
+	__IO uint32_t MCR;
+	__IO uint32_t MR0;
+	__IO uint32_t MR1;
+	__IO uint32_t MR2;
+	__IO uint32_t MR3;
+	__IO uint32_t CCR;
+	__IO uint32_t CR0;
+	__IO uint32_t CR1;
+	__IO uint32_t MR4;
+	__IO uint32_t MR5;
+	__IO uint32_t MR6;
+	__IO uint32_t PCR;
+	__IO uint32_t LER;
+	__IO uint32_t CTCR;
+} LPC_PWM_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t RICOMPVAL;
+	__IO uint32_t RIMASK;
+	__IO uint32_t RICTRL;
+	__IO uint32_t RICOUNTER;
+} LPC_RIT_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t FIODIR;
+	__IO uint32_t FIOMASK;
+	__IO uint32_t FIOPIN;
+	__IO uint32_t FIOSET;
+	__IO uint32_t FIOCLR;
+} LPC_GPIO_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t RBR_THR;
+	__IO uint32_t IER;
+	__IO uint32_t IIR;
+	__IO uint32_t FCR;
+	__IO uint32_t LCR;
+	__IO uint32_t LSR;
+	__IO uint32_t TER;
+} LPC_UART_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t ADCR;
+	__IO uint32_t ADGDR;
+	__IO uint32_t ADINTEN;
+	__IO uint32_t ADDR[8];
+	__IO uint32_t ADSTAT;
+} LPC_ADC_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t DMACIntStat;
+	__IO uint32_t DMACIntTCStat;
+	__IO uint32_t DMACIntErrStat;
+	__IO uint32_t DMACEnbldChns;
+	__IO uint32_t DMACConfig;
+} LPC_GPDMA_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t DMACCSrcAddr;
+	__IO uint32_t DMACCDestAddr;
+	__IO uint32_t DMACCLLI;
+	__IO uint32_t DMACCControl;
+	__IO uint32_t DMACCConfig;
+} LPC_GPDMACH_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t QEICONF;
+	__IO uint32_t QEISTAT;
+	__IO uint32_t QEILOAD;
+	__IO uint32_t QEITIME;
+	__IO uint32_t QEIVEL;
+	__IO uint32_t QEICAP;
+	__IO uint32_t QEIIE;
+	__IO uint32_t QEIINTSTAT;
+	__IO uint32_t QEICLR; // Escribir 1 borra el flag de QEIINTSTAT (ver sim_qei_linea)
+} LPC_QEI_TypeDef;
+
+extern LPC_SC_TypeDef sim_sc;
+extern LPC_TIM_TypeDef sim_tim[4];
+extern LPC_PWM_TypeDef sim_pwm1;
+extern LPC_RIT_TypeDef sim_rit;
+extern LPC_GPIO_TypeDef sim_gpio[3];
+extern LPC_UART_TypeDef sim_uart2;
+extern LPC_ADC_TypeDef sim_adc;
+extern LPC_GPDMA_TypeDef sim_gpdma;
+extern LPC_GPDMACH_TypeDef sim_gpdmach[8];
+extern LPC_QEI_TypeDef sim_qei;
+
+#define LPC_SC (&sim_sc)
+#define LPC_TIM0 (&sim_tim[0])
+#define LPC_TIM1 (&sim_tim[1])
+#define LPC_TIM2 (&sim_tim[2])
+#define LPC_TIM3 (&sim_tim[3])
+#define LPC_PWM1 (&sim_pwm1)
+#define LPC_RIT (&sim_rit)
+#define LPC_GPIO0 (&sim_gpio[0])
+#define LPC_GPIO1 (&sim_gpio[1])
+#define LPC_GPIO2 (&sim_gpio[2])
+#define LPC_UART2 (&sim_uart2)
+#define LPC_ADC (&sim_adc)
+#define LPC_GPDMA (&sim_gpdma)
+#define LPC_GPDMACH0 (&sim_gpdmach[0])
+#define LPC_GPDMACH1 (&sim_gpdmach[1])
+#define LPC_GPDMACH2 (&sim_gpdmach[2])
+#define LPC_GPDMACH3 (&sim_gpdmach[3])
+#define LPC_QEI (&sim_qei)
+
+// Contador de ciclos del DWT (ver ciclos.h): avanza con el tiempo virtual
+extern volatile uint32_t sim_demcr;
+extern volatile uint32_t sim_dwt_ctrl;
+extern volatile uint32_t sim_dwt_cyccnt;
+
+#define CICLOS_DEMCR sim_demcr
+#define CICLOS_DWT_CTRL sim_dwt_ctrl
+#define CICLOS_DWT_CYCCNT sim_dwt_cyccnt
+
+// Núcleo (ver nucleo.c)
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+void NVIC_SetPriority(IRQn_Type irq, uint32_t prioridad);
+uint32_t NVIC_GetPriority(IRQn_Type irq);
+
+void __enable_irq(void);
+void __disable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+uint32_t __get_BASEPRI(void);
+void __set_BASEPRI(uint32_t basepri);
+void __WFI(void);
+uint32_t __LDREXW(volatile uint32_t *p);
+uint32_t __STREXW(uint32_t valor, volatile uint32_t *p);
+
+static inline uint32_t __CLZ(uint32_t valor)
+{
+	return valor ? (uint32_t)__builtin_clz(valor) : 32;
+}
+
+extern uint32_t SystemCoreClock;
+void SystemCoreClockUpdate(void);
+
+#endif /* LPC17XX_H */
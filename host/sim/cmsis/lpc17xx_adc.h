@@ -0,0 +1,43 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_adc.h
+ Description : Simulador: driver del ADC
+===============================================================================
+*/
+
+#ifndef LPC17XX_ADC_H_
+#define LPC17XX_ADC_H_
+
+#include "lpc17xx.h"
+#include "lpc_types.h"
+
+#define ADC_CR_CH_SEL(n) ((uint32_t)(1 << (n)))
+#define ADC_CR_CLKDIV(n) ((uint32_t)((n) << 8))
+#define ADC_CR_BURST ((uint32_t)(1 << 16))
+#define ADC_CR_PDN ((uint32_t)(1 << 21))
+
+#define ADC_GDR_RESULT(n) (((n) >> 4) & 0xfff)
+#define ADC_GDR_CH(n) (((n) >> 24) & 0x7)
+#define ADC_GDR_DONE_FLAG ((uint32_t)(1UL << 31))
+
+#define ADC_CONVERSION_CICLOS 65 // Ciclos del reloj del ADC por conversión
+
+typedef enum
+{
+	ADC_ADINTEN0 = 0,
+	ADC_ADINTEN1,
+	ADC_ADINTEN2,
+	ADC_ADINTEN3,
+	ADC_ADINTEN4,
+	ADC_ADINTEN5,
+	ADC_ADINTEN6,
+	ADC_ADINTEN7,
+	ADC_ADGINTEN
+} ADC_TYPE_INT_OPT;
+
+void ADC_Init(LPC_ADC_TypeDef *adc, uint32_t frecuencia);
+void ADC_ChannelCmd(LPC_ADC_TypeDef *adc, uint8_t canal, FunctionalState estado);
+void ADC_BurstCmd(LPC_ADC_TypeDef *adc, FunctionalState estado);
+void ADC_IntConfig(LPC_ADC_TypeDef *adc, ADC_TYPE_INT_OPT tipo, FunctionalState estado);
+
+#endif /* LPC17XX_ADC_H_ */
@@ -0,0 +1,33 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_clkpwr.h
+ Description : Simulador: divisores de PCLK
+===============================================================================
+*/
+
+#ifndef LPC17XX_CLKPWR_H_
+#define LPC17XX_CLKPWR_H_
+
+#include "lpc17xx.h"
+#include "lpc_types.h"
+
+// Posición del divisor de cada periférico en PCLKSEL0 (0-31) y PCLKSEL1 (32-63)
+#define CLKPWR_PCLKSEL_TIMER0 ((uint32_t)(2))
+#define CLKPWR_PCLKSEL_TIMER1 ((uint32_t)(4))
+#define CLKPWR_PCLKSEL_PWM1 ((uint32_t)(12))
+#define CLKPWR_PCLKSEL_ADC ((uint32_t)(24))
+#define CLKPWR_PCLKSEL_QEI ((uint32_t)(32))
+#define CLKPWR_PCLKSEL_TIMER2 ((uint32_t)(44))
+#define CLKPWR_PCLKSEL_TIMER3 ((uint32_t)(46))
+#define CLKPWR_PCLKSEL_UART2 ((uint32_t)(48))
+#define CLKPWR_PCLKSEL_RIT ((uint32_t)(58))
+
+#define CLKPWR_PCLKSEL_CCLK_DIV_4 ((uint32_t)(0))
+#define CLKPWR_PCLKSEL_CCLK_DIV_1 ((uint32_t)(1))
+#define CLKPWR_PCLKSEL_CCLK_DIV_2 ((uint32_t)(2))
+#define CLKPWR_PCLKSEL_CCLK_DIV_8 ((uint32_t)(3))
+
+void CLKPWR_SetPCLKDiv(uint32_t periferico, uint32_t divisor);
+uint32_t CLKPWR_GetPCLK(uint32_t periferico);
+
+#endif /* LPC17XX_CLKPWR_H_ */
@@ -0,0 +1,88 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_gpdma.h
+ Description : Simulador: driver del GPDMA
+===============================================================================
+*/
+
+#ifndef LPC17XX_GPDMA_H_
+#define LPC17XX_GPDMA_H_
+
+#include "lpc17xx.h"
+#include "lpc_types.h"
+
+#define GPDMA_CONN_ADC ((4UL))
+#define GPDMA_CONN_UART2_Tx ((12UL))
+#define GPDMA_CONN_UART2_Rx ((13UL))
+
+#define GPDMA_TRANSFERTYPE_M2M ((0UL))
+#define GPDMA_TRANSFERTYPE_M2P ((1UL))
+#define GPDMA_TRANSFERTYPE_P2M ((2UL))
+
+#define GPDMA_WIDTH_BYTE ((0UL))
+#define GPDMA_WIDTH_HALFWORD ((1UL))
+#define GPDMA_WIDTH_WORD ((2UL))
+
+#define GPDMA_BSIZE_1 ((0UL))
+#define GPDMA_BSIZE_4 ((1UL))
+
+#define GPDMA_DMACCxControl_TransferSize(n) (((n) & 0xfff) << 0)
+#define GPDMA_DMACCxControl_SBSize(n) (((n) & 0x07) << 12)
+#define GPDMA_DMACCxControl_DBSize(n) (((n) & 0x07) << 15)
+#define GPDMA_DMACCxControl_SWidth(n) (((n) & 0x07) << 18)
+#define GPDMA_DMACCxControl_DWidth(n) (((n) & 0x07) << 21)
+#define GPDMA_DMACCxControl_SI ((1UL << 26))
+#define GPDMA_DMACCxControl_DI ((1UL << 27))
+#define GPDMA_DMACCxControl_I ((1UL << 31))
+
+#define GPDMA_DMACCxConfig_E ((1UL << 0))
+#define GPDMA_DMACCxConfig_SrcPeripheral(n) (((n) & 0x1f) << 1)
+#define GPDMA_DMACCxConfig_DestPeripheral(n) (((n) & 0x1f) << 6)
+#define GPDMA_DMACCxConfig_TransferType(n) (((n) & 0x7) << 11)
+#define GPDMA_DMACCxConfig_IE ((1UL << 14))
+#define GPDMA_DMACCxConfig_ITC ((1UL << 15))
+
+typedef struct
+{
+	uint32_t ChannelNum;
+	uint32_t TransferSize;
+	uint32_t TransferWidth;
+	uint32_t SrcMemAddr;
+	uint32_t DstMemAddr;
+	uint32_t TransferType;
+	uint32_t SrcConn;
+	uint32_t DstConn;
+	uint32_t DMALLI;
+} GPDMA_Channel_CFG_Type;
+
+typedef struct
+{
+	uint32_t SrcAddr;
+	uint32_t DstAddr;
+	uint32_t NextLLI;
+	uint32_t Control;
+} GPDMA_LLI_Type;
+
+typedef enum
+{
+	GPDMA_STAT_INT,
+	GPDMA_STAT_INTTC,
+	GPDMA_STAT_INTERR,
+	GPDMA_STAT_RAWINTTC,
+	GPDMA_STAT_RAWINTERR,
+	GPDMA_STAT_ENABLED_CH
+} GPDMA_Status_Type;
+
+typedef enum
+{
+	GPDMA_STATCLR_INTTC,
+	GPDMA_STATCLR_INTERR
+} GPDMA_StateClear_Type;
+
+void GPDMA_Init(void);
+Status GPDMA_Setup(GPDMA_Channel_CFG_Type *cfg);
+void GPDMA_ChannelCmd(uint8_t canal, FunctionalState estado);
+IntStatus GPDMA_IntGetStatus(GPDMA_Status_Type tipo, uint8_t canal);
+void GPDMA_ClearIntPending(GPDMA_StateClear_Type tipo, uint8_t canal);
+
+#endif /* LPC17XX_GPDMA_H_ */
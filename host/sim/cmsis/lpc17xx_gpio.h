@@ -0,0 +1,25 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_gpio.h
+ Description : Simulador: driver de GPIO (display y teclado matricial)
+===============================================================================
+*/
+
+#ifndef LPC17XX_GPIO_H_
+#define LPC17XX_GPIO_H_
+
+#include "lpc17xx.h"
+#include "lpc_types.h"
+
+void GPIO_SetDir(uint8_t puerto, uint32_t mascara, uint8_t dir);
+void GPIO_SetValue(uint8_t puerto, uint32_t mascara);
+void GPIO_ClearValue(uint8_t puerto, uint32_t mascara);
+uint32_t GPIO_ReadValue(uint8_t puerto);
+
+void FIO_ByteSetValue(uint8_t puerto, uint8_t byte, uint8_t mascara);
+void FIO_ByteClearValue(uint8_t puerto, uint8_t byte, uint8_t mascara);
+uint8_t FIO_ByteReadValue(uint8_t puerto, uint8_t byte);
+void FIO_HalfWordSetValue(uint8_t puerto, uint8_t mitad, uint16_t mascara);
+void FIO_HalfWordClearValue(uint8_t puerto, uint8_t mitad, uint16_t mascara);
+
+#endif /* LPC17XX_GPIO_H_ */
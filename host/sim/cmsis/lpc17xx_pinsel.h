@@ -0,0 +1,31 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_pinsel.h
+ Description : Simulador: driver de PINSEL (no hay pines que configurar)
+===============================================================================
+*/
+
+#ifndef LPC17XX_PINSEL_H_
+#define LPC17XX_PINSEL_H_
+
+#include "lpc17xx.h"
+#include "lpc_types.h"
+
+#define PINSEL_PINMODE_PULLUP 0
+#define PINSEL_PINMODE_TRISTATE 2
+#define PINSEL_PINMODE_PULLDOWN 3
+#define PINSEL_PINMODE_NORMAL 0
+#define PINSEL_PINMODE_OPENDRAIN 1
+
+typedef struct
+{
+	uint8_t Portnum;
+	uint8_t Pinnum;
+	uint8_t Funcnum;
+	uint8_t Pinmode;
+	uint8_t OpenDrain;
+} PINSEL_CFG_Type;
+
+void PINSEL_ConfigPin(PINSEL_CFG_Type *cfg);
+
+#endif /* LPC17XX_PINSEL_H_ */
@@ -0,0 +1,54 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_pwm.h
+ Description : Simulador: driver de PWM1
+===============================================================================
+*/
+
+#ifndef LPC17XX_PWM_H_
+#define LPC17XX_PWM_H_
+
+#include "lpc17xx.h"
+#include "lpc_types.h"
+
+#define PWM_IR_PWMMRn(n) ((uint32_t)(((n) < 4) ? _BIT(n) : _BIT((n) + 4)))
+#define PWM_LER_EN_MATCHn_LATCH(n) ((uint32_t)(((n) < 7) ? _BIT(n) : 0))
+
+#define PWM_TCR_COUNTER_ENABLE ((uint32_t)(1 << 0))
+#define PWM_TCR_COUNTER_RESET ((uint32_t)(1 << 1))
+#define PWM_TCR_PWM_ENABLE ((uint32_t)(1 << 3))
+#define PWM_PCR_PWMENAn(n) ((uint32_t)(((n) > 0) && ((n) < 7) ? _BIT((n) + 8) : 0))
+
+#define PWM_MODE_TIMER 0
+#define PWM_TIMER_PRESCALE_TICKVAL 0
+#define PWM_TIMER_PRESCALE_USVAL 1
+#define PWM_MATCH_UPDATE_NOW 0
+#define PWM_MATCH_UPDATE_NEXT_RST 1
+#define PWM_CHANNEL_SINGLE_EDGE 0
+#define PWM_CHANNEL_DUAL_EDGE 1
+
+typedef struct
+{
+	uint8_t PrescaleOption;
+	uint8_t Reserved[3];
+	uint32_t PrescaleValue;
+} PWM_TIMERCFG_Type;
+
+typedef struct
+{
+	uint8_t MatchChannel;
+	uint8_t IntOnMatch;
+	uint8_t StopOnMatch;
+	uint8_t ResetOnMatch;
+} PWM_MATCHCFG_Type;
+
+void PWM_Init(LPC_PWM_TypeDef *pwm, uint32_t modo, void *cfg);
+void PWM_Cmd(LPC_PWM_TypeDef *pwm, FunctionalState estado);
+void PWM_CounterCmd(LPC_PWM_TypeDef *pwm, FunctionalState estado);
+void PWM_ResetCounter(LPC_PWM_TypeDef *pwm);
+void PWM_MatchUpdate(LPC_PWM_TypeDef *pwm, uint8_t canal, uint32_t valor, uint8_t cuando);
+void PWM_ConfigMatch(LPC_PWM_TypeDef *pwm, PWM_MATCHCFG_Type *cfg);
+void PWM_ChannelConfig(LPC_PWM_TypeDef *pwm, uint8_t canal, uint8_t modo);
+void PWM_ChannelCmd(LPC_PWM_TypeDef *pwm, uint8_t canal, FunctionalState estado);
+
+#endif /* LPC17XX_PWM_H_ */
@@ -0,0 +1,55 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_qei.h
+ Description : Simulador: driver del QEI (sólo el timer de velocidad)
+===============================================================================
+*/
+
+#ifndef LPC17XX_QEI_H_
+#define LPC17XX_QEI_H_
+
+#include "lpc17xx.h"
+#include "lpc_types.h"
+
+#define QEI_DIRINV_NONE 0
+#define QEI_SIGNALMODE_QUAD 0
+#define QEI_CAPMODE_2X 0
+#define QEI_CAPMODE_4X 1
+#define QEI_INVINX_NONE 0
+
+#define QEI_TIMERRELOAD_TICKVAL 0
+#define QEI_TIMERRELOAD_USVAL 1
+
+#define QEI_RESET_POS ((uint32_t)(1 << 0))
+#define QEI_RESET_POSOnIDX ((uint32_t)(1 << 1))
+#define QEI_RESET_VEL ((uint32_t)(1 << 2))
+#define QEI_RESET_IDX ((uint32_t)(1 << 3))
+
+#define QEI_INTFLAG_TIM_Int ((uint32_t)(1 << 1))
+#define QEI_INTCFG_TIM ((uint32_t)(1 << 1))
+
+typedef struct
+{
+	uint32_t DirectionInvert : 1;
+	uint32_t SignalMode : 1;
+	uint32_t CaptureMode : 1;
+	uint32_t InvertIndex : 1;
+} QEI_CFG_Type;
+
+typedef struct
+{
+	uint8_t ReloadOption;
+	uint8_t Reserved[3];
+	uint32_t ReloadValue;
+} QEI_RELOADCFG_Type;
+
+void QEI_Init(LPC_QEI_TypeDef *qei, QEI_CFG_Type *cfg);
+void QEI_ConfigStructInit(QEI_CFG_Type *cfg);
+void QEI_SetTimerReload(LPC_QEI_TypeDef *qei, QEI_RELOADCFG_Type *cfg);
+void QEI_Reset(LPC_QEI_TypeDef *qei, uint32_t mascara);
+void QEI_IntCmd(LPC_QEI_TypeDef *qei, uint32_t mascara, FunctionalState estado);
+FlagStatus QEI_GetIntStatus(LPC_QEI_TypeDef *qei, uint32_t mascara);
+void QEI_IntClear(LPC_QEI_TypeDef *qei, uint32_t mascara);
+uint32_t QEI_GetVelocityCap(LPC_QEI_TypeDef *qei);
+
+#endif /* LPC17XX_QEI_H_ */
@@ -0,0 +1,24 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_rit.h
+ Description : Simulador: driver del RIT
+===============================================================================
+*/
+
+#ifndef LPC17XX_RIT_H_
+#define LPC17XX_RIT_H_
+
+#include "lpc17xx.h"
+#include "lpc_types.h"
+
+#define RIT_CTRL_INTEN ((uint32_t)(1 << 0)) // Flag de interrupción, se borra escribiendo 1
+#define RIT_CTRL_ENCLR ((uint32_t)(1 << 1))
+#define RIT_CTRL_ENBR ((uint32_t)(1 << 2))
+#define RIT_CTRL_TEN ((uint32_t)(1 << 3))
+
+void RIT_Init(LPC_RIT_TypeDef *rit);
+void RIT_TimerConfig(LPC_RIT_TypeDef *rit, uint32_t ms);
+void RIT_Cmd(LPC_RIT_TypeDef *rit, FunctionalState estado);
+IntStatus RIT_GetIntStatus(LPC_RIT_TypeDef *rit);
+
+#endif /* LPC17XX_RIT_H_ */
@@ -0,0 +1,82 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_timer.h
+ Description : Simulador: driver de los timers 0-3
+===============================================================================
+*/
+
+#ifndef LPC17XX_TIMER_H_
+#define LPC17XX_TIMER_H_
+
+#include "lpc17xx.h"
+#include "lpc_types.h"
+
+#define TIM_IR_CLR(n) _BIT(n)
+
+typedef enum
+{
+	TIM_MR0_INT = 0,
+	TIM_MR1_INT,
+	TIM_MR2_INT,
+	TIM_MR3_INT,
+	TIM_CR0_INT,
+	TIM_CR1_INT
+} TIM_INT_TYPE;
+
+typedef enum
+{
+	TIM_TIMER_MODE = 0,
+	TIM_COUNTER_RISING_MODE,
+	TIM_COUNTER_FALLING_MODE,
+	TIM_COUNTER_ANY_MODE
+} TIM_MODE_OPT;
+
+typedef enum
+{
+	TIM_PRESCALE_TICKVAL = 0,
+	TIM_PRESCALE_USVAL
+} TIM_PRESCALE_OPT;
+
+typedef enum
+{
+	TIM_EXTMATCH_NOTHING = 0,
+	TIM_EXTMATCH_LOW,
+	TIM_EXTMATCH_HIGH,
+	TIM_EXTMATCH_TOGGLE
+} TIM_EXTMATCH_OPT;
+
+typedef struct
+{
+	uint8_t PrescaleOption;
+	uint8_t Reserved[3];
+	uint32_t PrescaleValue;
+} TIM_TIMERCFG_Type;
+
+typedef struct
+{
+	uint8_t MatchChannel;
+	uint8_t IntOnMatch;
+	uint8_t StopOnMatch;
+	uint8_t ResetOnMatch;
+	uint8_t ExtMatchOutputType;
+	uint8_t Reserved[3];
+	uint32_t MatchValue;
+} TIM_MATCHCFG_Type;
+
+typedef struct
+{
+	uint8_t CaptureChannel;
+	uint8_t RisingEdge;
+	uint8_t FallingEdge;
+	uint8_t IntOnCaption;
+} TIM_CAPTURECFG_Type;
+
+void TIM_Init(LPC_TIM_TypeDef *timer, TIM_MODE_OPT modo, void *cfg);
+void TIM_Cmd(LPC_TIM_TypeDef *timer, FunctionalState estado);
+void TIM_ConfigMatch(LPC_TIM_TypeDef *timer, TIM_MATCHCFG_Type *cfg);
+void TIM_UpdateMatchValue(LPC_TIM_TypeDef *timer, uint8_t canal, uint32_t valor);
+void TIM_ConfigCapture(LPC_TIM_TypeDef *timer, TIM_CAPTURECFG_Type *cfg);
+FlagStatus TIM_GetIntStatus(LPC_TIM_TypeDef *timer, TIM_INT_TYPE tipo);
+void TIM_ClearIntPending(LPC_TIM_TypeDef *timer, TIM_INT_TYPE tipo);
+
+#endif /* LPC17XX_TIMER_H_ */
@@ -0,0 +1,94 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_uart.h
+ Description : Simulador: driver de UART2
+===============================================================================
+*/
+
+#ifndef LPC17XX_UART_H_
+#define LPC17XX_UART_H_
+
+#include "lpc17xx.h"
+#include "lpc_types.h"
+
+#define UART_LINESTAT_RDR ((uint8_t)(1 << 0))
+#define UART_LINESTAT_OE ((uint8_t)(1 << 1))
+#define UART_LINESTAT_PE ((uint8_t)(1 << 2))
+#define UART_LINESTAT_FE ((uint8_t)(1 << 3))
+#define UART_LINESTAT_BI ((uint8_t)(1 << 4))
+#define UART_LINESTAT_THRE ((uint8_t)(1 << 5))
+#define UART_LINESTAT_TEMT ((uint8_t)(1 << 6))
+
+#define UART_IIR_INTSTAT_PEND ((uint32_t)(1 << 0)) // En 1: ninguna interrupción pendiente
+#define UART_IIR_INTID_RLS ((uint32_t)(3 << 1))
+#define UART_IIR_INTID_RDA ((uint32_t)(2 << 1))
+#define UART_IIR_INTID_CTI ((uint32_t)(6 << 1))
+#define UART_IIR_INTID_THRE ((uint32_t)(1 << 1))
+#define UART_IIR_INTID_MASK ((uint32_t)(7 << 1))
+
+#define UART_IER_RBRINT_EN ((uint32_t)(1 << 0))
+#define UART_IER_THREINT_EN ((uint32_t)(1 << 1))
+#define UART_IER_RLSINT_EN ((uint32_t)(1 << 2))
+#define UART_TER_TXEN ((uint8_t)(1 << 7))
+#define UART_FCR_DMAMODE_SEL ((uint8_t)(1 << 3))
+
+#define UART_TX_FIFO_SIZE 16
+
+typedef enum
+{
+	UART_PARITY_NONE = 0
+} UART_PARITY_Type;
+
+typedef enum
+{
+	UART_DATABIT_8 = 3
+} UART_DATABIT_Type;
+
+typedef enum
+{
+	UART_STOPBIT_1 = 0
+} UART_STOPBIT_Type;
+
+typedef enum
+{
+	UART_FIFO_TRGLEV0 = 0, // 1 byte
+	UART_FIFO_TRGLEV1,     // 4 bytes
+	UART_FIFO_TRGLEV2,     // 8 bytes
+	UART_FIFO_TRGLEV3      // 14 bytes
+} UART_FITO_LEVEL_Type;
+
+typedef enum
+{
+	UART_INTCFG_RBR = 0,
+	UART_INTCFG_THRE,
+	UART_INTCFG_RLS
+} UART_INT_Type;
+
+typedef struct
+{
+	uint32_t Baud_rate;
+	UART_PARITY_Type Parity;
+	UART_DATABIT_Type Databits;
+	UART_STOPBIT_Type Stopbits;
+} UART_CFG_Type;
+
+typedef struct
+{
+	FunctionalState FIFO_ResetRxBuf;
+	FunctionalState FIFO_ResetTxBuf;
+	FunctionalState FIFO_DMAMode;
+	UART_FITO_LEVEL_Type FIFO_Level;
+} UART_FIFO_CFG_Type;
+
+void UART_Init(LPC_UART_TypeDef *uart, UART_CFG_Type *cfg);
+void UART_ConfigStructInit(UART_CFG_Type *cfg);
+void UART_FIFOConfigStructInit(UART_FIFO_CFG_Type *cfg);
+void UART_FIFOConfig(LPC_UART_TypeDef *uart, UART_FIFO_CFG_Type *cfg);
+void UART_IntConfig(LPC_UART_TypeDef *uart, UART_INT_Type tipo, FunctionalState estado);
+void UART_TxCmd(LPC_UART_TypeDef *uart, FunctionalState estado);
+FlagStatus UART_CheckBusy(LPC_UART_TypeDef *uart);
+uint32_t UART_GetIntId(LPC_UART_TypeDef *uart);
+uint8_t UART_GetLineStatus(LPC_UART_TypeDef *uart);
+uint8_t UART_ReceiveByte(LPC_UART_TypeDef *uart);
+
+#endif /* LPC17XX_UART_H_ */
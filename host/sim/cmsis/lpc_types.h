@@ -0,0 +1,25 @@
+/*
+===============================================================================
+ Nombre      : lpc_types.h
+ Description : Simulador: tipos comunes de los drivers de NXP
+===============================================================================
+*/
+
+#ifndef LPC_TYPES_H
+#define LPC_TYPES_H
+
+#include <stdint.h>
+
+typedef enum { RESET = 0, SET = !RESET } FlagStatus, IntStatus, SetState;
+typedef enum { DISABLE = 0, ENABLE = !DISABLE } FunctionalState;
+typedef enum { ERROR = 0, SUCCESS = !ERROR } Status;
+typedef enum { NONE_BLOCKING = 0, BLOCKING } TRANSFER_BLOCK_Type;
+typedef enum { FALSE = 0, TRUE = !FALSE } Bool;
+
+#ifndef NULL
+#define NULL ((void *)0)
+#endif
+
+#define _BIT(n) (1UL << (n))
+
+#endif /* LPC_TYPES_H */
@@ -0,0 +1,110 @@
+/*
+===============================================================================
+ Nombre      : hw.h
+ Description : Simulador: modelos de los periféricos, compartidos entre
+               nucleo.c, sim.c y los drivers simulados
+
+ Cada modelo avanza con el tiempo virtual en [us]:
+   _proximo   [us] hasta su próximo evento (un match, una conversión,
+              un byte de la UART), o SIM_NUNCA
+   _avanzar   avanza como mucho hasta ese evento y lo procesa
+   _linea     1 si la línea de interrupción del periférico está activa
+ El núcleo nunca avanza más que el mínimo de los _proximo, así que
+ cada llamada a _avanzar procesa a lo sumo un evento.
+===============================================================================
+*/
+
+#ifndef HW_H_
+#define HW_H_
+
+#include "lpc17xx.h"
+
+#define SIM_NUNCA UINT32_MAX
+
+/*
+ Los IR de los timers y del PWM se borran escribiendo 1, pero acá son
+ memoria común: el modelo deja el bit 31 (reservado) en 1 y, si al
+ volver a mirar el registro falta, toma lo escrito como la máscara de
+ flags a borrar. Los flags verdaderos se guardan aparte.
+*/
+#define SIM_CENTINELA (1UL << 31)
+
+uint32_t sim_w1c(volatile uint32_t *reg, uint32_t *flags);
+
+/**
+ * @brief Contador con prescaler y 4 matches, común a TIMERn y PWM1.
+ */
+typedef struct
+{
+	volatile uint32_t *tcr;
+	volatile uint32_t *tc;
+	volatile uint32_t *pr;
+	volatile uint32_t *pc;
+	volatile uint32_t *mcr;
+	volatile uint32_t *mr[4];
+	uint32_t pclksel;
+} sim_contador_t;
+
+uint32_t sim_contador_proximo(const sim_contador_t *c);
+uint32_t sim_contador_avanzar(const sim_contador_t *c, uint32_t us);
+
+// Núcleo
+void sim_nucleo_reiniciar(void);
+uint8_t sim_nucleo_despierta(void);
+void sim_nucleo_despachar(void);
+uint32_t sim_pclk_mhz(uint32_t pclksel);
+void sim_girar(uint32_t us);
+
+// Timers 0-3
+void sim_timer_reiniciar(void);
+uint32_t sim_timer_proximo(void);
+void sim_timer_avanzar(uint32_t us);
+uint8_t sim_timer_linea(uint8_t n);
+void sim_timer_flanco(uint8_t n, uint8_t canal, uint8_t subida);
+
+// PWM1
+void sim_pwm_reiniciar(void);
+uint32_t sim_pwm_proximo(void);
+void sim_pwm_avanzar(uint32_t us);
+uint8_t sim_pwm_linea(void);
+uint32_t sim_pwm_duty_q16(void);
+
+// RIT
+void sim_rit_reiniciar(void);
+uint32_t sim_rit_proximo(void);
+void sim_rit_avanzar(uint32_t us);
+uint8_t sim_rit_linea(void);
+
+// QEI: el encoder de la cinta
+void sim_qei_reiniciar(void);
+uint32_t sim_qei_proximo(void);
+void sim_qei_avanzar(uint32_t us, uint32_t flancos);
+uint8_t sim_qei_linea(void);
+
+// ADC
+void sim_adc_reiniciar(void);
+uint32_t sim_adc_proximo(void);
+void sim_adc_avanzar(uint32_t us);
+void sim_adc_entrada(uint8_t canal, uint16_t cuentas);
+
+// GPDMA
+void sim_gpdma_reiniciar(void);
+uint8_t sim_gpdma_linea(void);
+uint8_t sim_gpdma_pedido(uint32_t conexion);
+
+// UART2
+void sim_uart_reiniciar(void);
+uint32_t sim_uart_proximo(void);
+void sim_uart_avanzar(uint32_t us);
+uint8_t sim_uart_linea(void);
+uint8_t sim_uart_tx_lugar(void);
+void sim_uart_tx_escribir(uint8_t byte);
+void sim_uart_rx_encolar(const uint8_t *datos, uint32_t len);
+uint32_t sim_uart_tx_leer(uint8_t *datos, uint32_t max);
+
+// GPIO: display y teclado
+void sim_gpio_reiniciar(void);
+void sim_gpio_tecla(uint8_t tecla, uint8_t presionada);
+uint8_t sim_gpio_display(void);
+
+#endif /* HW_H_ */
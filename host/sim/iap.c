@@ -0,0 +1,100 @@
+/*
+===============================================================================
+ Nombre      : iap.c
+ Description : Simulador: IAP sobre un arreglo en RAM con la región de
+               la bitácora
+===============================================================================
+*/
+
+#include <string.h>
+#include "iap.h"
+#include "hw.h"
+#include "sim.h"
+
+#define BORRADO_US 100000 // Borrado de un sector de 32[KB] (UM10360: 100[ms])
+#define PROGRAMA_US 1000 // Programación de una página de 256 bytes (~1[ms])
+
+uint8_t sim_flash[SIM_FLASH_BYTES];
+
+static uint32_t iap(uint32_t *cmd);
+static uint8_t bitacora_borrar(uint8_t sector);
+static uint8_t bitacora_programar(uint32_t offset, const uint8_t *pagina);
+
+const bitacora_flash_t iap_bitacora =
+{
+	sim_flash,
+	IAP_SECTOR_SIZE,
+	IAP_BITACORA_SECTORES,
+	bitacora_borrar,
+	bitacora_programar
+};
+
+uint32_t iap_borrar(uint8_t inicio, uint8_t fin)
+{
+	uint32_t cmd[5] = { IAP_BORRAR, inicio, fin, SystemCoreClock / 1000, 0 };
+
+	return iap(cmd);
+}
+
+uint32_t iap_programar(uint32_t dir, const void *datos, uint32_t len)
+{
+	uint32_t cmd[5] = { IAP_COPIAR, dir, (uint32_t)(uintptr_t)datos, len, SystemCoreClock / 1000 };
+
+	return iap(cmd);
+}
+
+/**
+ * @brief Como en la placa, el borrado deja la flash en 0xff y la
+ * 		  programación sólo puede bajar bits. El tiempo que tarda
+ * 		  corre con las interrupciones enmascaradas como en src/iap.c.
+ */
+static uint32_t iap(uint32_t *cmd)
+{
+	uint32_t res = IAP_CMD_SUCCESS;
+	uint32_t us = PROGRAMA_US;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	if (cmd[0] == IAP_BORRAR)
+	{
+		uint32_t inicio = cmd[1] - IAP_BITACORA_SECTOR;
+		uint32_t fin = cmd[2] - IAP_BITACORA_SECTOR;
+
+		if ((cmd[1] < IAP_BITACORA_SECTOR) || (fin >= IAP_BITACORA_SECTORES) || (inicio > fin))
+			res = 7; // INVALID_SECTOR
+		else
+			memset(&sim_flash[inicio * IAP_SECTOR_SIZE], 0xff, (fin - inicio + 1) * IAP_SECTOR_SIZE);
+
+		us = BORRADO_US * (fin - inicio + 1);
+	}
+	else
+	{
+		uint32_t offset = cmd[1] - IAP_BITACORA_DIR;
+		const uint8_t *datos = (const uint8_t *)(uintptr_t)cmd[2];
+
+		if ((cmd[1] < IAP_BITACORA_DIR) || ((offset + cmd[3]) > SIM_FLASH_BYTES) || (offset % BITACORA_PAGINA))
+			res = 2; // DST_ADDR_ERROR
+		else
+			for (uint32_t i = 0; i < cmd[3]; i++)
+				sim_flash[offset + i] &= datos[i];
+	}
+
+	sim_girar(us);
+
+	__set_PRIMASK(primask);
+
+	return res;
+}
+
+static uint8_t bitacora_borrar(uint8_t sector)
+{
+	uint8_t s = IAP_BITACORA_SECTOR + sector;
+
+	return iap_borrar(s, s) != IAP_CMD_SUCCESS;
+}
+
+static uint8_t bitacora_programar(uint32_t offset, const uint8_t *pagina)
+{
+	return iap_programar(IAP_BITACORA_DIR + offset, pagina, BITACORA_PAGINA) != IAP_CMD_SUCCESS;
+}
@@ -0,0 +1,144 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_adc.c
+ Description : Simulador: driver y modelo del ADC en modo ráfaga
+===============================================================================
+*/
+
+#include "lpc17xx_adc.h"
+#include "lpc17xx_gpdma.h"
+#include "lpc17xx_clkpwr.h"
+#include "hw.h"
+
+#define ADCR_SEL 0xff
+#define ADCR_CLKDIV(r) (((r) >> 8) & 0xff)
+#define ADINTEN_GLOBAL (1 << ADC_ADGINTEN)
+
+LPC_ADC_TypeDef sim_adc;
+
+static uint16_t entradas[8]; // Cuentas de 12 bits en cada entrada AD0.x
+static uint64_t restante = 0; // Cuentas de PCLK hasta el fin de la conversión en curso
+static uint8_t canal = 7; // Último canal convertido
+
+static uint8_t convirtiendo(void);
+static uint64_t periodo(void);
+
+void sim_adc_reiniciar(void)
+{
+	sim_adc.ADCR = 0;
+	sim_adc.ADGDR = 0;
+	sim_adc.ADINTEN = ADINTEN_GLOBAL;
+	sim_adc.ADSTAT = 0;
+
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		sim_adc.ADDR[i] = 0;
+		entradas[i] = 0;
+	}
+
+	restante = 0;
+	canal = 7;
+}
+
+void sim_adc_entrada(uint8_t ch, uint16_t cuentas)
+{
+	entradas[ch & 7] = cuentas & 0xfff;
+}
+
+uint32_t sim_adc_proximo(void)
+{
+	uint32_t p = sim_pclk_mhz(CLKPWR_PCLKSEL_ADC);
+
+	if (!convirtiendo() || (p == 0))
+		return SIM_NUNCA;
+
+	return (uint32_t)((restante + p - 1) / p);
+}
+
+/**
+ * @brief Avanza la conversión en curso. Al terminarla publica el
+ * 		  resultado del siguiente canal habilitado (en orden
+ * 		  ascendente) y, con ADGINTEN, pide un elemento al GPDMA.
+ */
+void sim_adc_avanzar(uint32_t us)
+{
+	uint64_t cuentas = (uint64_t)us * sim_pclk_mhz(CLKPWR_PCLKSEL_ADC);
+
+	if (!convirtiendo())
+		return;
+
+	if (cuentas < restante)
+	{
+		restante -= cuentas;
+
+		return;
+	}
+
+	do
+		canal = (canal + 1) & 7;
+	while (!(sim_adc.ADCR & (1 << canal)));
+
+	uint32_t resultado = ADC_GDR_DONE_FLAG | ((uint32_t)canal << 24) | ((uint32_t)entradas[canal] << 4);
+
+	sim_adc.ADDR[canal] = resultado;
+	sim_adc.ADGDR = resultado;
+	sim_adc.ADSTAT |= 1 << canal;
+	restante = periodo();
+
+	if (sim_adc.ADINTEN & ADINTEN_GLOBAL)
+		sim_gpdma_pedido(GPDMA_CONN_ADC);
+}
+
+static uint8_t convirtiendo(void)
+{
+	return (sim_adc.ADCR & ADC_CR_BURST) && (sim_adc.ADCR & ADC_CR_PDN) && (sim_adc.ADCR & ADCR_SEL);
+}
+
+/**
+ * @brief Cuentas de PCLK por conversión.
+ */
+static uint64_t periodo(void)
+{
+	return (uint64_t)(ADCR_CLKDIV(sim_adc.ADCR) + 1) * ADC_CONVERSION_CICLOS;
+}
+
+/**
+ * @brief Como el driver de NXP: reescribe el ADCR completo, con el
+ * 		  divisor más cercano a la frecuencia pedida.
+ */
+void ADC_Init(LPC_ADC_TypeDef *adc, uint32_t frecuencia)
+{
+	uint32_t pclk = CLKPWR_GetPCLK(CLKPWR_PCLKSEL_ADC);
+	uint32_t ciclos = frecuencia * ADC_CONVERSION_CICLOS;
+	uint32_t div = (pclk + (ciclos / 2)) / ciclos;
+
+	adc->ADCR = ADC_CR_CLKDIV(div ? (div - 1) : 0) | ADC_CR_PDN;
+}
+
+void ADC_ChannelCmd(LPC_ADC_TypeDef *adc, uint8_t ch, FunctionalState estado)
+{
+	if (estado == ENABLE)
+		adc->ADCR |= ADC_CR_CH_SEL(ch);
+	else
+		adc->ADCR &= ~ADC_CR_CH_SEL(ch);
+}
+
+void ADC_BurstCmd(LPC_ADC_TypeDef *adc, FunctionalState estado)
+{
+	if (estado == ENABLE)
+	{
+		adc->ADCR |= ADC_CR_BURST;
+		restante = periodo();
+		canal = 7;
+	}
+	else
+		adc->ADCR &= ~ADC_CR_BURST;
+}
+
+void ADC_IntConfig(LPC_ADC_TypeDef *adc, ADC_TYPE_INT_OPT tipo, FunctionalState estado)
+{
+	if (estado == ENABLE)
+		adc->ADINTEN |= 1 << tipo;
+	else
+		adc->ADINTEN &= ~(1 << tipo);
+}
@@ -0,0 +1,42 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_clkpwr.c
+ Description : Simulador: divisores de PCLK
+===============================================================================
+*/
+
+#include "lpc17xx_clkpwr.h"
+#include "hw.h"
+
+LPC_SC_TypeDef sim_sc;
+
+static volatile uint32_t *pclksel(uint32_t periferico);
+
+void CLKPWR_SetPCLKDiv(uint32_t periferico, uint32_t divisor)
+{
+	volatile uint32_t *reg = pclksel(periferico);
+	uint32_t pos = periferico % 32;
+
+	*reg = (*reg & ~(3UL << pos)) | ((divisor & 3) << pos);
+}
+
+uint32_t CLKPWR_GetPCLK(uint32_t periferico)
+{
+	static const uint8_t divisores[] = { 4, 1, 2, 8 };
+
+	return SystemCoreClock / divisores[(*pclksel(periferico) >> (periferico % 32)) & 3];
+}
+
+/**
+ * @brief PCLK de un periférico en [MHz]: cuentas por [us] de tiempo
+ * 		  virtual. Con los perfiles de reloj.h es siempre entera.
+ */
+uint32_t sim_pclk_mhz(uint32_t periferico)
+{
+	return CLKPWR_GetPCLK(periferico) / 1000000;
+}
+
+static volatile uint32_t *pclksel(uint32_t periferico)
+{
+	return (periferico < 32) ? &LPC_SC->PCLKSEL0 : &LPC_SC->PCLKSEL1;
+}
@@ -0,0 +1,279 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_gpdma.c
+ Description : Simulador: driver y modelo del GPDMA
+===============================================================================
+*/
+
+#include "lpc17xx_gpdma.h"
+#include "hw.h"
+
+#define CANALES 8
+#define CONTROL_CUENTA 0xfff
+#define CONFIG_TIPO(c) (((c) >> 11) & 0x7)
+#define CONFIG_ORIGEN(c) (((c) >> 1) & 0x1f)
+#define CONFIG_DESTINO(c) (((c) >> 6) & 0x1f)
+#define CONTROL_SWIDTH(c) (((c) >> 18) & 0x7)
+#define CONTROL_DWIDTH(c) (((c) >> 21) & 0x7)
+
+LPC_GPDMA_TypeDef sim_gpdma;
+LPC_GPDMACH_TypeDef sim_gpdmach[CANALES];
+
+static uint32_t leer(uint32_t direccion, uint32_t ancho);
+static void escribir(uint32_t direccion, uint32_t ancho, uint32_t valor);
+static void terminar(uint8_t n);
+static void actualizar(void);
+
+void sim_gpdma_reiniciar(void)
+{
+	sim_gpdma.DMACIntStat = 0;
+	sim_gpdma.DMACIntTCStat = 0;
+	sim_gpdma.DMACIntErrStat = 0;
+	sim_gpdma.DMACEnbldChns = 0;
+	sim_gpdma.DMACConfig = 0;
+
+	for (uint8_t n = 0; n < CANALES; n++)
+	{
+		sim_gpdmach[n].DMACCSrcAddr = 0;
+		sim_gpdmach[n].DMACCDestAddr = 0;
+		sim_gpdmach[n].DMACCLLI = 0;
+		sim_gpdmach[n].DMACCControl = 0;
+		sim_gpdmach[n].DMACCConfig = 0;
+	}
+}
+
+uint8_t sim_gpdma_linea(void)
+{
+	return sim_gpdma.DMACIntStat != 0;
+}
+
+/**
+ * @brief Pedido de un periférico: el canal habilitado que lo atiende
+ * 		  mueve un elemento.
+ *
+ * @return 1 si algún canal movió un elemento.
+ */
+uint8_t sim_gpdma_pedido(uint32_t conexion)
+{
+	for (uint8_t n = 0; n < CANALES; n++)
+	{
+		LPC_GPDMACH_TypeDef *ch = &sim_gpdmach[n];
+		uint32_t config = ch->DMACCConfig;
+		uint32_t control = ch->DMACCControl;
+
+		if (!(config & GPDMA_DMACCxConfig_E) || !(sim_gpdma.DMACConfig & 1))
+			continue;
+
+		if (!((CONFIG_TIPO(config) == GPDMA_TRANSFERTYPE_P2M) && (CONFIG_ORIGEN(config) == conexion)) &&
+			!((CONFIG_TIPO(config) == GPDMA_TRANSFERTYPE_M2P) && (CONFIG_DESTINO(config) == conexion)))
+			continue;
+
+		uint32_t valor = leer(ch->DMACCSrcAddr, CONTROL_SWIDTH(control));
+
+		if (conexion == GPDMA_CONN_UART2_Tx)
+			sim_uart_tx_escribir((uint8_t)valor);
+		else
+			escribir(ch->DMACCDestAddr, CONTROL_DWIDTH(control), valor);
+
+		if (control & GPDMA_DMACCxControl_SI)
+			ch->DMACCSrcAddr += 1 << CONTROL_SWIDTH(control);
+
+		if (control & GPDMA_DMACCxControl_DI)
+			ch->DMACCDestAddr += 1 << CONTROL_DWIDTH(control);
+
+		uint32_t cuenta = (control & CONTROL_CUENTA) - 1;
+
+		ch->DMACCControl = (control & ~CONTROL_CUENTA) | cuenta;
+
+		if (cuenta == 0)
+			terminar(n);
+
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Fin de la cuenta de un canal: con el bit I levanta el flag
+ * 		  de fin de transferencia y sigue con la próxima LLI, si hay.
+ */
+static void terminar(uint8_t n)
+{
+	LPC_GPDMACH_TypeDef *ch = &sim_gpdmach[n];
+
+	if (ch->DMACCControl & GPDMA_DMACCxControl_I)
+		sim_gpdma.DMACIntTCStat |= 1 << n;
+
+	if (ch->DMACCLLI)
+	{
+		const GPDMA_LLI_Type *lli = (const GPDMA_LLI_Type *)(uintptr_t)ch->DMACCLLI;
+
+		ch->DMACCSrcAddr = lli->SrcAddr;
+		ch->DMACCDestAddr = lli->DstAddr;
+		ch->DMACCLLI = lli->NextLLI;
+		ch->DMACCControl = lli->Control;
+	}
+	else
+	{
+		ch->DMACCConfig &= ~GPDMA_DMACCxConfig_E;
+		sim_gpdma.DMACEnbldChns &= ~(1 << n);
+	}
+
+	actualizar();
+}
+
+static void actualizar(void)
+{
+	uint32_t tc = 0;
+	uint32_t err = 0;
+
+	for (uint8_t n = 0; n < CANALES; n++)
+	{
+		if (sim_gpdmach[n].DMACCConfig & GPDMA_DMACCxConfig_ITC)
+			tc |= sim_gpdma.DMACIntTCStat & (1 << n);
+
+		if (sim_gpdmach[n].DMACCConfig & GPDMA_DMACCxConfig_IE)
+			err |= sim_gpdma.DMACIntErrStat & (1 << n);
+	}
+
+	sim_gpdma.DMACIntStat = tc | err;
+}
+
+static uint32_t leer(uint32_t direccion, uint32_t ancho)
+{
+	if (ancho == GPDMA_WIDTH_BYTE)
+		return *(volatile uint8_t *)(uintptr_t)direccion;
+
+	if (ancho == GPDMA_WIDTH_HALFWORD)
+		return *(volatile uint16_t *)(uintptr_t)direccion;
+
+	return *(volatile uint32_t *)(uintptr_t)direccion;
+}
+
+static void escribir(uint32_t direccion, uint32_t ancho, uint32_t valor)
+{
+	if (ancho == GPDMA_WIDTH_BYTE)
+		*(volatile uint8_t *)(uintptr_t)direccion = (uint8_t)valor;
+	else if (ancho == GPDMA_WIDTH_HALFWORD)
+		*(volatile uint16_t *)(uintptr_t)direccion = (uint16_t)valor;
+	else
+		*(volatile uint32_t *)(uintptr_t)direccion = valor;
+}
+
+void GPDMA_Init(void)
+{
+	sim_gpdma_reiniciar();
+
+	sim_gpdma.DMACConfig = 1;
+}
+
+/**
+ * @brief Como el driver de NXP: las direcciones de los periféricos
+ * 		  salen de la conexión, y el bit I queda siempre en 1.
+ */
+Status GPDMA_Setup(GPDMA_Channel_CFG_Type *cfg)
+{
+	LPC_GPDMACH_TypeDef *ch;
+	uint32_t ancho = cfg->TransferWidth;
+	uint32_t control, config;
+
+	if (cfg->ChannelNum >= CANALES)
+		return ERROR;
+
+	ch = &sim_gpdmach[cfg->ChannelNum];
+
+	if (ch->DMACCConfig & GPDMA_DMACCxConfig_E)
+		return ERROR;
+
+	sim_gpdma.DMACIntTCStat &= ~(1 << cfg->ChannelNum);
+	sim_gpdma.DMACIntErrStat &= ~(1 << cfg->ChannelNum);
+
+	control = GPDMA_DMACCxControl_TransferSize(cfg->TransferSize) | GPDMA_DMACCxControl_I;
+	config = GPDMA_DMACCxConfig_IE | GPDMA_DMACCxConfig_ITC | GPDMA_DMACCxConfig_TransferType(cfg->TransferType);
+
+	switch (cfg->TransferType)
+	{
+	case GPDMA_TRANSFERTYPE_M2P:
+		ancho = GPDMA_WIDTH_BYTE; // Ancho de los registros de la UART
+		ch->DMACCSrcAddr = cfg->SrcMemAddr;
+		ch->DMACCDestAddr = (uint32_t)(uintptr_t)&LPC_UART2->RBR_THR;
+		control |= GPDMA_DMACCxControl_SI;
+		config |= GPDMA_DMACCxConfig_DestPeripheral(cfg->DstConn);
+		break;
+
+	case GPDMA_TRANSFERTYPE_P2M:
+		ancho = GPDMA_WIDTH_WORD; // ADGDR
+		ch->DMACCSrcAddr = (uint32_t)(uintptr_t)&LPC_ADC->ADGDR;
+		ch->DMACCDestAddr = cfg->DstMemAddr;
+		control |= GPDMA_DMACCxControl_DI;
+		config |= GPDMA_DMACCxConfig_SrcPeripheral(cfg->SrcConn);
+		break;
+
+	default:
+		ch->DMACCSrcAddr = cfg->SrcMemAddr;
+		ch->DMACCDestAddr = cfg->DstMemAddr;
+		control |= GPDMA_DMACCxControl_SI | GPDMA_DMACCxControl_DI;
+		break;
+	}
+
+	ch->DMACCLLI = cfg->DMALLI;
+	ch->DMACCControl = control | GPDMA_DMACCxControl_SWidth(ancho) | GPDMA_DMACCxControl_DWidth(ancho);
+	ch->DMACCConfig = config;
+
+	actualizar();
+
+	return SUCCESS;
+}
+
+void GPDMA_ChannelCmd(uint8_t canal, FunctionalState estado)
+{
+	if (estado == ENABLE)
+	{
+		sim_gpdmach[canal].DMACCConfig |= GPDMA_DMACCxConfig_E;
+		sim_gpdma.DMACEnbldChns |= 1 << canal;
+	}
+	else
+	{
+		sim_gpdmach[canal].DMACCConfig &= ~GPDMA_DMACCxConfig_E;
+		sim_gpdma.DMACEnbldChns &= ~(1 << canal);
+	}
+}
+
+IntStatus GPDMA_IntGetStatus(GPDMA_Status_Type tipo, uint8_t canal)
+{
+	uint32_t reg;
+
+	switch (tipo)
+	{
+	case GPDMA_STAT_INT:
+		reg = sim_gpdma.DMACIntStat;
+		break;
+
+	case GPDMA_STAT_INTTC:
+	case GPDMA_STAT_RAWINTTC:
+		reg = sim_gpdma.DMACIntTCStat;
+		break;
+
+	case GPDMA_STAT_INTERR:
+	case GPDMA_STAT_RAWINTERR:
+		reg = sim_gpdma.DMACIntErrStat;
+		break;
+
+	default:
+		reg = sim_gpdma.DMACEnbldChns;
+		break;
+	}
+
+	return (reg & (1 << canal)) ? SET : RESET;
+}
+
+void GPDMA_ClearIntPending(GPDMA_StateClear_Type tipo, uint8_t canal)
+{
+	if (tipo == GPDMA_STATCLR_INTTC)
+		sim_gpdma.DMACIntTCStat &= ~(1 << canal);
+	else
+		sim_gpdma.DMACIntErrStat &= ~(1 << canal);
+
+	actualizar();
+}
@@ -0,0 +1,123 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_gpio.c
+ Description : Simulador: driver de GPIO, display de 7 segmentos en
+               P0.0-6 y teclado matricial en P2.0-7
+===============================================================================
+*/
+
+#include "lpc17xx_gpio.h"
+#include "hw.h"
+
+#define FILAS 4 // P2.0-3, salidas
+#define COLUMNAS 4 // P2.4-7, entradas con pull-up
+
+LPC_GPIO_TypeDef sim_gpio[3];
+
+static uint16_t teclas = 0; // Bit 4 * fila + columna en 1: presionada
+
+static uint32_t leer(uint8_t puerto);
+
+void sim_gpio_reiniciar(void)
+{
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		sim_gpio[i].FIODIR = 0;
+		sim_gpio[i].FIOPIN = 0;
+	}
+
+	teclas = 0;
+}
+
+void sim_gpio_tecla(uint8_t tecla, uint8_t presionada)
+{
+	if (presionada)
+		teclas |= 1 << tecla;
+	else
+		teclas &= ~(1 << tecla);
+}
+
+/**
+ * @brief Devuelve lo que muestra el display (P0.0-6).
+ */
+uint8_t sim_gpio_display(void)
+{
+	return sim_gpio[0].FIOPIN & 0x7f;
+}
+
+void GPIO_SetDir(uint8_t puerto, uint32_t mascara, uint8_t dir)
+{
+	if (dir)
+		sim_gpio[puerto].FIODIR |= mascara;
+	else
+		sim_gpio[puerto].FIODIR &= ~mascara;
+}
+
+void GPIO_SetValue(uint8_t puerto, uint32_t mascara)
+{
+	sim_gpio[puerto].FIOPIN |= mascara;
+}
+
+void GPIO_ClearValue(uint8_t puerto, uint32_t mascara)
+{
+	sim_gpio[puerto].FIOPIN &= ~mascara;
+}
+
+uint32_t GPIO_ReadValue(uint8_t puerto)
+{
+	return leer(puerto);
+}
+
+void FIO_ByteSetValue(uint8_t puerto, uint8_t byte, uint8_t mascara)
+{
+	GPIO_SetValue(puerto, (uint32_t)mascara << (8 * byte));
+}
+
+void FIO_ByteClearValue(uint8_t puerto, uint8_t byte, uint8_t mascara)
+{
+	GPIO_ClearValue(puerto, (uint32_t)mascara << (8 * byte));
+}
+
+uint8_t FIO_ByteReadValue(uint8_t puerto, uint8_t byte)
+{
+	return (leer(puerto) >> (8 * byte)) & 0xff;
+}
+
+void FIO_HalfWordSetValue(uint8_t puerto, uint8_t mitad, uint16_t mascara)
+{
+	GPIO_SetValue(puerto, (uint32_t)mascara << (16 * mitad));
+}
+
+void FIO_HalfWordClearValue(uint8_t puerto, uint8_t mitad, uint16_t mascara)
+{
+	GPIO_ClearValue(puerto, (uint32_t)mascara << (16 * mitad));
+}
+
+/**
+ * @brief Valor de los pines de un puerto. Las salidas valen lo
+ * 		  escrito; en P2, cada columna lee '0' si alguna tecla
+ * 		  presionada la une con una fila en '0'.
+ */
+static uint32_t leer(uint8_t puerto)
+{
+	uint32_t pines = sim_gpio[puerto].FIOPIN;
+
+	if (puerto != 2)
+		return pines;
+
+	for (uint8_t c = 0; c < COLUMNAS; c++)
+	{
+		uint8_t baja = 0;
+
+		for (uint8_t f = 0; f < FILAS; f++)
+			if ((teclas & (1 << ((COLUMNAS * f) + c))) && (sim_gpio[2].FIODIR & (1 << f)) && !(pines & (1 << f)))
+				baja = 1;
+
+		if (baja)
+			pines &= ~(1UL << (FILAS + c));
+		else
+			pines |= 1UL << (FILAS + c);
+	}
+
+	return pines;
+}
@@ -0,0 +1,17 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_pinsel.c
+ Description : Simulador: driver de PINSEL
+===============================================================================
+*/
+
+#include "lpc17xx_pinsel.h"
+
+/**
+ * @brief Los modelos de los periféricos no dependen de la función de
+ * 		  los pines.
+ */
+void PINSEL_ConfigPin(PINSEL_CFG_Type *cfg)
+{
+	(void)cfg;
+}
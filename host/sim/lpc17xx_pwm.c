@@ -0,0 +1,210 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_pwm.c
+ Description : Simulador: driver y modelo de PWM1
+===============================================================================
+*/
+
+#include "lpc17xx_pwm.h"
+#include "lpc17xx_clkpwr.h"
+#include "hw.h"
+
+#define MCR_CANAL(x) (7UL << (3 * (x)))
+#define MCR_INT(x) (1UL << (3 * (x)))
+#define MCR_RESET(x) (1UL << ((3 * (x)) + 1))
+#define MCR_STOP(x) (1UL << ((3 * (x)) + 2))
+
+LPC_PWM_TypeDef sim_pwm1;
+
+static uint32_t flags = 0; // IR verdadero (ver SIM_CENTINELA)
+static volatile uint32_t sombra[4]; // Matches en uso: los MRx se copian acá con LER
+static sim_contador_t contador;
+
+static void latchear(void);
+
+void sim_pwm_reiniciar(void)
+{
+	sim_pwm1.TCR = 0;
+	sim_pwm1.TC = 0;
+	sim_pwm1.PR = 0;
+	sim_pwm1.PC = 0;
+	sim_pwm1.MCR = 0;
+	sim_pwm1.PCR = 0;
+	sim_pwm1.LER = 0;
+	sim_pwm1.IR = SIM_CENTINELA;
+	flags = 0;
+
+	for (uint8_t x = 0; x < 4; x++)
+		sombra[x] = 0;
+
+	contador.tcr = &sim_pwm1.TCR;
+	contador.tc = &sim_pwm1.TC;
+	contador.pr = &sim_pwm1.PR;
+	contador.pc = &sim_pwm1.PC;
+	contador.mcr = &sim_pwm1.MCR;
+	contador.mr[0] = &sombra[0];
+	contador.mr[1] = &sombra[1];
+	contador.mr[2] = &sombra[2];
+	contador.mr[3] = &sombra[3];
+	contador.pclksel = CLKPWR_PCLKSEL_PWM1;
+}
+
+uint32_t sim_pwm_proximo(void)
+{
+	latchear();
+
+	return sim_contador_proximo(&contador);
+}
+
+/**
+ * @brief Avanza el contador. En cada match de MR0 (comienzo de
+ * 		  período) toma los MRx habilitados en LER.
+ */
+void sim_pwm_avanzar(uint32_t us)
+{
+	latchear();
+
+	uint32_t coincidencias = sim_contador_avanzar(&contador, us);
+
+	if (coincidencias & 1)
+	{
+		for (uint8_t x = 0; x < 4; x++)
+			if (sim_pwm1.LER & (1 << x))
+				sombra[x] = (&sim_pwm1.MR0)[x];
+
+		sim_pwm1.LER = 0;
+	}
+
+	sim_w1c(&sim_pwm1.IR, &flags);
+
+	for (uint8_t x = 0; x < 4; x++)
+		if ((coincidencias & (1 << x)) && (sim_pwm1.MCR & MCR_INT(x)))
+			flags |= PWM_IR_PWMMRn(x);
+
+	sim_pwm1.IR = flags | SIM_CENTINELA;
+}
+
+uint8_t sim_pwm_linea(void)
+{
+	return sim_w1c(&sim_pwm1.IR, &flags) != 0;
+}
+
+/**
+ * @brief Duty de PWM1.1 en Q16 (0 si la salida no está activa).
+ */
+uint32_t sim_pwm_duty_q16(void)
+{
+	const uint32_t activo = PWM_TCR_COUNTER_ENABLE | PWM_TCR_PWM_ENABLE;
+
+	latchear();
+
+	if (((sim_pwm1.TCR & activo) != activo) || !(sim_pwm1.PCR & PWM_PCR_PWMENAn(1)) || !sombra[0])
+		return 0;
+
+	if (sombra[1] >= sombra[0])
+		return 1 << 16;
+
+	return (uint32_t)(((uint64_t)sombra[1] << 16) / sombra[0]);
+}
+
+/**
+ * @brief Fuera del modo PWM los MRx se usan apenas se escriben.
+ */
+static void latchear(void)
+{
+	if (sim_pwm1.TCR & PWM_TCR_PWM_ENABLE)
+		return;
+
+	for (uint8_t x = 0; x < 4; x++)
+		sombra[x] = (&sim_pwm1.MR0)[x];
+}
+
+void PWM_Init(LPC_PWM_TypeDef *pwm, uint32_t modo, void *cfg)
+{
+	PWM_TIMERCFG_Type *c = (PWM_TIMERCFG_Type *)cfg;
+
+	pwm->TCR = 0;
+	pwm->TC = 0;
+	pwm->PC = 0;
+	pwm->MCR = 0;
+	pwm->PCR = 0;
+	pwm->LER = 0;
+	pwm->CTCR = modo;
+
+	if (c->PrescaleOption == PWM_TIMER_PRESCALE_USVAL)
+		pwm->PR = (sim_pclk_mhz(CLKPWR_PCLKSEL_PWM1) * c->PrescaleValue) - 1;
+	else
+		pwm->PR = c->PrescaleValue - 1;
+
+	flags = 0;
+	pwm->IR = SIM_CENTINELA;
+}
+
+void PWM_Cmd(LPC_PWM_TypeDef *pwm, FunctionalState estado)
+{
+	latchear(); // Lo escrito con el modo PWM apagado ya está en uso
+
+	if (estado == ENABLE)
+		pwm->TCR |= PWM_TCR_PWM_ENABLE;
+	else
+		pwm->TCR &= ~PWM_TCR_PWM_ENABLE;
+}
+
+void PWM_CounterCmd(LPC_PWM_TypeDef *pwm, FunctionalState estado)
+{
+	if (estado == ENABLE)
+		pwm->TCR |= PWM_TCR_COUNTER_ENABLE;
+	else
+		pwm->TCR &= ~PWM_TCR_COUNTER_ENABLE;
+}
+
+void PWM_ResetCounter(LPC_PWM_TypeDef *pwm)
+{
+	pwm->TC = 0;
+	pwm->PC = 0;
+}
+
+void PWM_MatchUpdate(LPC_PWM_TypeDef *pwm, uint8_t canal, uint32_t valor, uint8_t cuando)
+{
+	if (canal > 3)
+		return;
+
+	(&pwm->MR0)[canal] = valor;
+	pwm->LER |= PWM_LER_EN_MATCHn_LATCH(canal);
+
+	if (cuando == PWM_MATCH_UPDATE_NOW)
+		sombra[canal] = valor;
+}
+
+void PWM_ConfigMatch(LPC_PWM_TypeDef *pwm, PWM_MATCHCFG_Type *cfg)
+{
+	uint8_t x = cfg->MatchChannel;
+	uint32_t mcr = pwm->MCR & ~MCR_CANAL(x);
+
+	if (cfg->IntOnMatch)
+		mcr |= MCR_INT(x);
+
+	if (cfg->ResetOnMatch)
+		mcr |= MCR_RESET(x);
+
+	if (cfg->StopOnMatch)
+		mcr |= MCR_STOP(x);
+
+	pwm->MCR = mcr;
+}
+
+void PWM_ChannelConfig(LPC_PWM_TypeDef *pwm, uint8_t canal, uint8_t modo)
+{
+	if (modo == PWM_CHANNEL_DUAL_EDGE)
+		pwm->PCR |= 1 << canal;
+	else
+		pwm->PCR &= ~(1 << canal);
+}
+
+void PWM_ChannelCmd(LPC_PWM_TypeDef *pwm, uint8_t canal, FunctionalState estado)
+{
+	if (estado == ENABLE)
+		pwm->PCR |= PWM_PCR_PWMENAn(canal);
+	else
+		pwm->PCR &= ~PWM_PCR_PWMENAn(canal);
+}
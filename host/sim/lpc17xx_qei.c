@@ -0,0 +1,136 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_qei.c
+ Description : Simulador: driver y modelo del QEI (timer de velocidad)
+===============================================================================
+*/
+
+#include "lpc17xx_qei.h"
+#include "lpc17xx_clkpwr.h"
+#include "hw.h"
+
+LPC_QEI_TypeDef sim_qei;
+
+static uint64_t restante = 0; // Cuentas de PCLK hasta el fin de la ventana
+
+void sim_qei_reiniciar(void)
+{
+	sim_qei.QEICONF = 0;
+	sim_qei.QEISTAT = 0;
+	sim_qei.QEILOAD = 0;
+	sim_qei.QEITIME = 0;
+	sim_qei.QEIVEL = 0;
+	sim_qei.QEICAP = 0;
+	sim_qei.QEIIE = 0;
+	sim_qei.QEIINTSTAT = 0;
+	sim_qei.QEICLR = 0;
+	restante = 0;
+}
+
+uint32_t sim_qei_proximo(void)
+{
+	uint32_t p = sim_pclk_mhz(CLKPWR_PCLKSEL_QEI);
+
+	if (!sim_qei.QEILOAD || (p == 0))
+		return SIM_NUNCA;
+
+	return (uint32_t)((restante + p - 1) / p);
+}
+
+/**
+ * @brief Cuenta los flancos del encoder en QEIVEL. Al vencer la
+ * 		  ventana los pasa a QEICAP y levanta el flag del timer.
+ */
+void sim_qei_avanzar(uint32_t us, uint32_t flancos)
+{
+	uint64_t cuentas = (uint64_t)us * sim_pclk_mhz(CLKPWR_PCLKSEL_QEI);
+
+	if (!sim_qei.QEILOAD)
+		return;
+
+	sim_qei.QEIINTSTAT &= ~sim_qei.QEICLR; // Un borrado del handler anterior al nuevo flag
+	sim_qei.QEICLR = 0;
+	sim_qei.QEIVEL += flancos;
+
+	if (cuentas < restante)
+	{
+		restante -= cuentas;
+
+		return;
+	}
+
+	sim_qei.QEICAP = sim_qei.QEIVEL;
+	sim_qei.QEIVEL = 0;
+	sim_qei.QEIINTSTAT |= QEI_INTFLAG_TIM_Int;
+	restante = sim_qei.QEILOAD + 1;
+}
+
+/**
+ * @brief QEICLR es memoria común: lo escrito se aplica a QEIINTSTAT
+ * 		  al mirar la línea, antes de cada despacho.
+ */
+uint8_t sim_qei_linea(void)
+{
+	sim_qei.QEIINTSTAT &= ~sim_qei.QEICLR;
+	sim_qei.QEICLR = 0;
+
+	return (sim_qei.QEIINTSTAT & sim_qei.QEIIE) != 0;
+}
+
+void QEI_Init(LPC_QEI_TypeDef *qei, QEI_CFG_Type *cfg)
+{
+	qei->QEICONF = (cfg->DirectionInvert << 0) | (cfg->SignalMode << 1) | (cfg->CaptureMode << 2) | (cfg->InvertIndex << 3);
+	qei->QEILOAD = 0;
+	qei->QEIVEL = 0;
+	qei->QEICAP = 0;
+	qei->QEIIE = 0;
+	qei->QEIINTSTAT = 0;
+	restante = 0;
+}
+
+void QEI_ConfigStructInit(QEI_CFG_Type *cfg)
+{
+	cfg->DirectionInvert = QEI_DIRINV_NONE;
+	cfg->SignalMode = QEI_SIGNALMODE_QUAD;
+	cfg->CaptureMode = QEI_CAPMODE_4X;
+	cfg->InvertIndex = QEI_INVINX_NONE;
+}
+
+void QEI_SetTimerReload(LPC_QEI_TypeDef *qei, QEI_RELOADCFG_Type *cfg)
+{
+	if (cfg->ReloadOption == QEI_TIMERRELOAD_USVAL)
+		qei->QEILOAD = (sim_pclk_mhz(CLKPWR_PCLKSEL_QEI) * cfg->ReloadValue) - 1;
+	else
+		qei->QEILOAD = cfg->ReloadValue;
+
+	restante = qei->QEILOAD + 1;
+}
+
+void QEI_Reset(LPC_QEI_TypeDef *qei, uint32_t mascara)
+{
+	if (mascara & QEI_RESET_VEL)
+		qei->QEIVEL = 0;
+}
+
+void QEI_IntCmd(LPC_QEI_TypeDef *qei, uint32_t mascara, FunctionalState estado)
+{
+	if (estado == ENABLE)
+		qei->QEIIE |= mascara;
+	else
+		qei->QEIIE &= ~mascara;
+}
+
+FlagStatus QEI_GetIntStatus(LPC_QEI_TypeDef *qei, uint32_t mascara)
+{
+	return (qei->QEIINTSTAT & mascara) ? SET : RESET;
+}
+
+void QEI_IntClear(LPC_QEI_TypeDef *qei, uint32_t mascara)
+{
+	qei->QEIINTSTAT &= ~mascara;
+}
+
+uint32_t QEI_GetVelocityCap(LPC_QEI_TypeDef *qei)
+{
+	return qei->QEICAP;
+}
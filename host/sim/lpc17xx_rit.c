@@ -0,0 +1,97 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_rit.c
+ Description : Simulador: driver y modelo del RIT
+===============================================================================
+*/
+
+#include "lpc17xx_rit.h"
+#include "lpc17xx_clkpwr.h"
+#include "hw.h"
+
+LPC_RIT_TypeDef sim_rit;
+
+void sim_rit_reiniciar(void)
+{
+	sim_rit.RICOMPVAL = 0xffffffff;
+	sim_rit.RIMASK = 0;
+	sim_rit.RICTRL = RIT_CTRL_ENBR | RIT_CTRL_TEN;
+	sim_rit.RICOUNTER = 0;
+}
+
+/**
+ * @brief [us] hasta que RICOUNTER alcance RICOMPVAL.
+ */
+uint32_t sim_rit_proximo(void)
+{
+	uint32_t p = sim_pclk_mhz(CLKPWR_PCLKSEL_RIT);
+
+	if (!(sim_rit.RICTRL & RIT_CTRL_TEN) || (p == 0) || (sim_rit.RICOUNTER >= sim_rit.RICOMPVAL))
+		return SIM_NUNCA;
+
+	return ((sim_rit.RICOMPVAL - sim_rit.RICOUNTER) + p - 1) / p;
+}
+
+/**
+ * @brief Avanza RICOUNTER. Al llegar a RICOMPVAL levanta el flag y,
+ * 		  con ENCLR, vuelve a contar desde 0 (el excedente se conserva
+ * 		  para que el período no derive).
+ */
+void sim_rit_avanzar(uint32_t us)
+{
+	uint64_t cuenta;
+
+	if (!(sim_rit.RICTRL & RIT_CTRL_TEN))
+		return;
+
+	cuenta = sim_rit.RICOUNTER + ((uint64_t)us * sim_pclk_mhz(CLKPWR_PCLKSEL_RIT));
+
+	if ((sim_rit.RICOUNTER < sim_rit.RICOMPVAL) && (cuenta >= sim_rit.RICOMPVAL))
+	{
+		sim_rit.RICTRL |= RIT_CTRL_INTEN;
+
+		if (sim_rit.RICTRL & RIT_CTRL_ENCLR)
+			cuenta -= sim_rit.RICOMPVAL;
+	}
+
+	sim_rit.RICOUNTER = (uint32_t)cuenta;
+}
+
+uint8_t sim_rit_linea(void)
+{
+	return (sim_rit.RICTRL & RIT_CTRL_INTEN) != 0;
+}
+
+void RIT_Init(LPC_RIT_TypeDef *rit)
+{
+	rit->RICOMPVAL = 0xffffffff;
+	rit->RIMASK = 0;
+	rit->RICTRL = RIT_CTRL_ENBR | RIT_CTRL_TEN;
+	rit->RICOUNTER = 0;
+}
+
+void RIT_TimerConfig(LPC_RIT_TypeDef *rit, uint32_t ms)
+{
+	rit->RICOMPVAL = (CLKPWR_GetPCLK(CLKPWR_PCLKSEL_RIT) / 1000) * ms;
+	rit->RICTRL |= RIT_CTRL_ENCLR;
+}
+
+void RIT_Cmd(LPC_RIT_TypeDef *rit, FunctionalState estado)
+{
+	if (estado == ENABLE)
+		rit->RICTRL |= RIT_CTRL_TEN;
+	else
+		rit->RICTRL &= ~RIT_CTRL_TEN;
+}
+
+/**
+ * @brief Como en la placa, la lectura limpia el flag.
+ */
+IntStatus RIT_GetIntStatus(LPC_RIT_TypeDef *rit)
+{
+	IntStatus estado = (rit->RICTRL & RIT_CTRL_INTEN) ? SET : RESET;
+
+	rit->RICTRL &= ~RIT_CTRL_INTEN;
+
+	return estado;
+}
@@ -0,0 +1,333 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_timer.c
+ Description : Simulador: driver y modelo de los timers 0-3, y el
+               contador con prescaler y matches que comparten con PWM1
+===============================================================================
+*/
+
+#include "lpc17xx_timer.h"
+#include "lpc17xx_clkpwr.h"
+#include "hw.h"
+
+#define TCR_HABILITADO (1 << 0)
+#define TCR_RESET (1 << 1)
+#define MCR_INT(x) (1UL << (3 * (x)))
+#define MCR_RESET(x) (1UL << ((3 * (x)) + 1))
+#define MCR_STOP(x) (1UL << ((3 * (x)) + 2))
+#define MCR_CANAL(x) (7UL << (3 * (x)))
+#define CCR_SUBIDA(c) (1UL << (3 * (c)))
+#define CCR_BAJADA(c) (1UL << ((3 * (c)) + 1))
+#define CCR_INT(c) (1UL << ((3 * (c)) + 2))
+
+LPC_TIM_TypeDef sim_tim[4];
+
+static uint32_t flags[4]; // IR verdadero de cada timer (ver SIM_CENTINELA)
+static sim_contador_t contador[4];
+
+static const uint32_t pclksel[4] =
+{
+	CLKPWR_PCLKSEL_TIMER0,
+	CLKPWR_PCLKSEL_TIMER1,
+	CLKPWR_PCLKSEL_TIMER2,
+	CLKPWR_PCLKSEL_TIMER3
+};
+
+static uint8_t indice(LPC_TIM_TypeDef *timer);
+static uint32_t distancia(const sim_contador_t *c);
+
+void sim_timer_reiniciar(void)
+{
+	for (uint8_t n = 0; n < 4; n++)
+	{
+		LPC_TIM_TypeDef *t = &sim_tim[n];
+		sim_contador_t *c = &contador[n];
+
+		t->TCR = 0;
+		t->TC = 0;
+		t->PR = 0;
+		t->PC = 0;
+		t->MCR = 0;
+		t->CCR = 0;
+		t->IR = SIM_CENTINELA;
+		flags[n] = 0;
+
+		c->tcr = &t->TCR;
+		c->tc = &t->TC;
+		c->pr = &t->PR;
+		c->pc = &t->PC;
+		c->mcr = &t->MCR;
+		c->mr[0] = &t->MR0;
+		c->mr[1] = &t->MR1;
+		c->mr[2] = &t->MR2;
+		c->mr[3] = &t->MR3;
+		c->pclksel = pclksel[n];
+	}
+}
+
+uint32_t sim_timer_proximo(void)
+{
+	uint32_t us = SIM_NUNCA;
+
+	for (uint8_t n = 0; n < 4; n++)
+	{
+		uint32_t p = sim_contador_proximo(&contador[n]);
+
+		if (p < us)
+			us = p;
+	}
+
+	return us;
+}
+
+void sim_timer_avanzar(uint32_t us)
+{
+	for (uint8_t n = 0; n < 4; n++)
+	{
+		uint32_t coincidencias = sim_contador_avanzar(&contador[n], us);
+
+		sim_w1c(&sim_tim[n].IR, &flags[n]);
+
+		for (uint8_t x = 0; x < 4; x++)
+			if ((coincidencias & (1 << x)) && (sim_tim[n].MCR & MCR_INT(x)))
+				flags[n] |= 1 << x;
+
+		sim_tim[n].IR = flags[n] | SIM_CENTINELA;
+	}
+}
+
+uint8_t sim_timer_linea(uint8_t n)
+{
+	return sim_w1c(&sim_tim[n].IR, &flags[n]) != 0;
+}
+
+/**
+ * @brief Flanco en la entrada CAPn.canal: si el timer cuenta y el
+ * 		  flanco está habilitado en el CCR, se captura el TC.
+ */
+void sim_timer_flanco(uint8_t n, uint8_t canal, uint8_t subida)
+{
+	LPC_TIM_TypeDef *t = &sim_tim[n];
+
+	if (!(t->TCR & TCR_HABILITADO) || !(t->CCR & (subida ? CCR_SUBIDA(canal) : CCR_BAJADA(canal))))
+		return;
+
+	if (canal)
+		t->CR1 = t->TC;
+	else
+		t->CR0 = t->TC;
+
+	if (t->CCR & CCR_INT(canal))
+	{
+		sim_w1c(&t->IR, &flags[n]);
+
+		flags[n] |= 1 << (TIM_CR0_INT + canal);
+		t->IR = flags[n] | SIM_CENTINELA;
+	}
+}
+
+/**
+ * @brief Como el driver de NXP: deja el timer detenido y en 0, con
+ * 		  el prescaler calculado para la PCLK actual.
+ */
+void TIM_Init(LPC_TIM_TypeDef *timer, TIM_MODE_OPT modo, void *cfg)
+{
+	TIM_TIMERCFG_Type *c = (TIM_TIMERCFG_Type *)cfg;
+	uint8_t n = indice(timer);
+
+	timer->TCR = 0;
+	timer->TC = 0;
+	timer->PC = 0;
+	timer->MCR = 0;
+	timer->CCR = 0;
+	timer->CTCR = modo;
+
+	if (c->PrescaleOption == TIM_PRESCALE_USVAL)
+		timer->PR = (sim_pclk_mhz(pclksel[n]) * c->PrescaleValue) - 1;
+	else
+		timer->PR = c->PrescaleValue - 1;
+
+	flags[n] = 0;
+	timer->IR = SIM_CENTINELA;
+}
+
+void TIM_Cmd(LPC_TIM_TypeDef *timer, FunctionalState estado)
+{
+	if (estado == ENABLE)
+		timer->TCR |= TCR_HABILITADO;
+	else
+		timer->TCR &= ~TCR_HABILITADO;
+}
+
+void TIM_ConfigMatch(LPC_TIM_TypeDef *timer, TIM_MATCHCFG_Type *cfg)
+{
+	uint8_t x = cfg->MatchChannel;
+	uint32_t mcr = timer->MCR & ~MCR_CANAL(x);
+
+	TIM_UpdateMatchValue(timer, x, cfg->MatchValue);
+
+	if (cfg->IntOnMatch)
+		mcr |= MCR_INT(x);
+
+	if (cfg->ResetOnMatch)
+		mcr |= MCR_RESET(x);
+
+	if (cfg->StopOnMatch)
+		mcr |= MCR_STOP(x);
+
+	timer->MCR = mcr;
+}
+
+void TIM_UpdateMatchValue(LPC_TIM_TypeDef *timer, uint8_t canal, uint32_t valor)
+{
+	*contador[indice(timer)].mr[canal & 3] = valor;
+}
+
+void TIM_ConfigCapture(LPC_TIM_TypeDef *timer, TIM_CAPTURECFG_Type *cfg)
+{
+	uint8_t c = cfg->CaptureChannel;
+	uint32_t ccr = timer->CCR & ~(CCR_SUBIDA(c) | CCR_BAJADA(c) | CCR_INT(c));
+
+	if (cfg->RisingEdge)
+		ccr |= CCR_SUBIDA(c);
+
+	if (cfg->FallingEdge)
+		ccr |= CCR_BAJADA(c);
+
+	if (cfg->IntOnCaption)
+		ccr |= CCR_INT(c);
+
+	timer->CCR = ccr;
+}
+
+FlagStatus TIM_GetIntStatus(LPC_TIM_TypeDef *timer, TIM_INT_TYPE tipo)
+{
+	uint8_t n = indice(timer);
+
+	return (sim_w1c(&timer->IR, &flags[n]) & (1 << tipo)) ? SET : RESET;
+}
+
+void TIM_ClearIntPending(LPC_TIM_TypeDef *timer, TIM_INT_TYPE tipo)
+{
+	timer->IR = TIM_IR_CLR(tipo);
+
+	sim_w1c(&timer->IR, &flags[indice(timer)]);
+}
+
+/**
+ * @brief Sincroniza un IR que se borra escribiendo 1 con sus flags.
+ *
+ * @return Los flags verdaderos.
+ */
+uint32_t sim_w1c(volatile uint32_t *reg, uint32_t *f)
+{
+	if (!(*reg & SIM_CENTINELA))
+		*f &= ~*reg;
+
+	*reg = *f | SIM_CENTINELA;
+
+	return *f;
+}
+
+/**
+ * @brief [us] hasta el próximo match con alguna acción en el MCR.
+ */
+uint32_t sim_contador_proximo(const sim_contador_t *c)
+{
+	uint32_t pclk = sim_pclk_mhz(c->pclksel);
+	uint32_t d = distancia(c);
+
+	if (!(*c->tcr & TCR_HABILITADO) || (*c->tcr & TCR_RESET) || (d == 0) || (pclk == 0))
+		return SIM_NUNCA;
+
+	uint64_t cuentas = ((uint64_t)(d - 1) * (*c->pr + 1ULL)) + (*c->pr + 1ULL - *c->pc);
+	uint64_t us = (cuentas + pclk - 1) / pclk;
+
+	return (us > SIM_NUNCA) ? SIM_NUNCA : (uint32_t)us;
+}
+
+/**
+ * @brief Avanza el contador y aplica el reset y la detención de los
+ * 		  matches alcanzados.
+ *
+ * @details Cada match actúa en el mismo tick en que el TC lo alcanza
+ * 			(en la placa, el reset llega un tick después).
+ *
+ * @return Máscara de los matches alcanzados (bit x = MRx).
+ */
+uint32_t sim_contador_avanzar(const sim_contador_t *c, uint32_t us)
+{
+	uint32_t coincidencias = 0;
+
+	if (!(*c->tcr & TCR_HABILITADO) || (*c->tcr & TCR_RESET))
+		return 0;
+
+	uint64_t total = *c->pc + ((uint64_t)us * sim_pclk_mhz(c->pclksel));
+	uint64_t ticks = total / (*c->pr + 1ULL);
+
+	*c->pc = total % (*c->pr + 1ULL);
+
+	while (ticks)
+	{
+		uint32_t d = distancia(c);
+
+		if ((d == 0) || (d > ticks))
+		{
+			*c->tc += ticks;
+
+			break;
+		}
+
+		*c->tc += d;
+		ticks -= d;
+
+		uint32_t ahora = 0;
+
+		for (uint8_t x = 0; x < 4; x++)
+			if ((*c->mcr & MCR_CANAL(x)) && (*c->mr[x] == *c->tc))
+				ahora |= 1 << x;
+
+		coincidencias |= ahora;
+
+		for (uint8_t x = 0; x < 4; x++)
+		{
+			if (!(ahora & (1 << x)))
+				continue;
+
+			if (*c->mcr & MCR_RESET(x))
+				*c->tc = 0;
+
+			if (*c->mcr & MCR_STOP(x))
+			{
+				*c->tcr &= ~TCR_HABILITADO;
+				ticks = 0;
+			}
+		}
+	}
+
+	return coincidencias;
+}
+
+/**
+ * @brief Ticks hasta el match más cercano con acción en el MCR, o 0
+ * 		  si no hay ninguno.
+ */
+static uint32_t distancia(const sim_contador_t *c)
+{
+	uint32_t d = 0;
+
+	for (uint8_t x = 0; x < 4; x++)
+	{
+		uint32_t dx = *c->mr[x] - *c->tc;
+
+		if ((*c->mcr & MCR_CANAL(x)) && dx && (!d || (dx < d)))
+			d = dx;
+	}
+
+	return d;
+}
+
+static uint8_t indice(LPC_TIM_TypeDef *timer)
+{
+	return (uint8_t)(timer - sim_tim);
+}
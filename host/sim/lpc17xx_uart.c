@@ -0,0 +1,364 @@
+/*
+===============================================================================
+ Nombre      : lpc17xx_uart.c
+ Description : Simulador: driver y modelo de UART2, con la línea de
+               recepción alimentada por la prueba y la de transmisión
+               guardada para que la lea
+===============================================================================
+*/
+
+#include "lpc17xx_uart.h"
+#include "lpc17xx_gpdma.h"
+#include "hw.h"
+
+#define FIFO_SIZE 16
+#define BITS_POR_BYTE 10 // Start, 8 datos y stop
+#define BYTE_US_BAUD (BITS_POR_BYTE * 1000000ULL) // Duración de un byte en [us * baud]
+#define CTI_BYTES 4 // Timeout de caracter: 3.5 a 4.5 bytes sin actividad
+#define LINEA_SIZE 65536 // Bytes de cada lado de la línea (potencia de 2)
+#define LINEA_MASK (LINEA_SIZE - 1)
+
+LPC_UART_TypeDef sim_uart2;
+
+/**
+ * @brief Cola de bytes.
+ */
+typedef struct
+{
+	uint8_t *datos;
+	uint32_t mascara;
+	uint32_t cabeza;
+	uint32_t cola;
+} cola_t;
+
+static uint8_t rx_fifo_datos[FIFO_SIZE];
+static uint8_t tx_fifo_datos[FIFO_SIZE];
+static uint8_t rx_linea_datos[LINEA_SIZE]; // Bytes por llegar
+static uint8_t tx_linea_datos[LINEA_SIZE]; // Bytes transmitidos, sin leer por la prueba
+
+static cola_t rx_fifo = { rx_fifo_datos, FIFO_SIZE - 1, 0, 0 };
+static cola_t tx_fifo = { tx_fifo_datos, FIFO_SIZE - 1, 0, 0 };
+static cola_t rx_linea = { rx_linea_datos, LINEA_MASK, 0, 0 };
+static cola_t tx_linea = { tx_linea_datos, LINEA_MASK, 0, 0 };
+
+static uint32_t baud = 0;
+static uint8_t disparo = 1; // Nivel de disparo de RDA [bytes]
+static uint64_t rx_acumulado = 0; // [us * baud] del byte que está llegando
+static uint64_t tx_acumulado = 0; // [us * baud] del byte que está saliendo
+static uint8_t desplazando = 0; // Hay un byte en el registro de desplazamiento
+static uint8_t tx_byte = 0;
+static uint64_t quieto = 0; // [us * baud] sin que llegue ni se lea un byte
+static uint8_t desborde = 0; // OE pendiente de lectura del LSR
+
+static uint32_t ocupado(const cola_t *c);
+static void poner(cola_t *c, uint8_t byte);
+static uint8_t sacar(cola_t *c);
+static void bombear(void);
+static uint8_t timeout(void);
+
+void sim_uart_reiniciar(void)
+{
+	sim_uart2.IER = 0;
+	sim_uart2.IIR = UART_IIR_INTSTAT_PEND;
+	sim_uart2.FCR = 0;
+	sim_uart2.LCR = 0;
+	sim_uart2.LSR = UART_LINESTAT_THRE | UART_LINESTAT_TEMT;
+	sim_uart2.TER = UART_TER_TXEN;
+
+	rx_fifo.cabeza = rx_fifo.cola = 0;
+	tx_fifo.cabeza = tx_fifo.cola = 0;
+	rx_linea.cabeza = rx_linea.cola = 0;
+	tx_linea.cabeza = tx_linea.cola = 0;
+	baud = 0;
+	disparo = 1;
+	rx_acumulado = 0;
+	tx_acumulado = 0;
+	desplazando = 0;
+	quieto = 0;
+	desborde = 0;
+}
+
+/**
+ * @brief [us] hasta que termine de llegar o de salir un byte, o hasta
+ * 		  el timeout de caracter.
+ */
+uint32_t sim_uart_proximo(void)
+{
+	uint64_t minimo = UINT64_MAX;
+
+	if (!baud)
+		return SIM_NUNCA;
+
+	bombear();
+
+	if (ocupado(&rx_linea))
+		minimo = BYTE_US_BAUD - rx_acumulado;
+
+	if (desplazando && ((BYTE_US_BAUD - tx_acumulado) < minimo))
+		minimo = BYTE_US_BAUD - tx_acumulado;
+
+	if (ocupado(&rx_fifo) && !timeout() && (((CTI_BYTES * BYTE_US_BAUD) - quieto) < minimo))
+		minimo = (CTI_BYTES * BYTE_US_BAUD) - quieto;
+
+	if (minimo == UINT64_MAX)
+		return SIM_NUNCA;
+
+	return (uint32_t)((minimo + baud - 1) / baud);
+}
+
+void sim_uart_avanzar(uint32_t us)
+{
+	uint64_t avance = (uint64_t)us * baud;
+
+	bombear();
+
+	if (!baud)
+		return;
+
+	if (ocupado(&rx_fifo))
+		quieto += avance;
+
+	if (ocupado(&rx_linea))
+	{
+		rx_acumulado += avance;
+
+		if (rx_acumulado >= BYTE_US_BAUD)
+		{
+			uint8_t byte = sacar(&rx_linea);
+
+			if (ocupado(&rx_fifo) < FIFO_SIZE)
+				poner(&rx_fifo, byte);
+			else
+				desborde = 1;
+
+			rx_acumulado = 0;
+			quieto = 0;
+		}
+	}
+
+	if (desplazando)
+	{
+		tx_acumulado += avance;
+
+		if (tx_acumulado >= BYTE_US_BAUD)
+		{
+			poner(&tx_linea, tx_byte);
+
+			desplazando = 0;
+		}
+	}
+
+	bombear();
+}
+
+uint8_t sim_uart_linea(void)
+{
+	return (UART_GetIntId(&sim_uart2) & UART_IIR_INTSTAT_PEND) == 0;
+}
+
+uint8_t sim_uart_tx_lugar(void)
+{
+	return FIFO_SIZE - ocupado(&tx_fifo);
+}
+
+void sim_uart_tx_escribir(uint8_t byte)
+{
+	if (ocupado(&tx_fifo) < FIFO_SIZE)
+		poner(&tx_fifo, byte);
+}
+
+void sim_uart_rx_encolar(const uint8_t *datos, uint32_t len)
+{
+	for (uint32_t i = 0; (i < len) && (ocupado(&rx_linea) < LINEA_SIZE); i++)
+		poner(&rx_linea, datos[i]);
+}
+
+uint32_t sim_uart_tx_leer(uint8_t *datos, uint32_t max)
+{
+	uint32_t n = 0;
+
+	while ((n < max) && ocupado(&tx_linea))
+		datos[n++] = sacar(&tx_linea);
+
+	return n;
+}
+
+/**
+ * @brief El GPDMA llena el FIFO de transmisión mientras haya lugar, y
+ * 		  el registro de desplazamiento toma el siguiente byte si la
+ * 		  transmisión está habilitada.
+ */
+static void bombear(void)
+{
+	while (sim_uart_tx_lugar() && sim_gpdma_pedido(GPDMA_CONN_UART2_Tx));
+
+	if (!desplazando && ocupado(&tx_fifo) && (sim_uart2.TER & UART_TER_TXEN) && baud)
+	{
+		tx_byte = sacar(&tx_fifo);
+		tx_acumulado = 0;
+		desplazando = 1;
+
+		while (sim_uart_tx_lugar() && sim_gpdma_pedido(GPDMA_CONN_UART2_Tx));
+	}
+}
+
+static uint8_t timeout(void)
+{
+	return ocupado(&rx_fifo) && (quieto >= (CTI_BYTES * BYTE_US_BAUD));
+}
+
+static uint32_t ocupado(const cola_t *c)
+{
+	return c->cabeza - c->cola;
+}
+
+static void poner(cola_t *c, uint8_t byte)
+{
+	c->datos[c->cabeza++ & c->mascara] = byte;
+}
+
+static uint8_t sacar(cola_t *c)
+{
+	return c->datos[c->cola++ & c->mascara];
+}
+
+/**
+ * @brief Como el driver de NXP: vacía los FIFOs y deja la transmisión
+ * 		  y las interrupciones deshabilitadas.
+ */
+void UART_Init(LPC_UART_TypeDef *uart, UART_CFG_Type *cfg)
+{
+	rx_fifo.cabeza = rx_fifo.cola = 0;
+	tx_fifo.cabeza = tx_fifo.cola = 0;
+	baud = cfg->Baud_rate;
+	quieto = 0;
+	desborde = 0;
+
+	uart->IER = 0;
+	uart->TER = 0;
+	uart->LCR = cfg->Databits | (cfg->Stopbits << 2) | (cfg->Parity << 3);
+}
+
+void UART_ConfigStructInit(UART_CFG_Type *cfg)
+{
+	cfg->Baud_rate = 115200;
+	cfg->Parity = UART_PARITY_NONE;
+	cfg->Databits = UART_DATABIT_8;
+	cfg->Stopbits = UART_STOPBIT_1;
+}
+
+void UART_FIFOConfigStructInit(UART_FIFO_CFG_Type *cfg)
+{
+	cfg->FIFO_ResetRxBuf = ENABLE;
+	cfg->FIFO_ResetTxBuf = ENABLE;
+	cfg->FIFO_DMAMode = DISABLE;
+	cfg->FIFO_Level = UART_FIFO_TRGLEV0;
+}
+
+void UART_FIFOConfig(LPC_UART_TypeDef *uart, UART_FIFO_CFG_Type *cfg)
+{
+	static const uint8_t niveles[4] = { 1, 4, 8, 14 };
+
+	if (cfg->FIFO_ResetRxBuf == ENABLE)
+		rx_fifo.cabeza = rx_fifo.cola = 0;
+
+	if (cfg->FIFO_ResetTxBuf == ENABLE)
+		tx_fifo.cabeza = tx_fifo.cola = 0;
+
+	disparo = niveles[cfg->FIFO_Level & 3];
+	uart->FCR = 1 | ((cfg->FIFO_DMAMode == ENABLE) ? UART_FCR_DMAMODE_SEL : 0) | ((cfg->FIFO_Level & 3) << 6);
+}
+
+void UART_IntConfig(LPC_UART_TypeDef *uart, UART_INT_Type tipo, FunctionalState estado)
+{
+	uint32_t bit = (tipo == UART_INTCFG_RBR) ? UART_IER_RBRINT_EN :
+				   (tipo == UART_INTCFG_THRE) ? UART_IER_THREINT_EN : UART_IER_RLSINT_EN;
+
+	if (estado == ENABLE)
+		uart->IER |= bit;
+	else
+		uart->IER &= ~bit;
+}
+
+void UART_TxCmd(LPC_UART_TypeDef *uart, FunctionalState estado)
+{
+	uart->TER = (estado == ENABLE) ? UART_TER_TXEN : 0;
+
+	bombear();
+}
+
+/**
+ * @brief Devuelve SET mientras quede algo por transmitir. Se consulta
+ * 		  en esperas activas, así que deja correr el tiempo.
+ */
+FlagStatus UART_CheckBusy(LPC_UART_TypeDef *uart)
+{
+	(void)uart;
+
+	bombear();
+
+	if (!desplazando && !ocupado(&tx_fifo))
+		return RESET;
+
+	sim_girar(1);
+
+	return SET;
+}
+
+/**
+ * @brief Identificación de la interrupción de mayor prioridad: error
+ * 		  de línea, datos recibidos (nivel de disparo) o timeout de
+ * 		  caracter.
+ */
+uint32_t UART_GetIntId(LPC_UART_TypeDef *uart)
+{
+	uint32_t iir = UART_IIR_INTSTAT_PEND;
+
+	if ((uart->IER & UART_IER_RLSINT_EN) && desborde)
+		iir = UART_IIR_INTID_RLS;
+	else if ((uart->IER & UART_IER_RBRINT_EN) && (ocupado(&rx_fifo) >= disparo))
+		iir = UART_IIR_INTID_RDA;
+	else if ((uart->IER & UART_IER_RBRINT_EN) && timeout())
+		iir = UART_IIR_INTID_CTI;
+
+	uart->IIR = iir;
+
+	return iir;
+}
+
+/**
+ * @brief Como en la placa, la lectura limpia el flag de desborde.
+ */
+uint8_t UART_GetLineStatus(LPC_UART_TypeDef *uart)
+{
+	uint8_t lsr = 0;
+
+	if (ocupado(&rx_fifo))
+		lsr |= UART_LINESTAT_RDR;
+
+	if (desborde)
+		lsr |= UART_LINESTAT_OE;
+
+	if (!ocupado(&tx_fifo))
+		lsr |= UART_LINESTAT_THRE;
+
+	if (!ocupado(&tx_fifo) && !desplazando)
+		lsr |= UART_LINESTAT_TEMT;
+
+	desborde = 0;
+	uart->LSR = lsr;
+
+	return lsr;
+}
+
+uint8_t UART_ReceiveByte(LPC_UART_TypeDef *uart)
+{
+	(void)uart;
+
+	if (!ocupado(&rx_fifo))
+		return 0;
+
+	quieto = 0;
+
+	return sacar(&rx_fifo);
+}
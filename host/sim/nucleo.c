@@ -0,0 +1,249 @@
+/*
+===============================================================================
+ Nombre      : nucleo.c
+ Description : Simulador: NVIC, máscaras de interrupción, intrínsecas,
+               SystemCoreClock y contador de ciclos
+===============================================================================
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "hw.h"
+
+#define NIVEL_HILO 0x100 // Prioridad del código fuera de los handlers
+#define DESPACHOS_MAX 100000 // Handlers seguidos sin avanzar el tiempo: una línea que nadie limpia
+
+#define XTAL_HZ 12000000
+#define PLL0STAT_PLLE (1 << 24)
+#define PLL0STAT_PLLC (1 << 25)
+#define PLL0STAT_PLOCK (1 << 26)
+
+// Handlers del firmware (ver TP_Integrador.c)
+void TIMER1_IRQHandler(void);
+void TIMER3_IRQHandler(void);
+void UART2_IRQHandler(void);
+void PWM1_IRQHandler(void);
+void DMA_IRQHandler(void);
+void RIT_IRQHandler(void);
+void QEI_IRQHandler(void);
+
+static uint8_t linea_timer1(void) { return sim_timer_linea(1); }
+static uint8_t linea_timer3(void) { return sim_timer_linea(3); }
+
+/**
+ * @brief Tabla de vectores: sólo las interrupciones que usa el equipo,
+ * 		  en orden de número (a igual prioridad gana la de menor número).
+ */
+static const struct
+{
+	IRQn_Type irq;
+	void (*handler)(void);
+	uint8_t (*linea)(void);
+} vectores[] =
+{
+	{ TIMER1_IRQn, TIMER1_IRQHandler, linea_timer1 },
+	{ TIMER3_IRQn, TIMER3_IRQHandler, linea_timer3 },
+	{ UART2_IRQn, UART2_IRQHandler, sim_uart_linea },
+	{ PWM1_IRQn, PWM1_IRQHandler, sim_pwm_linea },
+	{ DMA_IRQn, DMA_IRQHandler, sim_gpdma_linea },
+	{ RIT_IRQn, RIT_IRQHandler, sim_rit_linea },
+	{ QEI_IRQn, QEI_IRQHandler, sim_qei_linea }
+};
+
+#define VECTORES (sizeof(vectores) / sizeof(vectores[0]))
+
+uint32_t SystemCoreClock;
+volatile uint32_t sim_demcr;
+volatile uint32_t sim_dwt_ctrl;
+volatile uint32_t sim_dwt_cyccnt;
+
+static uint8_t habilitada[IRQn_CANTIDAD];
+static uint8_t prioridad[IRQn_CANTIDAD];
+static uint32_t primask = 0;
+static uint32_t basepri = 0;
+static uint32_t nivel = NIVEL_HILO;
+
+static int32_t buscar(void);
+
+/**
+ * @brief Estado después de SystemInit: PLL0 enganchado a 100[MHz].
+ *
+ * @details El PLL0 simulado engancha en el acto, así que PLL0STAT
+ * 			queda siempre con PLLE, PLLC y PLOCK en 1.
+ */
+void sim_nucleo_reiniciar(void)
+{
+	for (uint8_t i = 0; i < IRQn_CANTIDAD; i++)
+	{
+		habilitada[i] = 0;
+		prioridad[i] = 0;
+	}
+
+	primask = 0;
+	basepri = 0;
+	nivel = NIVEL_HILO;
+
+	LPC_SC->PLL0CFG = 99 | (5 << 16); // FCCO = 2 * 100 * 12[MHz] / 6 = 400[MHz]
+	LPC_SC->PLL0STAT = PLL0STAT_PLLE | PLL0STAT_PLLC | PLL0STAT_PLOCK;
+	LPC_SC->CCLKCFG = 3;
+	LPC_SC->FLASHCFG = 0x403a;
+	LPC_SC->PCLKSEL0 = 0;
+	LPC_SC->PCLKSEL1 = 0;
+
+	SystemCoreClockUpdate();
+
+	sim_demcr = 0;
+	sim_dwt_ctrl = 0;
+	sim_dwt_cyccnt = 0;
+}
+
+/**
+ * @brief Devuelve 1 si alguna interrupción habilitada tiene la línea
+ * 		  activa y la dejan pasar la prioridad en curso y BASEPRI. Como
+ * 		  el WFI, no mira PRIMASK.
+ */
+uint8_t sim_nucleo_despierta(void)
+{
+	return buscar() >= 0;
+}
+
+/**
+ * @brief Atiende las interrupciones que corresponden, de a una y por
+ * 		  prioridad, mientras PRIMASK lo permita.
+ *
+ * @details Un handler sólo puede ser interrumpido por otro de mayor
+ * 			prioridad (menor número), como con el NVIC.
+ */
+void sim_nucleo_despachar(void)
+{
+	uint32_t despachos = 0;
+	int32_t i;
+
+	while (!primask && ((i = buscar()) >= 0))
+	{
+		uint32_t previo = nivel;
+
+		nivel = prioridad[vectores[i].irq];
+		vectores[i].handler();
+		nivel = previo;
+
+		if (++despachos > DESPACHOS_MAX)
+		{
+			fprintf(stderr, "sim: la interrupción %d no se limpia\n", vectores[i].irq);
+			abort();
+		}
+	}
+}
+
+/**
+ * @brief Devuelve el índice del vector a atender, o -1.
+ */
+static int32_t buscar(void)
+{
+	int32_t elegido = -1;
+	uint32_t umbral = nivel;
+
+	if (basepri && ((basepri >> (8 - __NVIC_PRIO_BITS)) < umbral))
+		umbral = basepri >> (8 - __NVIC_PRIO_BITS);
+
+	for (uint32_t i = 0; i < VECTORES; i++)
+	{
+		IRQn_Type irq = vectores[i].irq;
+
+		if (habilitada[irq] && (prioridad[irq] < umbral) && vectores[i].linea())
+		{
+			elegido = i;
+			umbral = prioridad[irq];
+		}
+	}
+
+	return elegido;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+	habilitada[irq] = 1;
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq)
+{
+	habilitada[irq] = 0;
+}
+
+void NVIC_SetPriority(IRQn_Type irq, uint32_t p)
+{
+	prioridad[irq] = p & ((1 << __NVIC_PRIO_BITS) - 1);
+}
+
+uint32_t NVIC_GetPriority(IRQn_Type irq)
+{
+	return prioridad[irq];
+}
+
+void __enable_irq(void)
+{
+	primask = 0;
+
+	sim_nucleo_despachar();
+}
+
+void __disable_irq(void)
+{
+	primask = 1;
+}
+
+uint32_t __get_PRIMASK(void)
+{
+	return primask;
+}
+
+void __set_PRIMASK(uint32_t valor)
+{
+	primask = valor & 1;
+
+	sim_nucleo_despachar();
+}
+
+uint32_t __get_BASEPRI(void)
+{
+	return basepri;
+}
+
+void __set_BASEPRI(uint32_t valor)
+{
+	basepri = valor & 0xff;
+
+	sim_nucleo_despachar();
+}
+
+/**
+ * @brief Sin otro núcleo ni DMA que escriba en medio, LDREX/STREX
+ * 		  nunca fallan.
+ */
+uint32_t __LDREXW(volatile uint32_t *p)
+{
+	return *p;
+}
+
+uint32_t __STREXW(uint32_t valor, volatile uint32_t *p)
+{
+	*p = valor;
+
+	return 0;
+}
+
+/**
+ * @brief CCLK a partir de los registros del PLL0, como el
+ * 		  SystemCoreClockUpdate de CMSIS.
+ */
+void SystemCoreClockUpdate(void)
+{
+	uint32_t m = (LPC_SC->PLL0CFG & 0x7fff) + 1;
+	uint32_t n = ((LPC_SC->PLL0CFG >> 16) & 0xff) + 1;
+	uint64_t fcco = XTAL_HZ;
+
+	if ((LPC_SC->PLL0STAT & (PLL0STAT_PLLE | PLL0STAT_PLLC)) == (PLL0STAT_PLLE | PLL0STAT_PLLC))
+		fcco = (2ULL * m * XTAL_HZ) / n;
+
+	SystemCoreClock = (uint32_t)(fcco / ((LPC_SC->CCLKCFG & 0xff) + 1));
+}
@@ -0,0 +1,271 @@
+/*
+===============================================================================
+ Nombre      : sim.c
+ Description : Simulador: tiempo virtual, contexto del firmware, planta
+               de la cinta y funciones para las pruebas
+===============================================================================
+*/
+
+#include <math.h>
+#include <string.h>
+#include <ucontext.h>
+#include "lpc_types.h"
+#include "hw.h"
+#include "control.h"
+#include "sim.h"
+
+#define PILA_SIZE (256 * 1024) // Pila del firmware; en .bss, con direcciones de 32 bits
+#define PASO_MAX_US 1000 // Paso máximo de la planta
+#define CINTA_TAU_US 300000.0 // Constante de tiempo de la cinta
+#define SIM_CARGA_MAX 1000
+
+int firmware_main(void); // main de TP_Integrador.c (ver Makefile)
+
+static ucontext_t contexto_prueba;
+static ucontext_t contexto_firmware;
+static uint8_t pila[PILA_SIZE] __attribute__ ((aligned(16)));
+
+static uint64_t ahora = 0; // [us]
+static uint64_t limite = 0; // Hasta dónde corre el firmware en esta llamada a sim_correr_us
+static uint64_t ciclos_resto = 0; // [ciclos * 1e6] sin sumar al CYCCNT
+static double velocidad = 0; // [m/h]
+static double flancos_resto = 0; // Fracción de flanco del encoder
+static uint32_t carga = 0; // [milésimas]
+
+static void arrancar(void);
+static void ceder(void);
+static uint32_t proximo(void);
+static void pasar(uint32_t us);
+
+/**
+ * @brief Reinicia los periféricos, borra la flash y prepara el
+ * 		  contexto del firmware, que arranca en la primera llamada a
+ * 		  sim_correr_us.
+ */
+void sim_iniciar(void)
+{
+	sim_nucleo_reiniciar();
+	sim_timer_reiniciar();
+	sim_pwm_reiniciar();
+	sim_rit_reiniciar();
+	sim_qei_reiniciar();
+	sim_adc_reiniciar();
+	sim_gpdma_reiniciar();
+	sim_uart_reiniciar();
+	sim_gpio_reiniciar();
+
+	memset(sim_flash, 0xff, sizeof(sim_flash));
+
+	ahora = 0;
+	limite = 0;
+	ciclos_resto = 0;
+	velocidad = 0;
+	flancos_resto = 0;
+	carga = 0;
+
+	getcontext(&contexto_firmware);
+	contexto_firmware.uc_stack.ss_sp = pila;
+	contexto_firmware.uc_stack.ss_size = sizeof(pila);
+	contexto_firmware.uc_link = &contexto_prueba;
+	makecontext(&contexto_firmware, arrancar, 0);
+}
+
+/**
+ * @brief Deja correr el firmware us microsegundos de tiempo virtual.
+ */
+void sim_correr_us(uint64_t us)
+{
+	limite = ahora + us;
+
+	swapcontext(&contexto_prueba, &contexto_firmware);
+}
+
+uint64_t sim_ahora_us(void)
+{
+	return ahora;
+}
+
+/**
+ * @brief Tecla 0-15 del teclado matricial (4 * fila + columna).
+ */
+void sim_tecla(uint8_t tecla, uint8_t presionada)
+{
+	sim_gpio_tecla(tecla, presionada);
+}
+
+/**
+ * @brief Latido del sensor: flanco descendente en CAP3.1.
+ */
+void sim_latido(void)
+{
+	sim_timer_flanco(3, 1, 0);
+}
+
+void sim_analogica(uint8_t canal, uint16_t cuentas)
+{
+	sim_adc_entrada(canal, cuentas);
+}
+
+/**
+ * @brief Encola bytes en la línea de recepción de UART2; llegan a la
+ * 		  velocidad de la línea.
+ */
+void sim_uart_escribir(const uint8_t *datos, uint32_t len)
+{
+	sim_uart_rx_encolar(datos, len);
+}
+
+/**
+ * @brief Carga sobre la cinta: fracción (en milésimas) de la velocidad
+ * 		  que se pierde.
+ */
+void sim_carga(uint32_t milesimas)
+{
+	carga = (milesimas > SIM_CARGA_MAX) ? SIM_CARGA_MAX : milesimas;
+}
+
+/**
+ * @brief Copia los bytes transmitidos por UART2 desde la última
+ * 		  llamada.
+ */
+uint32_t sim_uart_leer(uint8_t *datos, uint32_t max)
+{
+	return sim_uart_tx_leer(datos, max);
+}
+
+uint32_t sim_duty_q16(void)
+{
+	return sim_pwm_duty_q16();
+}
+
+uint32_t sim_cinta_mh(void)
+{
+	return (uint32_t)(velocidad + 0.5);
+}
+
+uint8_t sim_display(void)
+{
+	return sim_gpio_display();
+}
+
+/**
+ * @brief WFI: avanza el tiempo virtual hasta que alguna interrupción
+ * 		  lo despierte. Con PRIMASK en 1 no la atiende; la atiende el
+ * 		  __enable_irq siguiente, como en la placa.
+ */
+void __WFI(void)
+{
+	while (!sim_nucleo_despierta())
+	{
+		if (ahora >= limite)
+		{
+			ceder();
+
+			continue;
+		}
+
+		uint64_t us = proximo();
+
+		if (us > (limite - ahora))
+			us = limite - ahora;
+
+		pasar((uint32_t)us);
+	}
+}
+
+/**
+ * @brief Espera activa de us microsegundos (IAP, sondeo de un flag):
+ * 		  el tiempo corre y se atienden las interrupciones que PRIMASK
+ * 		  y BASEPRI dejan pasar.
+ */
+void sim_girar(uint32_t us)
+{
+	while (us)
+	{
+		if (ahora >= limite)
+		{
+			ceder();
+
+			continue;
+		}
+
+		uint64_t paso = proximo();
+
+		if (paso > us)
+			paso = us;
+
+		if (paso > (limite - ahora))
+			paso = limite - ahora;
+
+		pasar((uint32_t)paso);
+		us -= (uint32_t)paso;
+
+		sim_nucleo_despachar();
+	}
+}
+
+static void arrancar(void)
+{
+	firmware_main();
+}
+
+/**
+ * @brief Vuelve a la prueba hasta la próxima llamada a sim_correr_us.
+ */
+static void ceder(void)
+{
+	swapcontext(&contexto_firmware, &contexto_prueba);
+}
+
+/**
+ * @brief [us] hasta el próximo evento de algún periférico, como
+ * 		  mucho PASO_MAX_US para que la planta siga al duty.
+ */
+static uint32_t proximo(void)
+{
+	uint32_t us = PASO_MAX_US;
+	uint32_t p[] =
+	{
+		sim_timer_proximo(),
+		sim_pwm_proximo(),
+		sim_rit_proximo(),
+		sim_qei_proximo(),
+		sim_adc_proximo(),
+		sim_uart_proximo()
+	};
+
+	for (uint8_t i = 0; i < (sizeof(p) / sizeof(p[0])); i++)
+		if (p[i] < us)
+			us = p[i];
+
+	return us ? us : 1;
+}
+
+/**
+ * @brief Avanza us microsegundos: los periféricos, el CYCCNT y la
+ * 		  planta de primer orden de la cinta, cuyo encoder alimenta
+ * 		  el QEI.
+ */
+static void pasar(uint32_t us)
+{
+	double objetivo = ((double)sim_pwm_duty_q16() / 65536.0) * CONTROL_VEL_PLENA_MH * (SIM_CARGA_MAX - carga) / SIM_CARGA_MAX;
+	double flancos;
+
+	velocidad += (objetivo - velocidad) * (1.0 - exp(-(double)us / CINTA_TAU_US));
+	flancos_resto += (velocidad * us / 3.6e9) * CONTROL_PULSOS_POR_METRO; // [m/h] * [us] -> [m]
+	flancos = floor(flancos_resto);
+	flancos_resto -= flancos;
+
+	sim_timer_avanzar(us);
+	sim_pwm_avanzar(us);
+	sim_rit_avanzar(us);
+	sim_qei_avanzar(us, (uint32_t)flancos);
+	sim_adc_avanzar(us);
+	sim_uart_avanzar(us);
+
+	ahora += us;
+
+	ciclos_resto += (uint64_t)us * SystemCoreClock;
+	sim_dwt_cyccnt += (uint32_t)(ciclos_resto / 1000000);
+	ciclos_resto %= 1000000;
+}
@@ -0,0 +1,59 @@
+/*
+===============================================================================
+ Nombre      : sim.h
+ Description : Simulador del equipo en la PC: el firmware completo
+               (TP_Integrador.c sin cambios) contra drivers simulados,
+               con tiempo virtual determinístico
+
+ El firmware corre en su propio contexto. sim_correr_us lo deja avanzar
+ hasta el instante pedido: mientras no haya eventos pendientes, el WFI
+ del planificador adelanta el tiempo virtual hasta el próximo evento de
+ algún periférico (match de un timer, período del PWM, barrido del RIT,
+ conversión del ADC, byte de la UART) y atiende las interrupciones por
+ prioridad, como el NVIC. Entre dos llamadas, la prueba inyecta
+ entradas (teclas, latidos, tensiones en las entradas del ADC, bytes por UART2, carga
+ sobre la cinta) y lee las salidas (bytes transmitidos por UART2, duty
+ del PWM, display).
+
+ La cinta es una planta de primer orden: con duty d, la velocidad tiende
+ a d * CONTROL_VEL_PLENA_MH (ver control.h) menos la carga, y el encoder
+ entrega CONTROL_PULSOS_POR_METRO flancos por metro.
+
+ Los estados internos de los módulos del firmware no se pueden volver
+ a cero, así que sim_iniciar se llama una sola vez por proceso.
+===============================================================================
+*/
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_FLASH_BYTES 0x10000 // Región de la bitácora (ver iap.h)
+
+void sim_iniciar(void);
+void sim_correr_us(uint64_t us);
+uint64_t sim_ahora_us(void);
+
+void sim_tecla(uint8_t tecla, uint8_t presionada);
+void sim_latido(void);
+void sim_analogica(uint8_t canal, uint16_t cuentas);
+void sim_uart_escribir(const uint8_t *datos, uint32_t len);
+void sim_carga(uint32_t milesimas);
+
+uint32_t sim_uart_leer(uint8_t *datos, uint32_t max);
+uint32_t sim_duty_q16(void);
+uint32_t sim_cinta_mh(void);
+uint8_t sim_display(void);
+
+extern uint8_t sim_flash[SIM_FLASH_BYTES];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_H_ */
@@ -0,0 +1,78 @@
+/*
+===============================================================================
+ Nombre      : prueba.h
+ Description : Verificaciones mínimas para las pruebas en la PC
+
+ Cada prueba es un ejecutable que termina con PRUEBA_FIN(): devuelve
+ distinto de 0 si falló alguna verificación, que se informa con el
+ archivo y la línea.
+===============================================================================
+*/
+
+#ifndef PRUEBA_H_
+#define PRUEBA_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static unsigned prueba_verificaciones = 0;
+static unsigned prueba_fallas = 0;
+
+#define VERIFICAR(cond) \
+	do \
+	{ \
+		prueba_verificaciones++; \
+		if (!(cond)) \
+		{ \
+			prueba_fallas++; \
+			fprintf(stderr, "%s:%d: falla: %s\n", __FILE__, __LINE__, #cond); \
+		} \
+	} while (0)
+
+#define VERIFICAR_IGUAL(a, b) \
+	do \
+	{ \
+		long long va_ = (long long)(a), vb_ = (long long)(b); \
+		prueba_verificaciones++; \
+		if (va_ != vb_) \
+		{ \
+			prueba_fallas++; \
+			fprintf(stderr, "%s:%d: falla: %s == %s (%lld != %lld)\n", __FILE__, __LINE__, #a, #b, va_, vb_); \
+		} \
+	} while (0)
+
+#define VERIFICAR_CERCA(a, b, tol) \
+	do \
+	{ \
+		double va_ = (double)(a), vb_ = (double)(b); \
+		prueba_verificaciones++; \
+		if ((va_ - vb_ > (tol)) || (vb_ - va_ > (tol))) \
+		{ \
+			prueba_fallas++; \
+			fprintf(stderr, "%s:%d: falla: %s ~ %s (%g, %g, tol %g)\n", __FILE__, __LINE__, #a, #b, va_, vb_, (double)(tol)); \
+		} \
+	} while (0)
+
+#define PRUEBA_FIN() \
+	do \
+	{ \
+		printf("%s: %u verificaciones, %u fallas\n", __FILE__, prueba_verificaciones, prueba_fallas); \
+		return prueba_fallas ? EXIT_FAILURE : EXIT_SUCCESS; \
+	} while (0)
+
+/**
+ * @brief Generador pseudoaleatorio fijo (xorshift32), para que las
+ * 		  pruebas sean reproducibles.
+ */
+static unsigned prueba_semilla = 2463534242u;
+
+static inline unsigned prueba_azar(void)
+{
+	prueba_semilla ^= prueba_semilla << 13;
+	prueba_semilla ^= prueba_semilla >> 17;
+	prueba_semilla ^= prueba_semilla << 5;
+
+	return prueba_semilla;
+}
+
+#endif /* PRUEBA_H_ */
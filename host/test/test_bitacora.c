@@ -0,0 +1,372 @@
+/*
+===============================================================================
+ Nombre      : test_bitacora.c
+ Description : Bitácora en flash contra una flash simulada en RAM, con
+               cortes de energía y fallas de programación
+===============================================================================
+*/
+
+#include <string.h>
+#include "prueba.h"
+#include "bitacora.h"
+
+#define SECTOR_MAX 0x8000
+#define SECTORES_MAX 4
+
+static uint32_t memoria[(SECTORES_MAX * SECTOR_MAX) / 4]; // Alineada como la flash
+static uint8_t *region = (uint8_t *)memoria;
+static uint32_t sector_size;
+static uint8_t sectores;
+
+static uint32_t borrados[SECTORES_MAX];
+static uint32_t programadas;
+static int32_t cortar_en = -1; // Bytes que llegan a programarse antes del corte
+static uint8_t fallar = 0; // La próxima programación falla
+
+/**
+ * @brief Borrado: todo el sector en 0xff.
+ */
+static uint8_t borrar(uint8_t sector)
+{
+	VERIFICAR(sector < sectores);
+
+	memset(region + (sector * sector_size), 0xff, sector_size);
+	borrados[sector]++;
+
+	return 0;
+}
+
+/**
+ * @brief Programación de una página: como en la flash, sólo puede
+ * 		  bajar bits de 1 a 0. Un corte de energía deja la página a
+ * 		  medio programar.
+ */
+static uint8_t programar(uint32_t offset, const uint8_t *pagina)
+{
+	uint32_t n = BITACORA_PAGINA;
+
+	VERIFICAR_IGUAL(offset % BITACORA_PAGINA, 0);
+	VERIFICAR(offset < sector_size * sectores);
+
+	if (cortar_en >= 0)
+		n = (uint32_t)cortar_en;
+	else if (fallar)
+		n = BITACORA_PAGINA / 2; // Verificación fallida: la página queda a medias
+
+	for (uint32_t i = 0; i < n; i++)
+		region[offset + i] &= pagina[i];
+
+	programadas++;
+
+	if (fallar)
+	{
+		fallar = 0;
+
+		return 1;
+	}
+
+	return 0;
+}
+
+static bitacora_flash_t flash = { 0, 0, 0, borrar, programar };
+
+static void formatear(uint32_t tam, uint8_t n)
+{
+	sector_size = tam;
+	sectores = n;
+	memset(memoria, 0xff, sizeof(memoria));
+	memset(borrados, 0, sizeof(borrados));
+	programadas = 0;
+	cortar_en = -1;
+	fallar = 0;
+
+	flash.base = region;
+	flash.sector_size = tam;
+	flash.sectores = n;
+}
+
+static trama_registro_t registro(uint32_t i)
+{
+	trama_registro_t r;
+
+	r.tiempo_s = (uint16_t)i;
+	r.ppm = (uint8_t)(60 + (i % 120));
+	r.velocidad = (uint8_t)(i % 200);
+	r.temperatura = (int16_t)(2000 + (i % 700));
+	r.distancia = (uint16_t)(3 * i);
+
+	return r;
+}
+
+/**
+ * @brief Lee toda la bitácora, de la página más vieja a la más nueva,
+ * 		  y verifica que los registros sean consecutivos.
+ *
+ * @return Registros leídos; en primero, el tiempo_s del más viejo.
+ */
+static uint32_t recorrer(uint32_t *primero, uint32_t *invalidas)
+{
+	trama_registro_t r[BITACORA_REGISTROS];
+	uint32_t total = 0;
+	uint32_t esperado = 0;
+
+	*invalidas = 0;
+
+	for (uint32_t p = 0; p < bitacora_paginas(); p++)
+	{
+		uint8_t n = bitacora_pagina(p, r);
+
+		if (n == 0)
+		{
+			(*invalidas)++;
+
+			continue;
+		}
+
+		for (uint8_t j = 0; j < n; j++, total++)
+		{
+			trama_registro_t e;
+
+			if (total == 0)
+				*primero = esperado = r[j].tiempo_s;
+
+			e = registro(esperado++);
+
+			VERIFICAR(memcmp(&r[j], &e, sizeof(e)) == 0);
+		}
+	}
+
+	return total;
+}
+
+static void agregar(uint32_t desde, uint32_t n)
+{
+	for (uint32_t i = desde; i < desde + n; i++)
+	{
+		trama_registro_t r = registro(i);
+
+		bitacora_agregar(&r);
+	}
+}
+
+static void vacia(void)
+{
+	uint32_t primero, invalidas;
+
+	formatear(1024, 4);
+	bitacora_init(&flash);
+
+	VERIFICAR_IGUAL(bitacora_paginas(), 0);
+	VERIFICAR_IGUAL(bitacora_libres(), 16);
+	VERIFICAR_IGUAL(recorrer(&primero, &invalidas), 0);
+}
+
+/**
+ * @brief Una sesión completa, vaciado al final y recuperación tras
+ * 		  reiniciar desde la misma flash.
+ */
+static void sesion_y_reinicio(void)
+{
+	uint32_t primero = 0, invalidas;
+
+	formatear(1024, 4);
+	bitacora_init(&flash);
+
+	agregar(0, (3 * BITACORA_REGISTROS) + 5);
+
+	VERIFICAR_IGUAL(programadas, 3);
+	VERIFICAR_IGUAL(bitacora_paginas(), 3);
+
+	bitacora_vaciar();
+
+	VERIFICAR_IGUAL(bitacora_paginas(), 4);
+	VERIFICAR_IGUAL(recorrer(&primero, &invalidas), (3 * BITACORA_REGISTROS) + 5);
+	VERIFICAR_IGUAL(primero, 0);
+
+	bitacora_init(&flash); // Reinicio
+
+	VERIFICAR_IGUAL(bitacora_paginas(), 4);
+	VERIFICAR_IGUAL(bitacora_libres(), 12);
+	VERIFICAR_IGUAL(recorrer(&primero, &invalidas), (3 * BITACORA_REGISTROS) + 5);
+
+	agregar((3 * BITACORA_REGISTROS) + 5, BITACORA_REGISTROS); // La sesión siguiente sigue después
+	VERIFICAR_IGUAL(recorrer(&primero, &invalidas), (4 * BITACORA_REGISTROS) + 5);
+	VERIFICAR_IGUAL(invalidas, 0);
+}
+
+/**
+ * @brief Muchas vueltas a la región con mantenimiento entre sesiones:
+ * 		  todos los sectores se borran la misma cantidad de veces y
+ * 		  siempre se conservan los registros más nuevos.
+ */
+static void desgaste(void)
+{
+	uint32_t i = 0;
+	uint32_t primero = 0, invalidas;
+
+	formatear(1024, 4);
+	bitacora_init(&flash);
+
+	for (uint32_t sesion = 0; sesion < 500; sesion++)
+	{
+		uint32_t n = 1 + (prueba_azar() % (3 * BITACORA_REGISTROS));
+
+		agregar(i, n);
+		i += n;
+
+		bitacora_vaciar();
+		bitacora_mantenimiento();
+
+		if ((sesion % 37) == 0)
+			bitacora_init(&flash); // Corte de energía con la cinta detenida
+	}
+
+	uint32_t min = borrados[0], max = borrados[0];
+
+	for (uint8_t s = 1; s < 4; s++)
+	{
+		if (borrados[s] < min)
+			min = borrados[s];
+
+		if (borrados[s] > max)
+			max = borrados[s];
+	}
+
+	VERIFICAR(min > 20);
+	VERIFICAR(max - min <= 1);
+	VERIFICAR_IGUAL(bitacora_descartados(), 0);
+	VERIFICAR_IGUAL(bitacora_errores(), 0);
+
+	uint32_t leidos = recorrer(&primero, &invalidas);
+
+	VERIFICAR_IGUAL(invalidas, 0);
+	VERIFICAR_IGUAL(primero + leidos, i); // Los más nuevos, sin huecos
+	VERIFICAR(bitacora_libres() >= 4); // Un sector libre tras el mantenimiento
+}
+
+/**
+ * @brief Un corte de energía a mitad de la programación de una
+ * 		  página: la página no pasa el CRC, se saltea al reiniciar y
+ * 		  se escribe en la siguiente.
+ */
+static void corte(void)
+{
+	uint32_t primero = 0, invalidas;
+	int32_t cortes[] = { 0, 4, 11, 100, 251 }; // Los últimos 4 bytes de la página quedan en 0xff
+
+	for (unsigned k = 0; k < sizeof(cortes) / sizeof(cortes[0]); k++)
+	{
+		formatear(1024, 4);
+		bitacora_init(&flash);
+
+		agregar(0, 2 * BITACORA_REGISTROS);
+
+		cortar_en = cortes[k];
+		agregar(2 * BITACORA_REGISTROS, BITACORA_REGISTROS); // Se corta la tercera página
+		cortar_en = -1;
+
+		bitacora_init(&flash);
+
+		uint32_t leidos = recorrer(&primero, &invalidas);
+
+		VERIFICAR_IGUAL(leidos, 2 * BITACORA_REGISTROS);
+		VERIFICAR_IGUAL(invalidas, cortes[k] ? 1 : 0); // Sin bytes programados la página sigue en blanco
+
+		agregar(3 * BITACORA_REGISTROS, BITACORA_REGISTROS);
+
+		VERIFICAR_IGUAL(bitacora_paginas(), cortes[k] ? 4 : 3);
+
+		bitacora_init(&flash); // La secuencia sigue después de la página dañada
+
+		trama_registro_t r[BITACORA_REGISTROS];
+
+		VERIFICAR_IGUAL(bitacora_pagina(bitacora_paginas() - 1, r), BITACORA_REGISTROS);
+		VERIFICAR_IGUAL(r[0].tiempo_s, 3 * BITACORA_REGISTROS);
+	}
+}
+
+/**
+ * @brief Una página que falla al programarse se cuenta y se saltea;
+ * 		  los registros quedan en RAM y se programan en la siguiente.
+ */
+static void falla(void)
+{
+	uint32_t primero = 0, invalidas;
+
+	formatear(1024, 4);
+	bitacora_init(&flash);
+
+	agregar(0, BITACORA_REGISTROS);
+	fallar = 1;
+	agregar(BITACORA_REGISTROS, BITACORA_REGISTROS);
+
+	VERIFICAR_IGUAL(bitacora_errores(), 1);
+	VERIFICAR_IGUAL(programadas, 2);
+
+	bitacora_vaciar();
+
+	VERIFICAR_IGUAL(programadas, 3);
+	VERIFICAR_IGUAL(recorrer(&primero, &invalidas), 2 * BITACORA_REGISTROS);
+	VERIFICAR_IGUAL(invalidas, 1);
+}
+
+/**
+ * @brief Sin mantenimiento (cinta siempre en marcha) la región se
+ * 		  llena: la última página queda en RAM y el resto se descarta.
+ */
+static void llena(void)
+{
+	uint32_t primero = 0, invalidas;
+
+	formatear(1024, 4);
+	bitacora_init(&flash);
+
+	agregar(0, 20 * BITACORA_REGISTROS);
+
+	VERIFICAR_IGUAL(bitacora_libres(), 0);
+	VERIFICAR_IGUAL(bitacora_descartados(), 3 * BITACORA_REGISTROS);
+	VERIFICAR_IGUAL(recorrer(&primero, &invalidas), 16 * BITACORA_REGISTROS);
+
+	bitacora_mantenimiento(); // Al detenerse: se pierde el sector más viejo
+
+	VERIFICAR_IGUAL(bitacora_libres(), 4);
+	VERIFICAR_IGUAL(borrados[0], 1);
+
+	bitacora_vaciar();
+
+	VERIFICAR_IGUAL(recorrer(&primero, &invalidas), 13 * BITACORA_REGISTROS);
+	VERIFICAR_IGUAL(primero, 4 * BITACORA_REGISTROS);
+}
+
+/**
+ * @brief La región real del equipo (dos sectores de 32[KB]).
+ */
+static void region_real(void)
+{
+	uint32_t primero = 0, invalidas;
+
+	formatear(SECTOR_MAX, 2);
+	bitacora_init(&flash);
+
+	VERIFICAR_IGUAL(bitacora_libres(), 256);
+
+	agregar(0, 3600); // Una hora
+	bitacora_vaciar();
+	bitacora_init(&flash);
+
+	VERIFICAR_IGUAL(recorrer(&primero, &invalidas), 3600);
+	VERIFICAR_IGUAL(bitacora_paginas(), (3600 + BITACORA_REGISTROS - 1) / BITACORA_REGISTROS);
+}
+
+int main(void)
+{
+	vacia();
+	sesion_y_reinicio();
+	desgaste();
+	corte();
+	falla();
+	llena();
+	region_real();
+
+	PRUEBA_FIN();
+}
@@ -0,0 +1,169 @@
+/*
+===============================================================================
+ Nombre      : test_estado.c
+ Description : Seqlocks del bloque de estado bajo interrupciones
+               inyectadas en cualquier instrucción (ver estado.h)
+
+ Las interrupciones son señales de dos timers POSIX con períodos de
+ pocos microsegundos y sin relación entre sí: como en la placa, el
+ handler suspende al lector (o a un handler de menor prioridad) en
+ cualquier instrucción de la copia. SIGUSR1 hace de TIMER3_IRQHandler
+ y SIGUSR2 de QEI_IRQHandler, con la misma relación de prioridades.
+===============================================================================
+*/
+
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include "prueba.h"
+#include "estado.h"
+
+#define LECTURAS 2000000 // Como mínimo
+#define INTERRUPCIONES 20000 // De cada handler, como mínimo
+#define PERIODO_PULSO_NS 37000
+#define PERIODO_CONTROL_NS 23000
+
+static volatile uint32_t n_pulso = 0;
+static volatile uint32_t n_control = 0;
+
+/**
+ * @brief Cada celda se publica con campos derivados de un contador,
+ * 		  así que una foto mezclada se detecta.
+ */
+static void irq_pulso(int sig)
+{
+	(void)sig;
+
+	estado_pulso_t p;
+	uint32_t n = ++n_pulso;
+
+	p.ppm = n;
+	p.ppm_x10 = n * 10;
+	p.t_ultimo = n * 7;
+
+	estado_pulso_publicar(&p);
+}
+
+static void irq_control(int sig)
+{
+	(void)sig;
+
+	estado_control_t c;
+	uint32_t n = ++n_control;
+
+	c.velocidad_mh = n;
+	c.error_mh = -(int32_t)n;
+	c.duty = n * 11;
+
+	estado_control_publicar(&c);
+}
+
+static void sesion(uint32_t n)
+{
+	estado_sesion_t s;
+
+	s.velocidad = n;
+	s.temperatura = -(int32_t)n;
+	s.distancia = n * 3;
+	s.tiempo_s = n + 1;
+	s.energia = n ^ 0x5a5a5a5a;
+	s.ppm_media = ~n;
+	s.ritmo = n * 5;
+
+	estado_sesion_publicar(&s);
+}
+
+static int consistente(const estado_foto_t *f)
+{
+	const estado_pulso_t *p = &f->pulso;
+	const estado_control_t *c = &f->control;
+	const estado_sesion_t *s = &f->sesion;
+	uint32_t n = s->velocidad;
+
+	return (p->ppm_x10 == p->ppm * 10) && (p->t_ultimo == p->ppm * 7)
+		&& (c->error_mh == -(int32_t)c->velocidad_mh) && (c->duty == c->velocidad_mh * 11)
+		&& (s->temperatura == -(int32_t)n) && (s->distancia == n * 3) && (s->tiempo_s == n + 1)
+		&& (s->energia == (n ^ 0x5a5a5a5a)) && (s->ppm_media == ~n) && (s->ritmo == n * 5);
+}
+
+/**
+ * @brief Arma un timer periódico que dispara la señal sig.
+ */
+static timer_t armar(int sig, long periodo_ns)
+{
+	struct sigevent ev;
+	struct itimerspec its;
+	timer_t t;
+
+	memset(&ev, 0, sizeof(ev));
+	ev.sigev_notify = SIGEV_SIGNAL;
+	ev.sigev_signo = sig;
+	timer_create(CLOCK_MONOTONIC, &ev, &t);
+
+	its.it_value.tv_sec = 0;
+	its.it_value.tv_nsec = periodo_ns;
+	its.it_interval = its.it_value;
+	timer_settime(t, 0, &its, NULL);
+
+	return t;
+}
+
+/**
+ * @brief Instala los handlers: SIGUSR1 (TIMER3, prioridad 3)
+ * 		  interrumpe a SIGUSR2 (QEI, prioridad 6), pero no al revés.
+ */
+static void instalar(void)
+{
+	struct sigaction sa;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_flags = SA_RESTART;
+
+	sa.sa_handler = irq_pulso;
+	sigemptyset(&sa.sa_mask);
+	sigaddset(&sa.sa_mask, SIGUSR2);
+	sigaction(SIGUSR1, &sa, NULL);
+
+	sa.sa_handler = irq_control;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGUSR2, &sa, NULL);
+}
+
+int main(void)
+{
+	estado_foto_t f, anterior;
+	uint32_t mezcladas = 0, retrocesos = 0;
+
+	sesion(0);
+	estado_leer(&anterior);
+	instalar();
+
+	timer_t pulso = armar(SIGUSR1, PERIODO_PULSO_NS);
+	timer_t control = armar(SIGUSR2, PERIODO_CONTROL_NS);
+
+	for (uint32_t k = 1; (k <= LECTURAS) || (n_pulso < INTERRUPCIONES) || (n_control < INTERRUPCIONES); k++)
+	{
+		if ((k % 16) == 0) // La tarea también publica su celda entre lecturas
+			sesion(k);
+
+		estado_leer(&f);
+
+		if (!consistente(&f))
+			mezcladas++;
+
+		// Una foto puede ser vieja, pero nunca anterior a la previa
+		if ((f.pulso.ppm < anterior.pulso.ppm) || (f.control.velocidad_mh < anterior.control.velocidad_mh) || (f.sesion.velocidad < anterior.sesion.velocidad))
+			retrocesos++;
+
+		anterior = f;
+	}
+
+	timer_delete(pulso);
+	timer_delete(control);
+
+	VERIFICAR_IGUAL(mezcladas, 0);
+	VERIFICAR_IGUAL(retrocesos, 0);
+	VERIFICAR(estado_reintentos() > 0); // Las interrupciones cayeron durante copias
+
+	PRUEBA_FIN();
+}
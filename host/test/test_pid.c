@@ -0,0 +1,249 @@
+/*
+===============================================================================
+ Nombre      : test_pid.c
+ Description : El PID del lazo de velocidad contra una planta de primer
+               orden de la cinta, medida como la mide control.c y con la
+               referencia de la rampa (ver pid.h, control.h y rampa.h)
+===============================================================================
+*/
+
+#include <math.h>
+#include "prueba.h"
+#include "pid.h"
+#include "punto_fijo.h"
+#include "rampa.h"
+
+// Los valores de motor.h, control.h y control.c
+#define DUTY_MAX 65535 // MOTOR_DUTY_MAX
+#define KP PF_Q16(DUTY_MAX, 50000) // CONTROL_KP
+#define KI PF_Q16(DUTY_MAX, 1000000) // CONTROL_KI
+#define PERIODO_US 10000 // CONTROL_PERIODO_US
+#define PULSOS_POR_METRO 4000 // CONTROL_PULSOS_POR_METRO
+#define VENTANA 4 // CONTROL_VENTANA
+#define VEL_PLENA_MH 20000 // CONTROL_VEL_PLENA_MH
+#define MH_POR_PULSO (3600000000ULL / ((uint64_t)PULSOS_POR_METRO * PERIODO_US))
+
+#define TAU_US 300000.0 // Constante de tiempo de la cinta (la del simulador)
+#define PASOS_POR_S (1000000 / PERIODO_US)
+#define RAMPA_POR_PASO (RAMPA_PASOS_POR_S / PASOS_POR_S)
+#define ATRASO_MAX_MH 250 // El lazo es de tipo 1: contra una rampa queda un error constante
+
+/**
+ * @brief La cinta: primer orden hacia duty * VEL_PLENA_MH, menos la
+ * 		  fracción que se pierde con la carga. El encoder se lee como
+ * 		  en control_qei_irq: flancos enteros por período, sumados en
+ * 		  una ventana de VENTANA períodos.
+ */
+typedef struct
+{
+	pid_control_t pid;
+	rampa_t rampa;
+	double velocidad; // [m/h]
+	double flancos_resto;
+	double carga; // Fracción de la velocidad que se pierde
+	double tension; // Fracción de la tensión nominal
+	uint32_t capturas[VENTANA];
+	uint32_t suma;
+	uint8_t idx;
+	uint32_t medida; // [m/h]
+	int32_t duty;
+} lazo_t;
+
+static void lazo_init(lazo_t *l)
+{
+	pid_init(&l->pid, KP, KI, 0, 0, DUTY_MAX);
+	rampa_config(&l->rampa, RAMPA_ACEL, RAMPA_DECEL, RAMPA_JERK);
+	rampa_reiniciar(&l->rampa, 0);
+
+	l->velocidad = 0;
+	l->flancos_resto = 0;
+	l->carga = 0;
+	l->tension = 1;
+	l->suma = 0;
+	l->idx = 0;
+	l->medida = 0;
+	l->duty = 0;
+
+	for (uint8_t i = 0; i < VENTANA; i++)
+		l->capturas[i] = 0;
+}
+
+/**
+ * @brief Un período del lazo: la planta avanza con el duty anterior,
+ * 		  se mide y se ejecuta un paso del PID con la prealimentación.
+ */
+static void lazo_paso(lazo_t *l, uint32_t referencia)
+{
+	double objetivo = ((double)l->duty / DUTY_MAX) * VEL_PLENA_MH * l->tension * (1.0 - l->carga);
+	double flancos;
+
+	l->velocidad += (objetivo - l->velocidad) * (1.0 - exp(-PERIODO_US / TAU_US));
+	l->flancos_resto += (l->velocidad * PERIODO_US / 3.6e9) * PULSOS_POR_METRO;
+	flancos = floor(l->flancos_resto);
+	l->flancos_resto -= flancos;
+
+	l->suma += (uint32_t)flancos - l->capturas[l->idx];
+	l->capturas[l->idx] = (uint32_t)flancos;
+	l->idx = (l->idx + 1) % VENTANA;
+	l->medida = (uint32_t)((l->suma * MH_POR_PULSO) / VENTANA);
+
+	int32_t ff = (int32_t)(((uint64_t)referencia * DUTY_MAX) / VEL_PLENA_MH);
+
+	l->duty = pid_paso(&l->pid, referencia, l->medida, ff);
+}
+
+/**
+ * @brief Corre el lazo s segundos con la referencia de la rampa hacia
+ * 		  objetivo, como en el equipo, y devuelve el máximo error
+ * 		  absoluto de la velocidad real contra la referencia.
+ */
+static double correr(lazo_t *l, uint32_t objetivo, double s)
+{
+	double peor = 0;
+
+	rampa_objetivo(&l->rampa, objetivo);
+
+	for (uint32_t k = 0; k < (uint32_t)(s * PASOS_POR_S); k++)
+	{
+		for (uint32_t i = 0; i < RAMPA_POR_PASO; i++)
+			rampa_paso(&l->rampa);
+
+		lazo_paso(l, rampa_actual(&l->rampa));
+
+		if (fabs(l->velocidad - rampa_actual(&l->rampa)) > peor)
+			peor = fabs(l->velocidad - rampa_actual(&l->rampa));
+	}
+
+	return peor;
+}
+
+/**
+ * @brief Pasos sueltos: saturación, término proporcional y derivativo
+ * 		  sobre la medida.
+ */
+static void paso(void)
+{
+	pid_control_t pid;
+
+	pid_init(&pid, PF_Q16(1, 1), 0, 0, -100, 100);
+	VERIFICAR_IGUAL(pid_paso(&pid, 50, 20, 0), 30);
+	VERIFICAR_IGUAL(pid_paso(&pid, 50, 20, 10), 40);
+	VERIFICAR_IGUAL(pid_paso(&pid, 500, 0, 0), 100);
+	VERIFICAR_IGUAL(pid_paso(&pid, 0, 500, 0), -100);
+
+	// El derivativo no ve el cambio de referencia, sí el de la medida
+	pid_init(&pid, 0, 0, PF_Q16(1, 1), -1000, 1000);
+	VERIFICAR_IGUAL(pid_paso(&pid, 0, 10, 0), 0); // Primer paso: sin medida anterior
+	VERIFICAR_IGUAL(pid_paso(&pid, 500, 10, 0), 0);
+	VERIFICAR_IGUAL(pid_paso(&pid, 500, 30, 0), -20);
+
+	// La integral acumula e * Ki por paso
+	pid_init(&pid, 0, PF_Q16(1, 4), 0, -1000, 1000);
+
+	for (int k = 0; k < 8; k++)
+		pid_paso(&pid, 10, 0, 0);
+
+	VERIFICAR_IGUAL(pid_paso(&pid, 10, 0, 0), 23); // 9 * 10 / 4 = 22.5
+	pid_reiniciar(&pid);
+	VERIFICAR_IGUAL(pid_paso(&pid, 10, 0, 0), 3); // 2.5
+}
+
+/**
+ * @brief Cambios de velocidad: la cinta sigue la rampa con un
+ * 		  atraso acotado y llega sin error en régimen.
+ */
+static void seguimiento(void)
+{
+	lazo_t l;
+
+	lazo_init(&l);
+	VERIFICAR(correr(&l, 8000, 12) < ATRASO_MAX_MH);
+	VERIFICAR_CERCA(l.velocidad, 8000, 100);
+	VERIFICAR_CERCA(l.duty / (double)DUTY_MAX, 0.4, 0.01);
+
+	VERIFICAR(correr(&l, 12000, 8) < ATRASO_MAX_MH);
+	VERIFICAR_CERCA(l.velocidad, 12000, 100);
+
+	VERIFICAR(correr(&l, 3000, 10) < ATRASO_MAX_MH);
+	VERIFICAR_CERCA(l.velocidad, 3000, 100);
+}
+
+/**
+ * @brief Carga y caída de tensión: a lazo abierto la cinta bajaría
+ * 		  10%; la integral sube el duty hasta recuperar la velocidad.
+ */
+static void perturbacion(void)
+{
+	lazo_t l;
+
+	lazo_init(&l);
+	correr(&l, 8000, 12);
+
+	l.carga = 0.1;
+	correr(&l, 8000, 5);
+
+	VERIFICAR_CERCA(l.velocidad, 8000, 100);
+	VERIFICAR_CERCA(l.duty / (double)DUTY_MAX, 0.4 / 0.9, 0.01);
+
+	l.carga = 0;
+	l.tension = 0.85;
+	correr(&l, 8000, 5);
+
+	VERIFICAR_CERCA(l.velocidad, 8000, 100);
+	VERIFICAR_CERCA(l.duty / (double)DUTY_MAX, 0.4 / 0.85, 0.01);
+}
+
+/**
+ * @brief Anti-windup, con escalones de referencia sin rampa: con una
+ * 		  referencia inalcanzable el duty queda al máximo pero la
+ * 		  integral no crece, así que al bajar la referencia el duty
+ * 		  sale de la saturación en el primer paso y la cinta no se
+ * 		  pasa.
+ */
+static void saturacion(void)
+{
+	lazo_t l;
+
+	lazo_init(&l);
+	l.carga = 0.5;
+
+	for (uint32_t k = 0; k < (5 * PASOS_POR_S); k++)
+		lazo_paso(&l, 15000);
+
+	VERIFICAR_IGUAL(l.duty, DUTY_MAX);
+	VERIFICAR_CERCA(l.velocidad, VEL_PLENA_MH * 0.5, 100);
+
+	int64_t integral = l.pid.integral;
+
+	for (uint32_t k = 0; k < (5 * PASOS_POR_S); k++)
+		lazo_paso(&l, 15000);
+
+	VERIFICAR_IGUAL(l.pid.integral, integral);
+
+	l.carga = 0;
+	lazo_paso(&l, 6000);
+	VERIFICAR(l.duty < DUTY_MAX);
+
+	double minimo = l.velocidad;
+
+	for (uint32_t k = 0; k < (3 * PASOS_POR_S); k++)
+	{
+		lazo_paso(&l, 6000);
+
+		if (l.velocidad < minimo)
+			minimo = l.velocidad;
+	}
+
+	VERIFICAR(minimo > 6000 * 0.95);
+	VERIFICAR_CERCA(l.velocidad, 6000, 100);
+}
+
+int main(void)
+{
+	paso();
+	seguimiento();
+	perturbacion();
+	saturacion();
+
+	PRUEBA_FIN();
+}
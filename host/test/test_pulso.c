@@ -0,0 +1,185 @@
+/*
+===============================================================================
+ Nombre      : test_pulso.c
+ Description : Estimación de la frecuencia cardíaca contra un modelo del
+               sensor: variabilidad, rebotes, latidos perdidos y
+               prematuros, y pérdida de la señal (ver pulso.h)
+===============================================================================
+*/
+
+#include "prueba.h"
+#include "pulso.h"
+
+#define TICKS_POR_S (1000000 / PULSO_TICK_US)
+#define VARIABILIDAD 3 // Variación de latido a latido [%]
+
+static uint32_t t = 0xfffe0000; // [ticks]; el timer desborda durante la prueba
+
+/**
+ * @brief Intervalo entre latidos a ppm pulsaciones por minuto, con la
+ * 		  variabilidad natural del ritmo.
+ */
+static uint32_t intervalo(double ppm)
+{
+	double base = (60.0 * TICKS_POR_S) / ppm;
+	double variacion = ((double)(prueba_azar() % 2001) - 1000) / 1000 * VARIABILIDAD / 100;
+
+	return (uint32_t)(base * (1 + variacion));
+}
+
+/**
+ * @brief n latidos a ppm pulsaciones por minuto.
+ */
+static void latidos(double ppm, uint32_t n)
+{
+	for (uint32_t i = 0; i < n; i++)
+	{
+		t += intervalo(ppm);
+
+		pulso_capturar(t);
+	}
+}
+
+/**
+ * @brief Ritmo estable y cambios graduales de ejercicio.
+ */
+static void ritmo(void)
+{
+	pulso_init();
+	VERIFICAR_IGUAL(pulso_ppm_x10(), 0);
+
+	t += TICKS_POR_S;
+	pulso_capturar(t); // Sólo referencia
+	VERIFICAR_IGUAL(pulso_ppm_x10(), 0);
+
+	latidos(75, PULSO_VENTANA);
+	VERIFICAR_CERCA(pulso_ppm_x10(), 750, 15);
+	VERIFICAR_IGUAL(pulso_t_ultimo(), t);
+	VERIFICAR_IGUAL(pulso_rechazados(), 0);
+
+	// De 75 a 150[ppm] en poco más de un minuto: la ventana acompaña
+	double peor = 0;
+
+	for (double ppm = 75; ppm < 150; ppm += 0.5)
+	{
+		latidos(ppm, 1);
+
+		double error = ((double)pulso_ppm_x10() / 10) - ppm;
+
+		if ((error < 0 ? -error : error) > peor)
+			peor = error < 0 ? -error : error;
+	}
+
+	VERIFICAR(peor < 5);
+
+	latidos(150, PULSO_VENTANA);
+	VERIFICAR_CERCA(pulso_ppm_x10(), 1500, 30);
+	VERIFICAR_IGUAL(pulso_rechazados(), 0);
+	VERIFICAR_IGUAL(pulso_ppm(), (pulso_ppm_x10() + 5) / 10);
+}
+
+/**
+ * @brief Rebotes, latidos que el sensor no ve, latidos prematuros y
+ * 		  un cambio brusco de ritmo.
+ */
+static void artefactos(void)
+{
+	pulso_init();
+	t += TICKS_POR_S;
+	pulso_capturar(t);
+	latidos(80, PULSO_VENTANA);
+
+	uint32_t ppm_x10 = pulso_ppm_x10();
+	uint32_t aceptado = t;
+
+	// Rebote 20[ms] después del latido: se ignora
+	pulso_capturar(t + (TICKS_POR_S / 50));
+	VERIFICAR_IGUAL(pulso_rechazados(), 1);
+	VERIFICAR_IGUAL(pulso_ppm_x10(), ppm_x10);
+	VERIFICAR_IGUAL(pulso_t_ultimo(), aceptado);
+
+	// Latido perdido: el intervalo doble se rechaza y el último
+	// aceptado sigue siendo el anterior
+	t += intervalo(80) + intervalo(80);
+	pulso_capturar(t);
+	VERIFICAR_IGUAL(pulso_rechazados(), 2);
+	VERIFICAR_IGUAL(pulso_ppm_x10(), ppm_x10);
+	VERIFICAR_IGUAL(pulso_t_ultimo(), aceptado);
+
+	latidos(80, 1); // Se mide desde el latido del intervalo doble
+	VERIFICAR_IGUAL(pulso_rechazados(), 2);
+	VERIFICAR_IGUAL(pulso_t_ultimo(), t);
+
+	// Extrasístole con pausa compensatoria: los dos se rechazan
+	aceptado = t;
+	ppm_x10 = pulso_ppm_x10();
+	t += intervalo(80) / 2;
+	pulso_capturar(t);
+	t += (intervalo(80) * 3) / 2;
+	pulso_capturar(t);
+	VERIFICAR_IGUAL(pulso_rechazados(), 4);
+	VERIFICAR_IGUAL(pulso_ppm_x10(), ppm_x10);
+	VERIFICAR_IGUAL(pulso_t_ultimo(), aceptado);
+
+	latidos(80, 1);
+	VERIFICAR_CERCA(pulso_ppm_x10(), 800, 20);
+
+	// Salto de 80 a 150[ppm]: tras PULSO_RECHAZOS_MAX rechazos se
+	// toma el ritmo nuevo
+	latidos(150, PULSO_RECHAZOS_MAX);
+	VERIFICAR_CERCA(pulso_ppm_x10(), 1500, 50);
+	VERIFICAR_IGUAL(pulso_t_ultimo(), t);
+	latidos(150, PULSO_VENTANA);
+	VERIFICAR_CERCA(pulso_ppm_x10(), 1500, 30);
+}
+
+/**
+ * @brief Se pierde la señal: no hay más medición y la antigüedad del
+ * 		  último latido aceptado crece hasta que la señal vuelve.
+ */
+static void perdida(void)
+{
+	pulso_init();
+	t += TICKS_POR_S;
+	pulso_capturar(t);
+	latidos(120, PULSO_VENTANA);
+	VERIFICAR_CERCA(pulso_ppm_x10(), 1200, 30);
+
+	uint32_t aceptado = t;
+
+	// El sensor se suelta 5[s]; al volver, el primer flanco sólo es referencia
+	t += 5 * TICKS_POR_S;
+	pulso_capturar(t);
+	VERIFICAR_IGUAL(pulso_ppm_x10(), 0);
+	VERIFICAR_IGUAL(pulso_ppm(), 0);
+	VERIFICAR_IGUAL(pulso_t_ultimo(), aceptado);
+	VERIFICAR((t - pulso_t_ultimo()) >= (5 * TICKS_POR_S));
+
+	// Ruido mientras está suelto: flancos erráticos, ninguno aceptado
+	for (uint32_t i = 0; i < 20; i++)
+	{
+		t += (i & 1) ? (TICKS_POR_S / 10) : (3 * TICKS_POR_S);
+		pulso_capturar(t);
+	}
+
+	VERIFICAR_IGUAL(pulso_ppm_x10(), 0);
+	VERIFICAR_IGUAL(pulso_t_ultimo(), aceptado);
+
+	// Vuelve la señal
+	t += 3 * TICKS_POR_S;
+	pulso_capturar(t);
+	latidos(100, 1);
+	VERIFICAR_CERCA(pulso_ppm_x10(), 1000, 40);
+	VERIFICAR_IGUAL(pulso_t_ultimo(), t);
+	latidos(100, PULSO_VENTANA);
+	VERIFICAR_CERCA(pulso_ppm_x10(), 1000, 20);
+}
+
+int main(void)
+{
+	ritmo();
+	artefactos();
+	perdida();
+
+	PRUEBA_FIN();
+}
@@ -0,0 +1,145 @@
+/*
+===============================================================================
+ Nombre      : test_punto_fijo.c
+ Description : Conversiones en punto fijo contra la referencia en float
+               (ver punto_fijo.h y metricas.h)
+===============================================================================
+*/
+
+#include <math.h>
+#include "prueba.h"
+#include "punto_fijo.h"
+#include "metricas.h"
+
+#define FRAC_BITS 4 // ADQ_FRAC_BITS
+#define CUENTAS 4096
+
+/**
+ * @brief Canales del ADC con las ganancias de TP_Integrador.c y la
+ * 		  conversión en float que reemplazan.
+ */
+static const struct
+{
+	const char *nombre;
+	int32_t ganancia_q16;
+	double por_cuenta; // Unidades de salida por cuenta del ADC
+} canales[] =
+{
+	{ "temperatura", PF_Q16(PF_LM35_CENTI_POR_CUENTA, 1 << FRAC_BITS), 0.08 * 100 }, // adc * 0.08 [ºC]
+	{ "corriente", PF_Q16(3300, 4096 << FRAC_BITS), 3300.0 / 4096 },
+	{ "tension", PF_Q16(3300 * 11, 4096 << FRAC_BITS), 3300.0 * 11 / 4096 },
+	{ "inclinacion", PF_Q16(150, 4096 << FRAC_BITS), 150.0 / 4096 }
+};
+
+/**
+ * @brief Cada lectura posible (en 1/16 de cuenta) queda a no más de
+ * 		  media unidad del valor exacto: un único redondeo.
+ */
+static void adc(void)
+{
+	for (unsigned c = 0; c < sizeof(canales) / sizeof(canales[0]); c++)
+	{
+		double peor = 0;
+
+		for (uint32_t x = 0; x < (CUENTAS << FRAC_BITS); x++)
+		{
+			double ref = ((double)x / (1 << FRAC_BITS)) * canales[c].por_cuenta;
+			double err = fabs(pf_escalar_q16(x, canales[c].ganancia_q16, 0) - ref);
+
+			if (err > peor)
+				peor = err;
+		}
+
+		VERIFICAR(peor <= 0.5 + 1e-9);
+
+		if (peor > 0.5 + 1e-9)
+			fprintf(stderr, "  canal %s: error %g\n", canales[c].nombre, peor);
+	}
+
+	// Temperatura por cuenta entera: exactamente round(adc * 0.08 * 100)
+	for (uint32_t adc = 0; adc < CUENTAS; adc++)
+		VERIFICAR_IGUAL(pf_escalar_q16(adc << FRAC_BITS, canales[0].ganancia_q16, 0), lround(adc * 0.08 * 100));
+
+	VERIFICAR_IGUAL(pf_escalar_q16(3125 << FRAC_BITS, canales[0].ganancia_q16, 0), 25000); // 250.00[ºC], fondo del LM35
+
+	// Ganancias que no son exactas en Q16 y offsets negativos
+	for (int k = 0; k < 20000; k++)
+	{
+		uint32_t num = 1 + (prueba_azar() % 50000);
+		uint32_t den = 1 + (prueba_azar() % 70000);
+		int32_t offset = (int32_t)(prueba_azar() % 2001) - 1000;
+		uint32_t x = prueba_azar() % (CUENTAS << FRAC_BITS);
+		double ref = ((double)x * num / den) + offset;
+
+		if ((double)num / den >= 32767) // Fuera del rango de Q16.16
+			continue;
+
+		VERIFICAR_CERCA(pf_escalar_q16(x, PF_Q16(num, den), offset), ref, 0.5 + (x / 65536.0) + 1e-9);
+	}
+}
+
+static void velocidad(void)
+{
+	for (uint32_t v = 0; v <= 200; v++) // Décimas de Km/h
+		VERIFICAR_IGUAL(v * PF_MH_POR_DECIMA, lround((v / 10.0) * 1000));
+}
+
+/**
+ * @brief Referencia en double de la energía de un tick (ecuaciones
+ * 		  del ACSM, ver metricas.h) [kcal].
+ */
+static double kcal_tick(double vel_mh, double inclinacion, double peso)
+{
+	double v = vel_mh / 60; // [m/min]
+	double pendiente = inclinacion / 1000;
+	double vo2 = 3.5;
+
+	if (vel_mh > METRICAS_CORRER_MH)
+		vo2 += (0.2 * v) + (0.9 * v * pendiente);
+	else
+		vo2 += (0.1 * v) + (1.8 * v * pendiente);
+
+	return vo2 * peso / 1000 * 5 / 60;
+}
+
+/**
+ * @brief Una hora con velocidad e inclinación variables: distancia,
+ * 		  energía y ritmo contra la integración en double.
+ */
+static void sesion(void)
+{
+	const uint32_t pulsos_por_metro = 4000;
+	metricas_t m;
+	uint32_t pulsos = 0xfffff000; // Cerca del desborde del contador del encoder
+	double metros = 0;
+	double kcal = 0;
+
+	metricas_iniciar(&m, pulsos_por_metro, METRICAS_PESO_KG, pulsos);
+
+	for (uint32_t t = 0; t < 3600; t++)
+	{
+		uint32_t avance = 2000 + (prueba_azar() % 18000); // 1.8 a 18[Km/h]
+		uint32_t inclinacion = prueba_azar() % 151;
+
+		pulsos += avance;
+		metricas_tick(&m, pulsos, 0, inclinacion);
+
+		double vel_mh = (double)avance * 3600 / pulsos_por_metro;
+
+		metros += (double)avance / pulsos_por_metro;
+		kcal += kcal_tick(vel_mh, inclinacion, METRICAS_PESO_KG);
+	}
+
+	VERIFICAR_IGUAL(metricas_distancia_m(&m), (uint32_t)metros);
+	VERIFICAR_CERCA(metricas_energia_kcal(&m), kcal, 1.0); // Se trunca a kcal enteras
+	VERIFICAR_CERCA(metricas_ritmo_s_km(&m), 3600 / (metros / 1000), 1.0);
+}
+
+int main(void)
+{
+	adc();
+	velocidad();
+	sesion();
+
+	PRUEBA_FIN();
+}
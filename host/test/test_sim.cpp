@@ -0,0 +1,277 @@
+/*
+===============================================================================
+ Nombre      : test_sim.cpp
+ Description : El equipo completo en el simulador (ver sim/sim.h): teclado,
+               latidos, ADC, comandos por UART2, telemetría, PWM y cinta
+===============================================================================
+*/
+
+#include <algorithm>
+#include "prueba.h"
+#include "sim.h"
+#include "decodificador.h"
+
+// Teclas (4 * fila + columna, ver keys_hex en TP_Integrador.c)
+#define TECLA_8 9
+#define TECLA_A 3
+#define TECLA_B 7
+#define TECLA_C 11
+#define TECLA_D 15
+
+#define CH_TEMPERATURA 0
+#define LM35_25C 310 // 250[mV] con referencia de 3.3[V]
+#define LATIDO_US 800000 // 75 pulsaciones por minuto
+#define MS 1000ULL
+#define HANDLERS 7 // PERFIL_CANTIDAD (ver perfil.h)
+
+static cinta::Decodificador decodificador;
+static std::vector<cinta::Trama> tramas; // Decodificadas desde el último clear()
+static uint64_t proximo_latido = 0;
+
+/**
+ * @brief Corre el equipo us microsegundos, con latidos cada LATIDO_US
+ * 		  desde proximo_latido si se pide, y pasa lo transmitido al
+ * 		  decodificador.
+ */
+static void correr(uint64_t us, bool latidos)
+{
+	uint64_t fin = sim_ahora_us() + us;
+
+	while (sim_ahora_us() < fin)
+	{
+		uint64_t hasta = fin;
+
+		if (latidos && (proximo_latido < hasta))
+			hasta = proximo_latido;
+
+		if (hasta > sim_ahora_us())
+			sim_correr_us(hasta - sim_ahora_us());
+
+		if (latidos && (sim_ahora_us() >= proximo_latido))
+		{
+			sim_latido();
+
+			proximo_latido += LATIDO_US;
+		}
+	}
+
+	uint8_t buf[256];
+	uint32_t n;
+	cinta::Trama t;
+
+	while ((n = sim_uart_leer(buf, sizeof(buf))) > 0)
+		decodificador.agregar(buf, n);
+
+	while (decodificador.siguiente(t))
+		tramas.push_back(t);
+}
+
+static void tecla(uint8_t t, bool latidos)
+{
+	sim_tecla(t, 1);
+	correr(50 * MS, latidos);
+	sim_tecla(t, 0);
+	correr(50 * MS, latidos);
+}
+
+/**
+ * @brief Envía un comando y corre el equipo us microsegundos, con
+ * 		  latidos.
+ */
+static void comando(uint8_t seq, const std::vector<uint8_t> &payload, uint64_t us)
+{
+	std::vector<uint8_t> t = cinta::armar(cinta::COMANDO, seq, payload);
+
+	tramas.clear();
+	sim_uart_escribir(t.data(), t.size());
+	correr(us, true);
+}
+
+static bool respuesta(uint8_t seq, cinta::Respuesta &r)
+{
+	for (size_t i = 0; i < tramas.size(); i++)
+		if ((tramas[i].tipo == cinta::RESPUESTA) && (tramas[i].seq == seq) && cinta::leer(tramas[i], r))
+			return true;
+
+	return false;
+}
+
+static bool ultima_telemetria(cinta::Telemetria &tel)
+{
+	for (size_t i = tramas.size(); i > 0; i--)
+		if ((tramas[i - 1].tipo == cinta::TELEMETRIA) && cinta::leer(tramas[i - 1], tel))
+			return true;
+
+	return false;
+}
+
+static size_t contar(uint8_t tipo)
+{
+	size_t n = 0;
+
+	for (size_t i = 0; i < tramas.size(); i++)
+		n += (tramas[i].tipo == tipo);
+
+	return n;
+}
+
+int main(void)
+{
+	cinta::Telemetria tel;
+	cinta::Respuesta r;
+	cinta::Estado e;
+
+	sim_iniciar();
+	sim_analogica(CH_TEMPERATURA, LM35_25C);
+
+	// Apagada: el PWM no sale y no se transmite nada
+	correr(200 * MS, false);
+	VERIFICAR_IGUAL(sim_duty_q16(), 0);
+	VERIFICAR_IGUAL(tramas.size(), 0);
+
+	// Los comandos se responden antes de tocar una tecla, y la
+	// respuesta no deja a la UART ocupada: pasa a RELOJ_REPOSO
+	comando(1, { cinta::CMD_ESTADO }, 100 * MS);
+	VERIFICAR(respuesta(1, r));
+	VERIFICAR(cinta::leer(r, e));
+	VERIFICAR_IGUAL(e.encendida, 0);
+	correr(2000 * MS, false);
+	comando(2, { cinta::CMD_ESTADO }, 100 * MS);
+	VERIFICAR(respuesta(2, r));
+	VERIFICAR(cinta::leer(r, e));
+	VERIFICAR_IGUAL(e.reloj_mhz, 24);
+
+	// 'A' enciende a 1[Km/h]
+	tecla(TECLA_A, false);
+	correr(2000 * MS, false);
+	VERIFICAR_CERCA(sim_cinta_mh(), 1000, 100);
+	VERIFICAR(sim_duty_q16() > 0);
+
+	// 'D' comienza el seguimiento: telemetría cada 0.5[s]
+	tecla(TECLA_D, false);
+	proximo_latido = sim_ahora_us();
+	correr(5000 * MS, true);
+	VERIFICAR(contar(cinta::TELEMETRIA) >= 8);
+	VERIFICAR(ultima_telemetria(tel));
+	VERIFICAR_IGUAL(tel.velocidad, 10);
+	VERIFICAR_CERCA(tel.ppm_x10, 750, 15);
+	VERIFICAR_CERCA(tel.temperatura, 2500, 100);
+	VERIFICAR_CERCA(tel.velocidad_medida, 1000, 100);
+
+	// '8' + 'B': 8[Km/h], la cinta sigue la rampa y el lazo lleva el duty a ~40%
+	tecla(TECLA_8, true);
+	tecla(TECLA_B, true);
+	correr(8000 * MS, true);
+	VERIFICAR_CERCA(sim_cinta_mh(), 8000, 150);
+	VERIFICAR_CERCA(sim_duty_q16() / 65536.0, 0.4, 0.03);
+	VERIFICAR(ultima_telemetria(tel));
+	VERIFICAR_IGUAL(tel.velocidad, 80);
+	VERIFICAR_CERCA(tel.velocidad_medida, 8000, 150);
+
+	// Con carga, el lazo sube el duty para sostener la velocidad
+	sim_carga(100);
+	correr(5000 * MS, true);
+	VERIFICAR_CERCA(sim_cinta_mh(), 8000, 150);
+	VERIFICAR(sim_duty_q16() > (0.42 * 65536));
+	sim_carga(0);
+
+	// Comando VELOCIDAD a 10[Km/h]: respuesta con el mismo seq
+	comando(42, { cinta::CMD_VELOCIDAD, 100, 0 }, 6000 * MS);
+	VERIFICAR(respuesta(42, r));
+	VERIFICAR_IGUAL(r.comando, cinta::CMD_VELOCIDAD);
+	VERIFICAR_IGUAL(r.resultado, cinta::RESP_OK);
+	VERIFICAR_CERCA(sim_cinta_mh(), 10000, 150);
+	VERIFICAR_CERCA(sim_duty_q16() / 65536.0, 0.5, 0.03);
+
+	// ARRANCAR con la sesión en curso no la reinicia
+	VERIFICAR(ultima_telemetria(tel));
+
+	uint32_t distancia = tel.distancia;
+
+	comando(44, { cinta::CMD_ARRANCAR }, 2000 * MS);
+	VERIFICAR(respuesta(44, r));
+	VERIFICAR_IGUAL(r.resultado, cinta::RESP_OK);
+	VERIFICAR(ultima_telemetria(tel));
+	VERIFICAR(tel.distancia > distancia);
+	VERIFICAR_CERCA(sim_cinta_mh(), 10000, 150);
+
+	// Comando PERFIL: respuesta y después una trama por handler
+	comando(43, { cinta::CMD_PERFIL }, 500 * MS);
+	VERIFICAR(respuesta(43, r));
+	VERIFICAR_IGUAL(r.comando, cinta::CMD_PERFIL);
+	VERIFICAR_IGUAL(r.resultado, cinta::RESP_OK);
+	VERIFICAR_IGUAL(contar(cinta::PERFIL), HANDLERS);
+
+	// 'C' y 'A' mientras frena: la cinta sigue desde donde iba, sin volver a 0
+	tecla(TECLA_C, false);
+	correr(1000 * MS, false);
+
+	uint32_t frenando = sim_cinta_mh();
+
+	VERIFICAR(frenando < 9500);
+	tecla(TECLA_A, false);
+	correr(3000 * MS, false);
+	VERIFICAR_CERCA(sim_cinta_mh(), frenando, 600);
+	VERIFICAR(sim_duty_q16() > 0);
+
+	// 'A' con la cinta encendida no hace nada
+	uint32_t sostenida = sim_cinta_mh();
+
+	tecla(TECLA_A, false);
+	correr(1000 * MS, false);
+	VERIFICAR_CERCA(sim_cinta_mh(), sostenida, 150);
+
+	// 'C' frena con la rampa, apaga el PWM y vuelca la sesión; la
+	// bitácora se programa recién con la cinta quieta
+	std::vector<uint8_t> flash(sim_flash, sim_flash + SIM_FLASH_BYTES);
+
+	tramas.clear();
+	tecla(TECLA_C, false);
+	correr(3000 * MS, false);
+	VERIFICAR(sim_cinta_mh() > 1000);
+	VERIFICAR(std::equal(flash.begin(), flash.end(), sim_flash));
+	correr(10000 * MS, false);
+	VERIFICAR_IGUAL(sim_duty_q16(), 0);
+	VERIFICAR(sim_cinta_mh() < 50);
+	VERIFICAR(!std::equal(flash.begin(), flash.end(), sim_flash));
+	VERIFICAR(contar(cinta::SESION) > 0);
+
+	// Detenida, pasa a RELOJ_REPOSO. ARRANCAR mientras sale la respuesta
+	// a ESTADO: el cambio de reloj espera a la UART sin cortar la trama
+	std::vector<uint8_t> cmds = cinta::armar(cinta::COMANDO, 50, { cinta::CMD_ESTADO });
+	std::vector<uint8_t> arrancar = cinta::armar(cinta::COMANDO, 51, { cinta::CMD_ARRANCAR });
+
+	cmds.insert(cmds.end(), arrancar.begin(), arrancar.end());
+	correr(2000 * MS, false);
+	tramas.clear();
+	sim_uart_escribir(cmds.data(), cmds.size());
+	correr(3000 * MS, true);
+	VERIFICAR(respuesta(50, r));
+	VERIFICAR(cinta::leer(r, e));
+	VERIFICAR_IGUAL(e.encendida, 0);
+	VERIFICAR_IGUAL(e.reloj_mhz, 24);
+	VERIFICAR(respuesta(51, r));
+	VERIFICAR_IGUAL(r.resultado, cinta::RESP_OK);
+	VERIFICAR_CERCA(sim_cinta_mh(), 1000, 100);
+
+	// Una trama que no es un comando se descarta y queda en los contadores de ESTADO
+	std::vector<uint8_t> ajena = cinta::armar(cinta::TELEMETRIA, 9, { 1, 2, 3 });
+
+	sim_uart_escribir(ajena.data(), ajena.size());
+	comando(52, { cinta::CMD_ESTADO }, 100 * MS);
+	VERIFICAR(respuesta(52, r));
+	VERIFICAR(cinta::leer(r, e));
+	VERIFICAR_IGUAL(e.reloj_mhz, 120);
+	VERIFICAR_IGUAL(e.cmd_invalidos, 1);
+	VERIFICAR_IGUAL(e.cmd_fuera_de_plazo, 0);
+	VERIFICAR_IGUAL(e.uart_rx_descartadas, 0);
+	VERIFICAR_IGUAL(e.uart_rx_errores, 0);
+	VERIFICAR_IGUAL(e.uart_tx_descartadas, 0);
+	VERIFICAR_IGUAL(e.uart_tx_tramas_max, 2); // La sesión se vuelca con el doble buffer lleno
+
+	VERIFICAR_IGUAL(decodificador.contadores().crc, 0);
+	VERIFICAR_IGUAL(decodificador.contadores().cobs, 0);
+	VERIFICAR_IGUAL(decodificador.contadores().version, 0);
+
+	PRUEBA_FIN();
+}
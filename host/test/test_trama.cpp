@@ -0,0 +1,370 @@
+/*
+===============================================================================
+ Nombre      : test_trama.cpp
+ Description : Ida y vuelta entre el codificador del firmware (trama.c)
+               y el decodificador de la PC (decodificador.cpp)
+===============================================================================
+*/
+
+#include <cstring>
+#include "prueba.h"
+#include "trama.h"
+#include "decodificador.h"
+
+static std::vector<uint8_t> flujo; // Lo que saldría por UART2
+
+static void enviar(uint8_t tipo, uint8_t seq, const uint8_t *payload, uint32_t len)
+{
+	uint8_t out[TRAMA_MAX_CODIFICADA(TRAMA_PAYLOAD_MAX)];
+	uint32_t n = trama_armar(out, tipo, seq, payload, len);
+
+	flujo.insert(flujo.end(), out, out + n);
+}
+
+/**
+ * @brief Entrega el flujo al decodificador en pedazos al azar, como
+ * 		  llegarían por el puerto serie.
+ */
+static void recibir(cinta::Decodificador &d)
+{
+	for (size_t i = 0; i < flujo.size();)
+	{
+		size_t n = 1 + (prueba_azar() % 40);
+
+		if (n > flujo.size() - i)
+			n = flujo.size() - i;
+
+		d.agregar(&flujo[i], n);
+		i += n;
+	}
+
+	flujo.clear();
+}
+
+static trama_telemetria_t telemetria_azar(void)
+{
+	trama_telemetria_t t;
+
+	t.ppm_x10 = prueba_azar();
+	t.velocidad = prueba_azar();
+	t.temperatura = (int16_t)prueba_azar();
+	t.distancia = prueba_azar();
+	t.tiempo_s = prueba_azar();
+	t.velocidad_medida = prueba_azar();
+	t.error_velocidad = (int16_t)prueba_azar();
+	t.energia = prueba_azar();
+	t.ppm_media = prueba_azar();
+	t.ritmo = prueba_azar();
+
+	if (prueba_azar() & 1) // Muchos ceros, para ejercitar COBS
+		t.distancia = t.tiempo_s = t.energia = 0;
+
+	return t;
+}
+
+static void telemetria(void)
+{
+	const int N = 2000;
+	trama_telemetria_t enviadas[N];
+	uint8_t payload[TRAMA_TELEMETRIA_SIZE];
+	cinta::Decodificador d;
+
+	for (int i = 0; i < N; i++)
+	{
+		enviadas[i] = telemetria_azar();
+		trama_telemetria_serializar(&enviadas[i], payload);
+		enviar(TRAMA_TIPO_TELEMETRIA, (uint8_t)i, payload, sizeof(payload));
+	}
+
+	recibir(d);
+
+	cinta::Trama t;
+	int i = 0;
+
+	for (; d.siguiente(t); i++)
+	{
+		cinta::Telemetria r;
+
+		VERIFICAR(cinta::leer(t, r));
+		VERIFICAR_IGUAL(t.seq, (uint8_t)i);
+		VERIFICAR_IGUAL(r.ppm_x10, enviadas[i].ppm_x10);
+		VERIFICAR_IGUAL(r.velocidad, enviadas[i].velocidad);
+		VERIFICAR_IGUAL(r.temperatura, enviadas[i].temperatura);
+		VERIFICAR_IGUAL(r.distancia, enviadas[i].distancia);
+		VERIFICAR_IGUAL(r.tiempo_s, enviadas[i].tiempo_s);
+		VERIFICAR_IGUAL(r.velocidad_medida, enviadas[i].velocidad_medida);
+		VERIFICAR_IGUAL(r.error_velocidad, enviadas[i].error_velocidad);
+		VERIFICAR_IGUAL(r.energia, enviadas[i].energia);
+		VERIFICAR_IGUAL(r.ppm_media, enviadas[i].ppm_media);
+		VERIFICAR_IGUAL(r.ritmo, enviadas[i].ritmo);
+	}
+
+	VERIFICAR_IGUAL(i, N);
+	VERIFICAR_IGUAL(d.contadores().validas, N);
+	VERIFICAR_IGUAL(d.contadores().perdidas, 0);
+}
+
+static void estado(void)
+{
+	trama_estado_t e;
+	uint8_t payload[TRAMA_RESP_ENCABEZADO + TRAMA_ESTADO_SIZE];
+	cinta::Decodificador d;
+
+	e.encendida = 1;
+	e.modo = 2;
+	e.velocidad = 123;
+	e.velocidad_medida = 12250;
+	e.distancia = 70000;
+	e.tiempo_s = 3601;
+	e.energia = 512;
+	e.ppm_media = 141;
+	e.latencia_max = 850;
+	e.reloj_mhz = 120;
+	e.transicion_max_us = 410;
+	e.plan_latencia_max_us = 95;
+	e.teclado_ciclos_max = 1830;
+	e.pulso_rechazados = 4;
+	e.estado_reintentos = 0xffff;
+	e.uart_rx_descartadas = 2;
+	e.uart_rx_errores = 1;
+	e.uart_tx_descartadas = 300;
+	e.uart_tx_tramas_max = 2;
+	e.cmd_invalidos = 5;
+	e.cmd_fuera_de_plazo = 0;
+	e.recuperacion_us = 123456;
+
+	for (uint8_t i = 0; i < TRAMA_ESTADO_ZONAS; i++)
+		e.tiempo_zona[i] = (uint16_t)(1000 * i + 7);
+
+	payload[0] = TRAMA_CMD_ESTADO;
+	payload[1] = TRAMA_RESP_OK;
+	trama_estado_serializar(&e, payload + TRAMA_RESP_ENCABEZADO);
+	enviar(TRAMA_TIPO_RESPUESTA, 77, payload, sizeof(payload));
+	recibir(d);
+
+	cinta::Trama t;
+	cinta::Respuesta r;
+	cinta::Estado s;
+
+	VERIFICAR(d.siguiente(t));
+	VERIFICAR_IGUAL(t.seq, 77);
+	VERIFICAR(cinta::leer(t, r));
+	VERIFICAR(cinta::leer(r, s));
+	VERIFICAR_IGUAL(s.encendida, e.encendida);
+	VERIFICAR_IGUAL(s.modo, e.modo);
+	VERIFICAR_IGUAL(s.velocidad, e.velocidad);
+	VERIFICAR_IGUAL(s.velocidad_medida, e.velocidad_medida);
+	VERIFICAR_IGUAL(s.distancia, e.distancia);
+	VERIFICAR_IGUAL(s.tiempo_s, e.tiempo_s);
+	VERIFICAR_IGUAL(s.energia, e.energia);
+	VERIFICAR_IGUAL(s.ppm_media, e.ppm_media);
+	VERIFICAR_IGUAL(s.latencia_max, e.latencia_max);
+	VERIFICAR_IGUAL(s.reloj_mhz, e.reloj_mhz);
+	VERIFICAR_IGUAL(s.transicion_max_us, e.transicion_max_us);
+	VERIFICAR_IGUAL(s.plan_latencia_max_us, e.plan_latencia_max_us);
+	VERIFICAR_IGUAL(s.teclado_ciclos_max, e.teclado_ciclos_max);
+	VERIFICAR_IGUAL(s.pulso_rechazados, e.pulso_rechazados);
+	VERIFICAR_IGUAL(s.estado_reintentos, e.estado_reintentos);
+	VERIFICAR_IGUAL(s.uart_rx_descartadas, e.uart_rx_descartadas);
+	VERIFICAR_IGUAL(s.uart_rx_errores, e.uart_rx_errores);
+	VERIFICAR_IGUAL(s.uart_tx_descartadas, e.uart_tx_descartadas);
+	VERIFICAR_IGUAL(s.uart_tx_tramas_max, e.uart_tx_tramas_max);
+	VERIFICAR_IGUAL(s.cmd_invalidos, e.cmd_invalidos);
+	VERIFICAR_IGUAL(s.cmd_fuera_de_plazo, e.cmd_fuera_de_plazo);
+	VERIFICAR_IGUAL(s.recuperacion_us, e.recuperacion_us);
+
+	for (uint8_t i = 0; i < TRAMA_ESTADO_ZONAS; i++)
+		VERIFICAR_IGUAL(s.tiempo_zona[i], e.tiempo_zona[i]);
+}
+
+static void sesion(void)
+{
+	uint8_t payload[TRAMA_PAYLOAD_MAX];
+	trama_registro_t r[TRAMA_SESION_REGISTROS];
+	cinta::Decodificador d;
+
+	payload[0] = 14;
+	payload[1] = 0;
+	payload[2] = 21;
+	payload[3] = 0;
+	payload[4] = 2;
+	payload[5] = 0;
+
+	for (uint8_t i = 0; i < TRAMA_SESION_REGISTROS; i++)
+	{
+		r[i].tiempo_s = (uint16_t)(2 * (14 + i));
+		r[i].ppm = (uint8_t)(90 + i);
+		r[i].velocidad = (uint8_t)(50 + i);
+		r[i].temperatura = (int16_t)(-150 + 100 * i);
+		r[i].distancia = (uint16_t)(40 * i);
+
+		trama_registro_serializar(&r[i], payload + TRAMA_SESION_ENCABEZADO + (i * TRAMA_REGISTRO_SIZE));
+	}
+
+	enviar(TRAMA_TIPO_SESION, 0, payload, TRAMA_SESION_ENCABEZADO + (TRAMA_SESION_REGISTROS * TRAMA_REGISTRO_SIZE));
+	recibir(d);
+
+	cinta::Trama t;
+	cinta::Sesion s;
+
+	VERIFICAR(d.siguiente(t));
+	VERIFICAR(cinta::leer(t, s));
+	VERIFICAR_IGUAL(s.primero, 14);
+	VERIFICAR_IGUAL(s.total, 21);
+	VERIFICAR_IGUAL(s.decimacion, 2);
+	VERIFICAR_IGUAL(s.registros.size(), TRAMA_SESION_REGISTROS);
+
+	for (size_t i = 0; i < s.registros.size(); i++)
+	{
+		VERIFICAR_IGUAL(s.registros[i].tiempo_s, r[i].tiempo_s);
+		VERIFICAR_IGUAL(s.registros[i].ppm, r[i].ppm);
+		VERIFICAR_IGUAL(s.registros[i].velocidad, r[i].velocidad);
+		VERIFICAR_IGUAL(s.registros[i].temperatura, r[i].temperatura);
+		VERIFICAR_IGUAL(s.registros[i].distancia, r[i].distancia);
+	}
+}
+
+/**
+ * @brief Los comandos que arma la PC los tiene que aceptar trama_abrir.
+ */
+static void comandos(void)
+{
+	for (unsigned largo = 1; largo <= TRAMA_PAYLOAD_MAX; largo++)
+	{
+		std::vector<uint8_t> p(largo);
+
+		for (auto &b : p)
+			b = (prueba_azar() & 3) ? (uint8_t)prueba_azar() : 0;
+
+		std::vector<uint8_t> c = cinta::armar(cinta::COMANDO, (uint8_t)largo, p);
+		uint8_t tipo, seq, payload[TRAMA_PAYLOAD_MAX];
+		uint32_t plen;
+
+		VERIFICAR_IGUAL(c.back(), 0);
+		VERIFICAR_IGUAL(trama_abrir(c.data(), c.size() - 1, &tipo, &seq, payload, &plen), TRAMA_OK);
+		VERIFICAR_IGUAL(tipo, TRAMA_TIPO_COMANDO);
+		VERIFICAR_IGUAL(seq, largo);
+		VERIFICAR_IGUAL(plen, largo);
+		VERIFICAR(memcmp(payload, p.data(), largo) == 0);
+	}
+}
+
+/**
+ * @brief COBS y CRC de los dos lados dan lo mismo, incluidos los
+ * 		  bloques de 254 bytes sin ceros.
+ */
+static void cobs_crc(void)
+{
+	static uint8_t cod[600];
+	static uint8_t dec[600];
+
+	for (int k = 0; k < 3000; k++)
+	{
+		size_t len = prueba_azar() % 520;
+		unsigned ceros = prueba_azar() % 4; // 0: sin ceros
+		std::vector<uint8_t> in(len);
+
+		for (auto &b : in)
+			b = (ceros && !(prueba_azar() % (ceros * 8))) ? 0 : (uint8_t)(1 + prueba_azar() % 255);
+
+		uint32_t n = trama_cobs_codificar(in.data(), len, cod);
+		std::vector<uint8_t> c = cinta::cobs_codificar(in);
+
+		VERIFICAR_IGUAL(n, c.size());
+		VERIFICAR(memcmp(cod, c.data(), n) == 0);
+		VERIFICAR(memchr(cod, 0, n) == NULL);
+
+		std::vector<uint8_t> vuelta;
+
+		if (len)
+		{
+			VERIFICAR(cinta::cobs_decodificar(cod, n, vuelta));
+			VERIFICAR(vuelta == in);
+			VERIFICAR_IGUAL(trama_cobs_decodificar(c.data(), c.size(), dec), len);
+			VERIFICAR(memcmp(dec, in.data(), len) == 0);
+		}
+
+		VERIFICAR_IGUAL(cinta::crc16(in.data(), len), trama_crc16(in.data(), len, 0xffff));
+	}
+
+	const uint8_t check[] = "123456789";
+
+	VERIFICAR_IGUAL(cinta::crc16(check, 9), 0x29b1); // Valor de referencia de CRC-16/CCITT-FALSE
+}
+
+/**
+ * @brief Tramas corrompidas, perdidas y de otra versión: se descartan
+ * 		  sin perder la sincronización con las siguientes.
+ */
+static void errores(void)
+{
+	uint8_t payload[TRAMA_TELEMETRIA_SIZE];
+	trama_telemetria_t t = telemetria_azar();
+	cinta::Decodificador d;
+
+	trama_telemetria_serializar(&t, payload);
+
+	enviar(TRAMA_TIPO_TELEMETRIA, 10, payload, sizeof(payload));
+
+	size_t inicio = flujo.size();
+
+	enviar(TRAMA_TIPO_TELEMETRIA, 11, payload, sizeof(payload));
+	flujo[inicio + 5] ^= 0x10; // Un bit cambiado: falla el CRC (o COBS)
+
+	if (flujo[inicio + 5] == 0)
+		flujo[inicio + 5] = 0x55;
+
+	enviar(TRAMA_TIPO_TELEMETRIA, 15, payload, sizeof(payload)); // Se perdieron 12 a 14
+
+	inicio = flujo.size();
+	enviar(TRAMA_TIPO_TELEMETRIA, 16, payload, sizeof(payload));
+	flujo.resize(inicio + 6); // Cortada por la mitad
+	flujo.push_back(0);
+
+	std::vector<uint8_t> otra = cinta::armar(cinta::TELEMETRIA, 17, std::vector<uint8_t>(payload, payload + sizeof(payload)));
+	std::vector<uint8_t> cruda;
+
+	VERIFICAR(cinta::cobs_decodificar(otra.data(), otra.size() - 1, cruda));
+
+	cruda[0] = (cruda[0] & 0xf) | (2 << 4); // Versión anterior, CRC recalculado
+	uint16_t crc = cinta::crc16(cruda.data(), cruda.size() - 2);
+	cruda[cruda.size() - 2] = crc & 0xff;
+	cruda[cruda.size() - 1] = crc >> 8;
+	otra = cinta::cobs_codificar(cruda);
+	otra.push_back(0);
+	flujo.insert(flujo.end(), otra.begin(), otra.end());
+
+	flujo.insert(flujo.end(), 200, 0x42); // Basura demasiado larga
+	flujo.push_back(0);
+
+	enviar(TRAMA_TIPO_TELEMETRIA, 18, payload, sizeof(payload));
+	recibir(d);
+
+	cinta::Trama r;
+	uint8_t seqs[8];
+	int n = 0;
+
+	while (d.siguiente(r) && (n < 8))
+		seqs[n++] = r.seq;
+
+	VERIFICAR_IGUAL(n, 3);
+	VERIFICAR_IGUAL(seqs[0], 10);
+	VERIFICAR_IGUAL(seqs[1], 15);
+	VERIFICAR_IGUAL(seqs[2], 18);
+	VERIFICAR_IGUAL(d.contadores().crc + d.contadores().cobs + d.contadores().largo, 3);
+	VERIFICAR(d.contadores().largo >= 1); // La basura larga
+	VERIFICAR_IGUAL(d.contadores().version, 1);
+	VERIFICAR_IGUAL(d.contadores().perdidas, 4 + 2); // 11 a 14 y 16, 17
+}
+
+int main(void)
+{
+	telemetria();
+	estado();
+	sesion();
+	comandos();
+	cobs_crc();
+	errores();
+
+	PRUEBA_FIN();
+}
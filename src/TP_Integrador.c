@@ -17,6 +17,35 @@
 #include "lpc17xx_uart.h"
 #include "lpc17xx_adc.h"
 #include "lpc17xx_gpdma.h"
+#include "lpc17xx_rit.h"
+#include "lpc17xx_clkpwr.h"
+#include "lpc17xx_qei.h"
+#include "uart_tx.h"
+#include "uart_rx.h"
+#include "trama.h"
+#include "teclado.h"
+#include "pulso.h"
+#include "punto_fijo.h"
+#include "adquisicion.h"
+#include "planificador.h"
+#include "sesion.h"
+#include "bitacora.h"
+#include "iap.h"
+#include "ciclos.h"
+#include "perfil.h"
+#include "control.h"
+#include "rampa.h"
+#include "motor.h"
+#include "programa.h"
+#include "crucero.h"
+#include "metricas.h"
+#include "tiempo.h"
+#include "rueda.h"
+#include "estado.h"
+#include "arranque.h"
+#include "ram.h"
+#include "latencia.h"
+#include "reloj.h"
 
 // Definiciones útiles
 #define INPUT 0
@@ -27,43 +56,67 @@
 #define UPPER 1
 #define PORT(x) x
 #define BIT(x) (1 << x)
-#define ROWS 4
-#define COLUMNS 4
 #define SIZE (ROWS * COLUMNS)
-#define SIZEB 10
-#define TIMER 600000
-#define MAX_SPEED 20 // [Km/h]
-#define PWMPRESCALE (25-1)
-#define UNIDAD 0
-#define DECENA 1
-#define CENTENA 2
-#define DMA_TRANSFER_SIZE 5
+#define MAX_SPEED 200 // [décimas de Km/h]
+#define VEL_DIGITOS 3 // Hasta 3 dígitos: el tercero es la décima
+#define TECLA_D 15 // Coordenada de 'D', que también funciona como modificador
+#define COMANDO_PLAZO_US 2000 // Cota para la latencia de un comando recibido por UART2
+#define TELEMETRIA_PERIODO_MIN 1 // [décimas de s]
+#define TELEMETRIA_PERIODO_MAX 100
+#define DIFERIDA_TICKS 1 // Ticks de la rueda entre el arranque y la configuración diferida
+#define REPOSO_ESPERA_TICKS TIEMPO_TICKS_POR_S // Reintento del paso a RELOJ_REPOSO mientras la UART transmite
+#define RELOJ_ESPERA_TICKS 1 // Reintento de un cambio de reloj mientras la UART transmite
+#define CH_TEMPERATURA 0 // AD0.0 (P0.23), LM35
+#define CH_CORRIENTE 2 // AD0.2 (P0.25), corriente del motor
+#define CH_TENSION 3 // AD0.3 (P0.26), tensión de alimentación
+#define CH_INCLINACION 5 // AD0.5 (P1.31), potenciómetro de inclinación
+
+_Static_assert(TRAMA_ESTADO_ZONAS == METRICAS_ZONAS, "El estado lleva el histograma completo");
 
 // Prototipado de funciones
 void cfg_gpio(void);
 void cfg_timers(void);
 void cfg_pwm(void);
+void cfg_pwm_periodo(void);
 void cfg_uart2(void);
+void cfg_uart2_linea(void);
 void cfg_adc(void);
 void cfg_dma(void);
-void delay(void);
+void cfg_diferida(void);
+void vencer_diferida(void *arg);
+void reescalar_perifericos(void);
+void cambiar_reloj(reloj_perfil_t perfil);
+void vencer_reloj(void *arg);
+void vencer_reposo(void *arg);
 void stop(void);
-void set_vel(uint8_t velocidad);
-
-uint8_t get_pressed_key(void);
-uint8_t get_digit(uint8_t, uint8_t);
+void set_vel(uint32_t velocidad);
+void publicar_sesion(void);
+void encender(void);
+void cerrar_sesion(void);
+void procesar_tecla(const teclado_evento_t *ev);
+void procesar_acorde(uint8_t key);
+void iniciar_seguimiento(void);
+void aplicar_programa(void);
+void aplicar_crucero(const estado_pulso_t *pulso);
+void tarea_adc(void);
+void tarea_teclado(void);
+void tarea_comando(void);
+void procesar_comando(uint8_t seq, const uint8_t *payload, uint32_t len, uint32_t t_llegada);
+void responder(uint8_t seq, uint8_t cmd, uint8_t resultado, const uint8_t *datos, uint32_t len);
+uint16_t saturar16(uint32_t x);
+uint32_t plan_latencia_max_us(void);
+void tarea_rueda(void);
+void tarea_segundo(void);
+void vencer_segundo(void *arg);
+void vencer_publicar(void *arg);
+void tarea_telemetria(void);
+void tarea_volcado(void);
+void tarea_detenido(void);
 
 // Variables globales
 uint8_t on = 0; // Flag para encendido
-uint8_t vel_digits[2] = { 0, 0 }; // Arreglo para los dígitos de la velocidad
+uint8_t vel_digits[VEL_DIGITOS] = { 0, 0, 0 }; // Arreglo para los dígitos de la velocidad
 uint8_t vel_index = 0; // Índice para el arreglo de velocidad
-uint8_t t_anterior = 0; // Tiempo de medición anterior (para capture)
-uint8_t t_actual = 0; // Tiempo de medición actual (para capture)
-uint8_t t_final = 0; // Tiempo resultante (para capture)
-uint8_t t_index = 0; // Índice para recorrer el arreglo de mediciones (para capture)
-uint8_t t_resultado = 0; // Promedio de mediciones (para capture)
-uint8_t t_flag = 0;  // Flag para indicar división en promediador móvil (para capture)
-uint8_t buff[SIZEB]; // Buffer con mediciones (para capture)
 uint8_t keys_hex[SIZE] = // Valores en hexadecimal del teclado matricial
 {
 	0x06, 0x5b, 0x4f, 0x77, // 1 2 3 A
@@ -78,34 +131,78 @@ uint8_t keys_dec[SIZE] = // Valores en decimal del teclado matricial
 	7, 8, 9, 0, // 7 8 9 X
 	0, 0, 0, 0  // X 0 X X
 };
-uint32_t p2aux = 0; // Copia auxiliar de la lectura del puerto 2 para antirrebote
-uint32_t ppm = 0;
-uint32_t velocidad = 0;
-float temperatura = 0;
-uint32_t distancia = 0;
+uint32_t velocidad = 0; // [décimas de Km/h]
+int32_t temperatura = 0; // [centésimas de ºC]
+uint32_t distancia = 0; // [m]
 uint32_t tiempo_s = 0;
-uint32_t DMASrc_Buffer[DMA_TRANSFER_SIZE];
-uint32_t DMADst_Buffer[DMA_TRANSFER_SIZE];
+crucero_t crucero; // Modo crucero por frecuencia cardíaca
+metricas_t metricas; // Distancia, energía y promedios de la sesión
+uint32_t cmd_latencia_max = 0; // Peor latencia de un comando hasta su actuación [us]
+uint32_t cmd_fuera_de_plazo = 0; // Comandos que superaron COMANDO_PLAZO_US
+uint32_t cmd_invalidos = 0; // Tramas recibidas que no son un comando válido
+rueda_timer_t timer_segundo; // Tick de 1[s] de la sesión
+rueda_timer_t timer_telemetria;
+rueda_timer_t timer_diferida; // Configuración diferida (ver cfg_diferida)
+rueda_timer_t timer_reposo; // Paso a RELOJ_REPOSO con la cinta detenida (ver vencer_reposo)
+rueda_timer_t timer_reloj; // Cambio de reloj que espera a que UART2 termine (ver cambiar_reloj)
+reloj_perfil_t reloj_pendiente = RELOJ_COMPLETO;
+uint32_t telemetria_periodo = TIEMPO_TICKS_POR_S / 2; // [ticks de la rueda]
+rampa_t rampa; // Referencia de velocidad, avanzada cada 1[ms] desde PWM1_IRQHandler
+uint32_t periodos_por_paso = 1; // Períodos del PWM por paso de la rampa
+volatile uint8_t deteniendo = 0; // Flag para apagar el PWM al terminar la rampa de frenado
+uint32_t recuperacion_us = 0; // Duración de la recuperación de la bitácora al arrancar
+const adq_canal_cfg_t canales_adc[] = // Canales barridos por el ADC
+{
+	{ CH_TEMPERATURA, PF_Q16(PF_LM35_CENTI_POR_CUENTA, 1 << ADQ_FRAC_BITS), 0, 3 }, // [centésimas de ºC]
+	{ CH_CORRIENTE, PF_Q16(3300, 4096 << ADQ_FRAC_BITS), 0, 2 }, // [mA], sensor de 1[V/A]
+	{ CH_TENSION, PF_Q16(3300 * 11, 4096 << ADQ_FRAC_BITS), 0, 4 }, // [mV], divisor 1:11
+	{ CH_INCLINACION, PF_Q16(150, 4096 << ADQ_FRAC_BITS), 0, 4 }  // [décimas de %], 0 a 15%
+};
 
 /**
  * @brief Función principal. Acá se configuran
  * 		  todos los periféricos.
+ *
+ * @details Los handlers de interrupción sólo capturan datos y
+ * 			publican eventos; el trabajo se hace a nivel de tarea,
+ * 			en orden de prioridad (ver planificador.h). Sin eventos
+ * 			pendientes, el núcleo duerme con WFI.
  */
 int main(void)
 {
-	for (uint8_t i = 0; i < DMA_TRANSFER_SIZE; i++)
-		DMASrc_Buffer[i] = 0;
+	reloj_init(reescalar_perifericos); // 120[MHz], antes de configurar cualquier periférico
+	arranque_marcar_hz(ARRANQUE_PLL0, RELOJ_XTAL_HZ);
+
+	plan_init(); // Antes que cualquier interrupción que publique eventos
+	perfil_init(); // Sólo en Debug
+	latencia_init(); // Sólo en Debug
+	plan_registrar(EV_ADC, tarea_adc);
+	plan_registrar(EV_TECLADO, tarea_teclado);
+	plan_registrar(EV_COMANDO, tarea_comando);
+	plan_registrar(EV_RUEDA, tarea_rueda);
+	plan_registrar(EV_SEGUNDO, tarea_segundo);
+	plan_registrar(EV_TELEMETRIA, tarea_telemetria);
+	plan_registrar(EV_VOLCADO, tarea_volcado);
+	plan_registrar(EV_DETENIDO, tarea_detenido);
+
+	sesion_init(SESION_DECIMACION, SESION_COMPACTAR);
+	metricas_iniciar(&metricas, CONTROL_PULSOS_POR_METRO, METRICAS_PESO_KG, 0);
+	arranque_marcar(ARRANQUE_MAIN);
 
 	cfg_gpio();
+	arranque_marcar(ARRANQUE_GPIO);
 	cfg_timers();
+	arranque_marcar(ARRANQUE_TIMERS);
+	cfg_dma(); // Antes que los periféricos que usan canales de GPDMA
 	cfg_uart2();
-	cfg_adc();
-	cfg_dma();
+	arranque_marcar(ARRANQUE_UART);
 
-	for (uint8_t i = 0; i < 10; i++)
-		buff[i] = 0;
+	pulso_init();
+	rueda_armar(&timer_diferida, DIFERIDA_TICKS, 0, vencer_diferida, NULL);
+	arranque_marcar(ARRANQUE_LISTO);
 
-	while (1);
+	while (1)
+		plan_ejecutar();
 
     return 0;
 }
@@ -119,7 +216,8 @@ int main(void)
  * 			Se configuran P2.0-3 como outputs representando
  * 			las filas del teclado matricial.
  * 			Se configuran P2.4-7 como inputs representando
- * 			las columnas del teclado matricial.
+ * 			las columnas del teclado matricial, que se barre
+ * 			periódicamente desde el RIT.
  */
 void cfg_gpio(void)
 {
@@ -171,11 +269,9 @@ void cfg_gpio(void)
 	GPIO_SetDir(PORT(2), 0xf, OUTPUT);
 	GPIO_SetDir(PORT(2), (0xf << 4), INPUT);
 
-	// Habilitación de interrupciones por GPIO2
-	FIO_IntCmd(PORT(2), (0xf << 4), FALLING);
-	FIO_ClearInt(PORT(2), (0xf << 4));
-
-	NVIC_EnableIRQ(EINT3_IRQn);
+	// Barrido periódico del teclado por RIT, con repetición para 'E' y 'F'
+	teclado_init(TECLADO_MUESTRAS);
+	teclado_repeticion(BIT(12) | BIT(14), 500, 150);
 
 	/****************************************
 	 *								        *
@@ -191,203 +287,319 @@ void cfg_gpio(void)
 }
 
 /**
- * @brief Handler para las interrupciones por teclado matricial.
- *
- * @details Se deshabilitan las interrupciones por EINT3 y se
- * 			almacena una copia de la lectura del puerto 2.
- * 			Se implementa un antirrebote generado por software.
- * 			Si luego del retardo por software la lectura del
- * 			puerto 2 es la misma (la tecla sigue presionada), se
- * 			interpreta como una pulsación válida y se actúa en
- * 			base a la tecla presionada.
- * 			Finalmente, se limpian las flags de interrupciones y se
- * 			rehabilitan las interrupciones por EINT3.
+ * @brief Handler del RIT, que barre el teclado matricial.
  */
-void EINT3_IRQHandler(void)
+void RIT_IRQHandler(void)
 {
-	NVIC_DisableIRQ(EINT3_IRQn);
+	PERFIL_ENTRAR(PERFIL_RIT);
 
-	p2aux = GPIO_ReadValue(PORT(2)) & 0xf0;
+	if (RIT_GetIntStatus(LPC_RIT) == SET) // La lectura limpia el flag
+		if (teclado_rit_irq())
+			plan_publicar(EV_TECLADO);
 
-	delay();
+	PERFIL_SALIR(PERFIL_RIT);
+}
 
-	if (((GPIO_ReadValue(PORT(2)) & 0xf0) - p2aux) == 0)
-	{
-		uint8_t key = get_pressed_key();
-		uint8_t key_hex = keys_hex[key];
+/**
+ * @brief Tarea que vacía la cola de eventos del teclado.
+ */
+void tarea_teclado(void)
+{
+	teclado_evento_t ev;
 
-		FIO_HalfWordClearValue(PORT(0), LOWER, 0xff);
-		FIO_HalfWordSetValue(PORT(0), LOWER, key_hex);
+	while (teclado_leer(&ev))
+		procesar_tecla(&ev);
+}
 
-		if (key_hex == 0x77) // Si apreté 'A', enciendo la cinta
-			on = 1;
+/**
+ * @brief Esta función actúa en base a la tecla presionada. Se
+ * 		  llama desde tarea_teclado por cada evento que saca de
+ * 		  la cola del teclado.
+ *
+ * @details Se actúa ante presiones y repeticiones (sólo 'E' y 'F'
+ * 			tienen repetición, por lo que mantenerlas presionadas
+ * 			sube o baja la velocidad de a un paso).
+ * 			'D' funciona además como modificador: mientras está
+ * 			presionada, las demás teclas forman acordes (ver
+ * 			procesar_acorde). Por eso su acción propia se ejecuta al
+ * 			soltarla, y sólo si no se usó en un acorde. El resto de
+ * 			las liberaciones se ignoran.
+ */
+void procesar_tecla(const teclado_evento_t *ev)
+{
+	static uint8_t acorde = 0; // Flag para indicar que 'D' se usó como modificador
 
-		if (on) // Sólo tomo inputs si la cinta está encendida
-		{
-			switch (key_hex)
-			{
-				case 0x77: // 'A' = Habilitamos PWM
-				{
-					cfg_pwm();
+	if (ev->tipo == TECLADO_LIBERACION)
+	{
+		if (on && (ev->tecla == TECLA_D) && !acorde) // 'D' = Comenzar a trackear rendimiento
+			iniciar_seguimiento();
 
-					LPC_PWM1->TCR = (1<<0) | (1<<3); //enable counters and PWM Mode
+		return;
+	}
 
-					break;
-				}
+	uint8_t key = ev->tecla;
+	uint8_t key_hex = keys_hex[key];
 
-				case 0x7c: // 'B' = Setear velocidad ingresada
-				{
-					uint8_t aux = vel_digits[0]*10 + vel_digits[1];
+	FIO_HalfWordClearValue(PORT(0), LOWER, 0xff);
+	FIO_HalfWordSetValue(PORT(0), LOWER, key_hex);
 
-					if (aux <= MAX_SPEED)
-					{
-						velocidad = aux;
+	uint8_t apagada = !on;
 
-						set_vel(velocidad);
+	if (key_hex == 0x77) // Si apreté 'A', enciendo la cinta
+		on = 1;
 
-						vel_index = 0;
-					}
+	if (on && (key == TECLA_D))
+		acorde = 0; // Se actúa al soltarla
+	else if (on && (teclado_estado() & BIT(TECLA_D)))
+	{
+		acorde = 1;
 
-					break;
-				}
+		if (ev->tipo == TECLADO_PRESION)
+			procesar_acorde(key);
+	}
+	else if (on) // Sólo tomo inputs si la cinta está encendida
+	{
+		switch (key_hex)
+		{
+			case 0x77: // 'A' = Habilitamos PWM
+			{
+				if (apagada) // Encendida, 'A' no hace nada
+					encender();
 
-				case 0x39: // 'C' = Resetear y apagar
-				{
-					stop();
+				break;
+			}
 
-					distancia = velocidad * tiempo_s * 0.28;
+			case 0x7c: // 'B' = Setear velocidad ingresada
+			{
+				// 1 o 2 dígitos: Km/h enteros; 3 dígitos: el último es la décima
+				uint32_t aux = 0;
 
-					DMASrc_Buffer[0] = ppm;
-					DMASrc_Buffer[1] = velocidad;
-					DMASrc_Buffer[2] = temperatura;
-					DMASrc_Buffer[3] = distancia;
-					DMASrc_Buffer[4] = tiempo_s;
+				for (uint8_t i = 0; i < vel_index; i++)
+					aux = (aux * 10) + vel_digits[i];
 
-					on = 0;
-					vel_index = 0;
+				if (vel_index < VEL_DIGITOS)
+					aux *= 10;
 
-					GPDMA_ChannelCmd(0, ENABLE);
+				if (vel_index && (aux <= MAX_SPEED))
+				{
+					velocidad = aux;
 
-					break;
+					set_vel(velocidad);
 				}
 
-				case 0x5e: // 'D' = Comenzar a trackear rendimiento
-				{
-					TIM_Cmd(LPC_TIM3, ENABLE);
-					TIM_Cmd(LPC_TIM1, ENABLE);
-					TIM_Cmd(LPC_TIM0, ENABLE);
-					TIM_Cmd(LPC_TIM2, ENABLE);
+				vel_index = 0;
 
-					UART_TxCmd(LPC_UART2, ENABLE); // Habilita transmisión
+				break;
+			}
 
-					break;
-				}
+			case 0x39: // 'C' = Resetear y apagar
+			{
+				stop();
+				cerrar_sesion();
 
-				case 0x79: // 'E' = Velocidad++
-				{
-					if(velocidad < MAX_SPEED)
-					{
-						velocidad++;
+				break;
+			}
 
-						set_vel(velocidad);
-					}
+			case 0x79: // 'E' = Velocidad++ (de a 0.1[Km/h])
+			{
+				if(velocidad < MAX_SPEED)
+				{
+					velocidad++;
 
-					break;
+					set_vel(velocidad);
 				}
 
-				case 0x71: // 'F' = Velocidad--
-				{
-					if(velocidad > 0)
-					{
-						velocidad--;
+				break;
+			}
 
-						set_vel(velocidad);
-					}
+			case 0x71: // 'F' = Velocidad-- (de a 0.1[Km/h])
+			{
+				if(velocidad > 0)
+				{
+					velocidad--;
 
-					break;
+					set_vel(velocidad);
 				}
 
-				default: // Cualquier número = Velocidad a setear
-				{
-					if (vel_index < 2)
-					{
-						vel_digits[vel_index] = keys_dec[key]; // Almaceno el dígito ingresado
+				break;
+			}
 
-						vel_index++;
-					}
+			default: // Cualquier número = Velocidad a setear
+			{
+				if (vel_index < VEL_DIGITOS)
+				{
+					vel_digits[vel_index] = keys_dec[key]; // Almaceno el dígito ingresado
 
-					break;
+					vel_index++;
 				}
+
+				break;
 			}
 		}
 	}
+}
 
-	FIO_ClearInt(PORT(2), (0xf << 4));
+/**
+ * @brief Esta función enciende la cinta a la velocidad inicial.
+ *
+ * @details Si se enciende mientras frena, el PWM y el lazo siguen
+ * 			activos: la rampa sigue desde la referencia actual y la
+ * 			cinta se queda en la velocidad que tenía, sin volver a 0.
+ */
+void encender(void)
+{
+	uint32_t actual = rampa_actual(&rampa); // [m/h]
+
+	rueda_cancelar(&timer_reposo);
+	cambiar_reloj(RELOJ_COMPLETO);
+
+	cfg_diferida(); // Por si se enciende antes de que venza timer_diferida
+
+	on = 1;
+	deteniendo = 0;
+
+	if (actual)
+		velocidad = (actual + (PF_MH_POR_DECIMA / 2)) / PF_MH_POR_DECIMA;
+	else
+	{
+		cfg_pwm();
+
+		rampa_reiniciar(&rampa, 0); // Arranca desde la cinta quieta
+	}
+
+	set_vel(velocidad);
+	control_cmd(ENABLE); // Velocidad a lazo cerrado
 
-	NVIC_EnableIRQ(EINT3_IRQn);
+	motor_cmd(ENABLE);
 }
 
 /**
- * @brief Esta función representa un pequeño delay para antirrebote.
+ * @brief Esta función cierra la sesión y vuelca la grabación por
+ * 		  UART2. Se llama después de stop().
  */
-void delay(void)
+void cerrar_sesion(void)
 {
-	for (uint32_t i = 0; i < TIMER; i++);
+	distancia = metricas_distancia_m(&metricas);
+
+	on = 0;
+	vel_index = 0;
+
+	programa_cancelar();
+	crucero_cancelar(&crucero);
+
+	latencia_reportar(); // Sólo en Debug
+	sesion_volcar(); // Grabación completa por UART2
+	perfil_volcar(); // En Debug, sigue la duración de los handlers
 }
 
 /**
- * @brief Esta función devuelve la coordenada de la tecla pulsada
- * 		  en el teclado matricial de 4x4.
+ * @brief Esta función actúa ante una tecla presionada mientras
+ * 		  se mantiene 'D'.
  *
- * @details Para obtener las filas, se envía un '1' por cada fila
- * 			y se analiza el nibble superior del primer byte del
- * 			puerto 2. Si la fila es la correcta, el '1' debería
- * 			llegar y todas las columnas deberían estar en '1',
- * 			por lo que si el nibble superior del primer byte
- * 			es 0xf, estamos en la fila correcta.
- * 			Para obtener la columna, recorremos la copia almacenada
- * 			hasta encontrar un '0' en alguno de los bits del nibble
- * 			inferior del primer byte.
- * 			Teniendo la fila y la columna, se devuelve el valor de
- * 			la tecla resultante mediante la ecuación:
- * 			key = (4 * row) + column
- */
-uint8_t get_pressed_key(void)
-{
-	uint8_t row = 0;
-
-	for (uint8_t i = 0; i < ROWS; i++)
-	{
-		GPIO_SetValue(PORT(2), BIT(i));
+ * @details 'D' + dígito 1..9 elige un programa de entrenamiento (ver
+ * 			programa.c) y comienza a trackear el rendimiento.
+ * 			'D' + 'E' saltea el segmento en curso.
+ * 			'D' + 'F' pausa o reanuda el programa.
+ * 			'D' + 'B' activa el modo crucero en la zona de frecuencia
+ * 			cardíaca ingresada antes con un dígito (1..5, ver
+ * 			crucero.c); sin dígito, lo desactiva.
+ * 			Programa y crucero se excluyen: activar uno cancela el otro.
+ */
+void procesar_acorde(uint8_t key)
+{
+	uint8_t key_hex = keys_hex[key];
 
-		if ((FIO_ByteReadValue(PORT(2), 0) & 0xf0) == 0xf0)
+	if (key_hex == 0x79) // 'E'
+	{
+		if (programa_saltar())
+			aplicar_programa();
+	}
+	else if (key_hex == 0x71) // 'F'
+		programa_pausa();
+	else if (key_hex == 0x7c) // 'B'
+	{
+		if (vel_index == 1)
 		{
-			row = i;
-
-			GPIO_ClearValue(PORT(2), BIT(i));
+			iniciar_seguimiento();
 
-			break;
+			programa_cancelar();
+			crucero_iniciar(&crucero, vel_digits[0], MAX_SPEED);
 		}
+		else
+			crucero_cancelar(&crucero);
 
-		GPIO_ClearValue(PORT(2), BIT(i));
+		vel_index = 0;
 	}
+	else if ((keys_dec[key] >= 1) && (keys_dec[key] <= programa_cantidad()))
+	{
+		iniciar_seguimiento();
 
-	uint8_t col = 0;
+		crucero_cancelar(&crucero);
+		programa_iniciar(keys_dec[key] - 1);
+		aplicar_programa();
+	}
+}
 
-	for (uint8_t i = 0; i < COLUMNS; i++)
-		if (!(p2aux & BIT((4 + i))))
-		{
-			col = i;
+/**
+ * @brief Esta función comienza a trackear el rendimiento: una
+ * 		  sesión nueva (grabación y métricas), frecuencia cardíaca,
+ * 		  ADC y telemetría.
+ */
+void iniciar_seguimiento(void)
+{
+	sesion_iniciar();
+	metricas_iniciar(&metricas, CONTROL_PULSOS_POR_METRO, METRICAS_PESO_KG, control_pulsos());
+	publicar_sesion();
+
+	TIM_Cmd(LPC_TIM3, ENABLE);
+	adq_cmd(ENABLE); // Conversiones del ADC en ráfaga
+	rueda_armar(&timer_telemetria, telemetria_periodo, telemetria_periodo, vencer_publicar, (void *)EV_TELEMETRIA);
+	rueda_armar(&timer_segundo, TIEMPO_TICKS_POR_S, TIEMPO_TICKS_POR_S, vencer_segundo, NULL);
+}
 
-			break;
-		}
+/**
+ * @brief Esta función aplica la velocidad del segmento en curso
+ * 		  del programa. Un ajuste manual ('B', 'E', 'F') vale hasta
+ * 		  el próximo cambio de segmento.
+ */
+void aplicar_programa(void)
+{
+	velocidad = programa_velocidad();
 
-	return ((4 * row) + col);
+	set_vel(velocidad);
 }
 
 /**
- * @brief Esta función configura el timer 1 en modo capture para
- * 		  tomar mediciones para el cálculo de la frecuencia cardíaca.
+ * @brief Esta función corre el lazo externo del modo crucero.
+ *
+ * @details La antigüedad del último latido se mide contra el
+ * 			contador de TIMER3, que es la misma base de tiempo de
+ * 			las capturas: así se detecta que se perdió la señal
+ * 			aunque pulso_ppm siga devolviendo el último valor. La
+ * 			frecuencia y la captura salen de la misma publicación
+ * 			(ver estado.h), así que corresponden al mismo latido.
+ */
+void aplicar_crucero(const estado_pulso_t *pulso)
+{
+	uint32_t edad_s = (tiempo_contador(LPC_TIM3) - pulso->t_ultimo) / (1000000 / PULSO_TICK_US);
+	uint32_t v = crucero_tick(&crucero, pulso->ppm, edad_s, velocidad);
+
+	if (v != velocidad)
+	{
+		velocidad = v;
+
+		set_vel(velocidad);
+	}
+}
+
+/**
+ * @brief Esta función configura el timer 3 en modo capture para
+ * 		  tomar mediciones para el cálculo de la frecuencia cardíaca,
+ * 		  y la base de tiempo sobre el timer 1.
+ *
+ * @details Los trabajos periódicos (tick de 1[s], telemetría) son
+ * 			timers de la rueda (ver rueda.h), que avanza con el tick de
+ * 			la base de tiempo.
  */
 void cfg_timers(void)
 {
@@ -401,13 +613,8 @@ void cfg_timers(void)
 
 	PINSEL_ConfigPin(&cfg);
 
-	/* 100[MHz] por default
-	   Queremos que el timer funcione con una precision de 0.1[s]
-	   Configurar el prescaler para 0.1[s] >> 100000[us] */
-
 	TIM_TIMERCFG_Type config;
 	TIM_CAPTURECFG_Type config_capture;
-	TIM_MATCHCFG_Type config_match;
 
 	/****************************************
 	 *								        *
@@ -415,7 +622,7 @@ void cfg_timers(void)
 	 *							        	*
 	 ****************************************/
 	config.PrescaleOption = TIM_PRESCALE_USVAL;
-	config.PrescaleValue = 100000; // 1[ms]
+	config.PrescaleValue = PULSO_TICK_US; // 100[us], desborda cada ~119[h]
 
 	config_capture.CaptureChannel = 1;
 	config_capture.RisingEdge = DISABLE;
@@ -427,57 +634,14 @@ void cfg_timers(void)
 
 	/****************************************
 	 *								        *
-	 *       CONFIGURACIÓN DE TIMER 0       *	>>	PARA COMUNICACIÓN UART
+	 *       CONFIGURACIÓN DE TIMER 1       *	>>	BASE DE TIEMPO Y RUEDA DE TIMERS
 	 *							        	*
 	 ****************************************/
-	config_match.MatchChannel = 0;
-	config_match.IntOnMatch = ENABLE;
-	config_match.StopOnMatch = DISABLE;
-	config_match.ResetOnMatch = ENABLE;
-	config_match.ExtMatchOutputType = TIM_EXTMATCH_NOTHING;
-	config_match.MatchValue = 100; // Hacemos match cada 10[s]
-
-	TIM_Init(LPC_TIM0, TIM_TIMER_MODE, &config);
-	TIM_ConfigMatch(LPC_TIM0, &config_match);
+	tiempo_init(); // Reemplaza a TIMER0 (telemetría) y TIMER2 (tiempo), que quedan libres
+	rueda_init(tiempo_ticks());
 
-	/****************************************
-	 *								        *
-	 *       CONFIGURACIÓN DE TIMER 1       *	>>	PARA MUESTREO ADC
-	 *							        	*
-	 ****************************************/
-	config_match.MatchChannel = 0;
-	config_match.IntOnMatch = DISABLE;
-	config_match.StopOnMatch = DISABLE;
-	config_match.ResetOnMatch = ENABLE;
-	config_match.ExtMatchOutputType = TIM_EXTMATCH_TOGGLE;
-	config_match.MatchValue = 149; // Hacemos match cada 15[s]
-
-	TIM_Init(LPC_TIM1, TIM_TIMER_MODE, &config);
-	TIM_ConfigMatch(LPC_TIM1, &config_match);
-
-	/****************************************
-	 *								        *
-	 *       CONFIGURACIÓN DE TIMER 2       *	>>	PARA TRACKEAR TIEMPO
-	 *							        	*
-	 ****************************************/
-	config_match.MatchChannel = 0;
-	config_match.IntOnMatch = ENABLE;
-	config_match.StopOnMatch = DISABLE;
-	config_match.ResetOnMatch = ENABLE;
-	config_match.ExtMatchOutputType = TIM_EXTMATCH_NOTHING;
-	config_match.MatchValue = 9; // Hacemos match cada 1[s]
-
-	TIM_Init(LPC_TIM2, TIM_TIMER_MODE, &config);
-	TIM_ConfigMatch(LPC_TIM2, &config_match);
-
-	// Habilitación de interrupciones por timers
-	NVIC_EnableIRQ(TIMER0_IRQn);
 	NVIC_EnableIRQ(TIMER3_IRQn);
-	NVIC_EnableIRQ(TIMER2_IRQn);
-
-	//Seteamos mayor prioridad al match que al capture
-	NVIC_SetPriority(TIMER0_IRQn, 5);
-	NVIC_SetPriority(TIMER3_IRQn, 10);
+	NVIC_SetPriority(TIMER3_IRQn, 3); // Por encima de IAP_PRIORIDAD, ver iap.h
 }
 
 /**
@@ -499,291 +663,908 @@ void cfg_uart2(void)
 
 	PINSEL_ConfigPin(&cfg);
 
+	cfg_uart2_linea();
+
+	uart_tx_init(); // Transmisión de tramas por GPDMA
+	uart_rx_init(); // Recepción de comandos
+}
+
+/**
+ * @brief Esta función configura el baud rate y los FIFOs de UART2.
+ * 		  El divisor depende de PCLK, así que se repite en cada cambio
+ * 		  de perfil de reloj (ver reescalar_perifericos).
+ *
+ * @details UART_Init vacía los FIFOs y deshabilita la transmisión y
+ * 			las interrupciones. La transmisión se vuelve a habilitar
+ * 			siempre: sólo salen tramas completas por GPDMA, y las
+ * 			respuestas a comandos llegan antes que el seguimiento.
+ */
+void cfg_uart2_linea(void)
+{
 	UART_CFG_Type UARTConfigStruct;
 	UART_FIFO_CFG_Type UARTFIFOConfigStruct;
 
 	UART_ConfigStructInit(&UARTConfigStruct); // Configuración por defecto
 	UART_Init(LPC_UART2, &UARTConfigStruct);
 	UART_FIFOConfigStructInit(&UARTFIFOConfigStruct);
+	UARTFIFOConfigStruct.FIFO_DMAMode = ENABLE; // Requerido para transmitir tramas por GPDMA
+	UARTFIFOConfigStruct.FIFO_Level = UART_FIFO_TRGLEV2; // RDA cada 8 bytes, el resto por CTI
 	UART_FIFOConfig(LPC_UART2, &UARTFIFOConfigStruct);
+	UART_TxCmd(LPC_UART2, ENABLE);
 }
 
-void TIMER2_IRQHandler(void)
+/**
+ * @brief Handler para las interrupciones de UART2.
+ *
+ * @details La transmisión va por GPDMA, así que sólo interrumpe
+ * 			la recepción: ante RDA (nivel de disparo), CTI (timeout de
+ * 			caracter) o RLS (error de línea) se vacía el FIFO y, si
+ * 			se completó alguna trama, se publica el evento para
+ * 			procesarla en tarea_comando.
+ * 			Queda en la flash, como el driver de UART2 que usa: se
+ * 			enmascara durante el IAP y la cota de un comando
+ * 			(COMANDO_PLAZO_US) es de milisegundos, así que los estados
+ * 			de espera de la flash no pesan.
+ */
+void UART2_IRQHandler(void)
 {
-	tiempo_s++;
+	PERFIL_ENTRAR(PERFIL_UART2);
+
+	uint32_t intid = UART_GetIntId(LPC_UART2) & UART_IIR_INTID_MASK;
+
+	if ((intid == UART_IIR_INTID_RDA) || (intid == UART_IIR_INTID_CTI) || (intid == UART_IIR_INTID_RLS))
+	{
+		if (uart_rx_irq())
+			plan_publicar(EV_COMANDO);
+	}
 
-	TIM_ClearIntCapturePending(LPC_TIM2, TIM_MR0_INT);
+	PERFIL_SALIR(PERFIL_UART2);
 }
 
 /**
- * @brief Handler para las interrupciones por capture en CAP1.1.
+ * @brief Tarea que procesa las tramas de comando recibidas por UART2.
+ *
+ * @details Las tramas inválidas (COBS, CRC, versión) o de otro tipo
+ * 			se descartan sin respuesta; el receptor las reintenta al no
+ * 			recibir la respuesta con su seq.
  */
-void TIMER3_IRQHandler(void)
+void tarea_comando(void)
 {
-	uint8_t acum = 0;
+	uint8_t rx[UART_RX_TRAMA_SIZE];
+	uint8_t payload[TRAMA_PAYLOAD_MAX];
+	uint32_t len, plen, t_llegada;
+	uint8_t tipo, seq;
 
-	t_anterior = t_actual;
-	t_actual = TIM_GetCaptureValue(LPC_TIM3, 1);
-	t_final = t_actual - t_anterior;
+	while (uart_rx_trama(rx, &len, &t_llegada))
+	{
+		if ((trama_abrir(rx, len, &tipo, &seq, payload, &plen) == TRAMA_OK) && (tipo == TRAMA_TIPO_COMANDO) && plen)
+			procesar_comando(seq, payload, plen, t_llegada);
+		else
+			cmd_invalidos++;
+	}
+}
 
-	if(t_final > 1)
+/**
+ * @brief Esta función ejecuta un comando recibido por UART2 y
+ * 		  envía la respuesta (ver trama.h).
+ *
+ * @details Los comandos hacen lo mismo que las teclas
+ * 			equivalentes. La latencia se mide desde que llegó el
+ * 			delimitador de la trama (UART2_IRQHandler) hasta que el
+ * 			comando actuó: la referencia de velocidad cambió (la rampa
+ * 			la empieza a seguir en el próximo paso, antes de 1[ms]) o
+ * 			el timer de telemetría quedó rearmado. Un comando que no
+ * 			cambia nada (ARRANCAR con el seguimiento en curso,
+ * 			TELEMETRIA sin seguimiento) no cuenta. EV_COMANDO es el evento de
+ * 			mayor prioridad después del ADC y el teclado, así que la
+ * 			espera está acotada por la tarea más larga que pudiera
+ * 			estar en curso (la programación de una página de la
+ * 			bitácora). Los comandos que superan COMANDO_PLAZO_US se
+ * 			cuentan aparte.
+ * 			Al detener, la latencia se toma al frenar la cinta, antes
+ * 			de cerrar la sesión.
+ * 			PERFIL responde primero y después vuelca el perfil, que
+ * 			toma los buffers de transmisión libres.
+ */
+void procesar_comando(uint8_t seq, const uint8_t *payload, uint32_t len, uint32_t t_llegada)
+{
+	uint8_t cmd = payload[0];
+	uint8_t resultado = TRAMA_RESP_OK;
+	uint32_t actuacion = 0;
+
+	switch (cmd)
 	{
-		buff[t_index] = t_final;
+		case TRAMA_CMD_ARRANCAR: // 'A' + 'D'
+		{
+			if (!on)
+			{
+				encender();
+
+				actuacion = ciclos_leer();
+			}
+
+			if (!rueda_armado(&timer_telemetria)) // Un seguimiento en curso no se reinicia
+			{
+				iniciar_seguimiento();
+
+				if (!actuacion)
+					actuacion = ciclos_leer();
+			}
+
+			break;
+		}
+
+		case TRAMA_CMD_DETENER: // 'C'
+		{
+			if (on)
+			{
+				stop();
+
+				actuacion = ciclos_leer();
 
-		if(t_index == (SIZEB-1))
+				cerrar_sesion();
+			}
+			else
+				resultado = TRAMA_RESP_APAGADA;
+
+			break;
+		}
+
+		case TRAMA_CMD_VELOCIDAD:
 		{
-			t_index = 0;
+			uint32_t v = (len >= 3) ? (payload[1] | (payload[2] << 8)) : (MAX_SPEED + 1);
+
+			if (!on)
+				resultado = TRAMA_RESP_APAGADA;
+			else if (v > MAX_SPEED)
+				resultado = TRAMA_RESP_ARGUMENTO;
+			else
+			{
+				velocidad = v;
 
-			if(t_flag == 0)
-				t_flag = 1; // Completa la primera vuelta
+				set_vel(velocidad);
+
+				actuacion = ciclos_leer();
+			}
+
+			break;
 		}
-		else
-			t_index++;
 
-		for (uint8_t i = 0; i < SIZEB; i++)
-			acum += buff[i];
+		case TRAMA_CMD_ESTADO: // Los datos se arman abajo
+			break;
+
+		case TRAMA_CMD_TELEMETRIA:
+		{
+			if ((len < 2) || (payload[1] < TELEMETRIA_PERIODO_MIN) || (payload[1] > TELEMETRIA_PERIODO_MAX))
+				resultado = TRAMA_RESP_ARGUMENTO;
+			else
+			{
+				telemetria_periodo = (payload[1] * TIEMPO_TICKS_POR_S) / 10;
 
-		if(t_flag == 0)
-			t_resultado = acum / (t_index + 1);
-		else
-			t_resultado = acum / SIZEB;
+				if (rueda_armado(&timer_telemetria)) // Si no, se aplica al iniciar el seguimiento
+				{
+					rueda_armar(&timer_telemetria, telemetria_periodo, telemetria_periodo, vencer_publicar, (void *)EV_TELEMETRIA);
+
+					actuacion = ciclos_leer();
+				}
+			}
+
+			break;
+		}
+
+		case TRAMA_CMD_PERFIL: // El volcado sale después de la respuesta
+		{
+			if (!PERFIL_HABILITADO)
+				resultado = TRAMA_RESP_DESCONOCIDO; // Release: no hay mediciones
 
-		ppm = 600 / t_resultado;
+			break;
+		}
+
+		default:
+		{
+			resultado = TRAMA_RESP_DESCONOCIDO;
+
+			break;
+		}
+	}
+
+	if (actuacion)
+	{
+		// Con el CCLK de la actuación: desde RELOJ_REPOSO, ARRANCAR subestima el tramo a 24[MHz]
+		uint32_t latencia = (actuacion - t_llegada) / (SystemCoreClock / 1000000); // [us]
+
+		if (latencia > cmd_latencia_max)
+			cmd_latencia_max = latencia;
+
+		if (latencia > COMANDO_PLAZO_US)
+			cmd_fuera_de_plazo++;
 	}
 
-	TIM_ClearIntCapturePending(LPC_TIM3, TIM_CR1_INT);
+	if ((cmd == TRAMA_CMD_ESTADO) && (resultado == TRAMA_RESP_OK))
+	{
+		trama_estado_t e;
+		estado_foto_t f;
+		uint8_t datos[TRAMA_ESTADO_SIZE];
+
+		estado_leer(&f);
+
+		e.encendida = on;
+		e.modo = programa_activo() ? 1 : (crucero_activo(&crucero) ? 2 : 0);
+		e.velocidad = velocidad;
+		e.velocidad_medida = f.control.velocidad_mh;
+		e.distancia = metricas_distancia_m(&metricas);
+		e.tiempo_s = metricas.tiempo_s;
+		e.energia = metricas_energia_kcal(&metricas);
+		e.ppm_media = metricas_ppm_media(&metricas);
+		e.latencia_max = saturar16(cmd_latencia_max);
+		e.reloj_mhz = SystemCoreClock / 1000000;
+		e.transicion_max_us = saturar16(reloj_transicion_max_us());
+
+		for (uint8_t i = 0; i < TRAMA_ESTADO_ZONAS; i++)
+			e.tiempo_zona[i] = saturar16(metricas.tiempo_zona[i]);
+
+		e.plan_latencia_max_us = saturar16(plan_latencia_max_us());
+		e.teclado_ciclos_max = saturar16(teclado_ciclos_max());
+		e.pulso_rechazados = saturar16(pulso_rechazados());
+		e.estado_reintentos = saturar16(estado_reintentos());
+		e.uart_rx_descartadas = saturar16(uart_rx_descartadas());
+		e.uart_rx_errores = saturar16(uart_rx_errores());
+		e.uart_tx_descartadas = saturar16(uart_tx_tramas_descartadas());
+		e.uart_tx_tramas_max = uart_tx_tramas_max();
+		e.cmd_invalidos = saturar16(cmd_invalidos);
+		e.cmd_fuera_de_plazo = saturar16(cmd_fuera_de_plazo);
+		e.recuperacion_us = recuperacion_us;
+
+		trama_estado_serializar(&e, datos);
+
+		responder(seq, cmd, resultado, datos, TRAMA_ESTADO_SIZE);
+	}
+	else
+		responder(seq, cmd, resultado, NULL, 0);
+
+	if ((cmd == TRAMA_CMD_PERFIL) && (resultado == TRAMA_RESP_OK) && !perfil_volcando())
+		perfil_volcar(); // Sigue en tarea_volcado a medida que se liberan los buffers
 }
 
 /**
- * @brief Handler para las interrupciones por match en MAT0.0.
- *
- * @details	Se envía por UART la información de las pulsaciones
- * 			por minuto, la velocidad y los kilómetros por hora.
- *
+ * @brief Esta función envía una trama de respuesta con el seq del
+ * 		  comando. Si no hay buffer de trama libre, se pierde (el
+ * 		  receptor reintenta).
  */
-void TIMER0_IRQHandler(void)
+void responder(uint8_t seq, uint8_t cmd, uint8_t resultado, const uint8_t *datos, uint32_t len)
 {
-	uint8_t msg1[] = "-------------------------\n\rPPM = ";
-	uint8_t msg2[] = "\n\rVEL = ";
-	uint8_t msg3[] = "[Km/h]";
-	uint8_t msg4[] = "\n\rTEMP = ";
-	uint8_t msg5[] = "[ºC]\n\r";
+	uint8_t *trama = uart_tx_trama_obtener();
 
-	// PPM
-	char unidades_ppm = get_digit(ppm, UNIDAD);
-	char decenas_ppm = 0;
-	char centena_ppm = 0;
+	if (trama == NULL)
+		return;
 
-	// VEL
-	char unidades_vel = get_digit(velocidad, UNIDAD);
-	char decenas_vel = get_digit(velocidad, DECENA);
+	uint8_t payload[TRAMA_PAYLOAD_MAX];
 
-	// TEMP
-	char unidades_temp = get_digit(temperatura, UNIDAD);
-	char decenas_temp = get_digit(temperatura, DECENA);
+	payload[0] = cmd;
+	payload[1] = resultado;
 
-	uint16_t temp_aux = temperatura * 100;
+	for (uint32_t i = 0; i < len; i++)
+		payload[TRAMA_RESP_ENCABEZADO + i] = datos[i];
 
-	temp_aux -= ((decenas_temp * 100) + (unidades_temp * 10));
+	uart_tx_trama_enviar(trama, trama_armar(trama, TRAMA_TIPO_RESPUESTA, seq, payload, TRAMA_RESP_ENCABEZADO + len));
+}
 
-	char decimal_temp = get_digit(temp_aux, UNIDAD);
+/**
+ * @brief Satura un contador a 16 bits para la respuesta de estado.
+ */
+uint16_t saturar16(uint32_t x)
+{
+	return (x > 0xffff) ? 0xffff : x;
+}
 
-	// Transmisión de datos
-	UART_Send(LPC_UART2, msg1, sizeof(msg1), BLOCKING);
+/**
+ * @brief Peor espera entre la publicación de un evento y su handler,
+ * 		  sobre todos los eventos del planificador [us].
+ *
+ * @details Las latencias están en ciclos; se convierten con el CCLK
+ * 			actual, así que después de un cambio de perfil de reloj
+ * 			el valor es aproximado.
+ */
+uint32_t plan_latencia_max_us(void)
+{
+	plan_stats_t s;
+	uint32_t peor = 0;
 
-	if (ppm >= 100)
+	for (uint8_t ev = 0; ev < EV_CANTIDAD; ev++)
 	{
-		centena_ppm = get_digit(ppm, CENTENA);
-		decenas_ppm = get_digit((ppm % 100), DECENA);
-	}
-	else
-		decenas_ppm = get_digit(ppm, DECENA);
+		plan_estadisticas((evento_t)ev, &s);
 
-	if (centena_ppm != '0')
-	{
-		UART_SendByte(LPC_UART2, centena_ppm);
-		UART_SendByte(LPC_UART2, decenas_ppm);
+		if (s.latencia_max > peor)
+			peor = s.latencia_max;
 	}
-	else if (decenas_ppm != '0')
-		UART_SendByte(LPC_UART2, decenas_ppm);
 
-	UART_SendByte(LPC_UART2, unidades_ppm);
+	return peor / (SystemCoreClock / 1000000);
+}
 
-	UART_Send(LPC_UART2, msg2, sizeof(msg2), BLOCKING);
+/**
+ * @brief Handler de TIMER1, la base de tiempo (ver tiempo.c).
+ *
+ * @details Cuenta los desbordes del TC y, en cada tick de la rueda
+ * 			de timers, publica el evento para avanzarla a nivel de
+ * 			tarea.
+ */
+void TIMER1_IRQHandler(void)
+{
+	PERFIL_ENTRAR(PERFIL_TIMER1);
 
-	if (decenas_vel != '0')
-			UART_SendByte(LPC_UART2, decenas_vel);
+	if (tiempo_irq())
+		plan_publicar(EV_RUEDA);
 
-	UART_SendByte(LPC_UART2, unidades_vel);
+	PERFIL_SALIR(PERFIL_TIMER1);
+}
 
-	UART_Send(LPC_UART2, msg3, sizeof(msg3), BLOCKING);
-	UART_Send(LPC_UART2, msg4, sizeof(msg4), BLOCKING);
+/**
+ * @brief Tarea que avanza la rueda de timers hasta el tick actual.
+ *
+ * @details Si la tarea se demoró más de un tick, se recuperan todos
+ * 			los pendientes, así que ningún timer se pierde ni se
+ * 			corre. Los callbacks corren acá y sólo publican eventos.
+ */
+void tarea_rueda(void)
+{
+	while (rueda_ahora() != tiempo_ticks())
+		rueda_avanzar();
 
-	if (decenas_temp != '0')
-		UART_SendByte(LPC_UART2, decenas_temp);
+	latencia_medir(); // Sólo en Debug
+}
 
-	UART_SendByte(LPC_UART2, unidades_temp);
-	UART_SendByte(LPC_UART2, '.');
-	UART_SendByte(LPC_UART2, decimal_temp);
+/**
+ * @brief Callback del timer de 1[s] de la sesión.
+ */
+void vencer_segundo(void *arg)
+{
+	(void)arg;
 
-	UART_Send(LPC_UART2, msg5, sizeof(msg5), BLOCKING);
+	tiempo_s++;
 
-	TIM_ClearIntCapturePending(LPC_TIM0, TIM_MR0_INT);
+	plan_publicar(EV_SEGUNDO);
 }
 
 /**
- * @brief Esta función devuelve el dígito especificado
- * 		  por parámetro del número recibido.
+ * @brief Callback genérico: publica el evento pasado como argumento.
  */
-uint8_t get_digit(uint8_t num, uint8_t digit)
+void vencer_publicar(void *arg)
 {
-	uint8_t aux_u = num % 10;
-	uint8_t aux_d = ((num - aux_u) / 10);
+	plan_publicar((evento_t)(uint32_t)arg);
+}
 
-	switch (digit)
-	{
-		case UNIDAD:
-			return (aux_u + 48);
+/**
+ * @brief Handler para las interrupciones por capture en CAP3.1.
+ *
+ * @details Se entrega el valor de 32 bits capturado al estimador
+ * 			de frecuencia cardíaca (ver pulso.c), cuyo costo es
+ * 			constante por latido, y se publica el resultado en el
+ * 			bloque de estado.
+ */
+EN_RAM void TIMER3_IRQHandler(void)
+{
+	PERFIL_ENTRAR(PERFIL_TIMER3);
 
-		case DECENA:
-			return (aux_d + 48);
+	pulso_capturar(tiempo_captura(LPC_TIM3, 1));
 
-		default:
-			return (((num - (aux_d + aux_u)) / 100) + 48);
+	estado_pulso_t p = { pulso_ppm(), pulso_ppm_x10(), pulso_t_ultimo() };
+
+	estado_pulso_publicar(&p);
+
+	PERFIL_SALIR(PERFIL_TIMER3);
+}
+
+/**
+ * @brief Tarea del tick de 1[s]: avanza el programa de
+ * 		  entrenamiento o el modo crucero, integra las métricas de
+ * 		  la sesión y entrega el registro a la grabación de la
+ * 		  sesión y a la bitácora en flash.
+ */
+void tarea_segundo(void)
+{
+	trama_registro_t r;
+	estado_foto_t f;
+
+	estado_leer(&f);
+
+	if (programa_tick()) // Cambio de segmento justo en este tick
+		aplicar_programa();
+
+	if (crucero_activo(&crucero)) // Corrige cada CRUCERO_PERIODO_S
+		aplicar_crucero(&f.pulso);
+
+	metricas_tick(&metricas, control_pulsos(), f.pulso.ppm, adq_valor(CH_INCLINACION));
+
+	distancia = metricas_distancia_m(&metricas); // Recorrido real, medido por el encoder
+
+	publicar_sesion();
+
+	r.tiempo_s = tiempo_s;
+	r.ppm = (f.pulso.ppm > 0xff) ? 0xff : f.pulso.ppm;
+	r.velocidad = velocidad;
+	r.temperatura = temperatura;
+	r.distancia = (distancia > 0xffff) ? 0xffff : distancia;
+
+	sesion_tick(&r);
+	bitacora_agregar(&r); // Programa una página cada BITACORA_REGISTROS segundos
+}
+
+/**
+ * @brief Tarea que continúa el volcado de la sesión y, cuando
+ * 		  termina, el de las estadísticas de los handlers.
+ */
+void tarea_volcado(void)
+{
+	if (sesion_volcando())
+		sesion_volcar_continuar();
+	else
+		perfil_volcar_continuar();
+}
+
+/**
+ * @brief Tarea de telemetría, publicada por la rueda de timers cada 0.5[s]
+ * 		  (el período se cambia con TRAMA_CMD_TELEMETRIA).
+ *
+ * @details	Se arma una trama binaria de telemetría (ver trama.h) con
+ * 			las pulsaciones por minuto, la velocidad, la temperatura,
+ * 			la distancia, el tiempo y las métricas de la sesión
+ * 			(energía, ppm media y ritmo) en uno de los buffers de trama
+ * 			y se entrega al GPDMA, que lo copia al FIFO de UART2 sin
+ * 			intervención de la CPU. Mientras una trama está saliendo
+ * 			se puede armar la siguiente en el otro buffer; si ambos
+ * 			están ocupados, se saltea este reporte (el receptor lo
+ * 			detecta por el salto en el número de secuencia).
+ * 			Los campos salen de una sola foto del bloque de estado
+ * 			(ver estado.h), consistente aunque TIMER3 o el lazo de
+ * 			velocidad publiquen mientras se copia.
+ */
+void tarea_telemetria(void)
+{
+	static uint8_t seq = 0;
+
+	uint8_t *trama = uart_tx_trama_obtener();
+
+	if (trama != NULL)
+	{
+		trama_telemetria_t t;
+		estado_foto_t f;
+		uint8_t payload[TRAMA_TELEMETRIA_SIZE];
+
+		estado_leer(&f);
+
+		t.ppm_x10 = f.pulso.ppm_x10;
+		t.velocidad = f.sesion.velocidad;
+		t.temperatura = f.sesion.temperatura;
+		t.distancia = f.sesion.distancia;
+		t.tiempo_s = f.sesion.tiempo_s;
+		t.velocidad_medida = f.control.velocidad_mh;
+		t.error_velocidad = f.control.error_mh;
+		t.energia = f.sesion.energia;
+		t.ppm_media = f.sesion.ppm_media;
+		t.ritmo = (f.sesion.ritmo > 0xffff) ? 0xffff : f.sesion.ritmo;
+
+		trama_telemetria_serializar(&t, payload);
+
+		uart_tx_trama_enviar(trama, trama_armar(trama, TRAMA_TIPO_TELEMETRIA, seq, payload, TRAMA_TELEMETRIA_SIZE));
 	}
+
+	seq++;
 }
 
 /**
- * @brief Esta función configura el módulo de PWM con
- * 		  un período de 1[ms] e inicializándolo con
- * 		  una velocad de 1[Km/h].
+ * @brief Esta función configura el módulo de PWM a
+ * 		  MOTOR_FRECUENCIA (ver motor.c) e inicializa
+ * 		  la velocidad en 1[Km/h].
  */
 void cfg_pwm(void)
 {
-	PWM_TIMERCFG_Type config;
+	cfg_pwm_periodo();
+
+	rampa_config(&rampa, RAMPA_ACEL, RAMPA_DECEL, RAMPA_JERK);
 
-	config.PrescaleOption = PWM_TIMER_PRESCALE_USVAL;
-	config.PrescaleValue = 1;
+	velocidad = 10;
+}
 
-	PWM_Init(LPC_PWM1, PWM_MODE_TIMER, &config);
+/**
+ * @brief Esta función fija el período del PWM y los períodos por
+ * 		  paso de la rampa, que dependen de PCLK.
+ */
+void cfg_pwm_periodo(void)
+{
+	motor_init(MOTOR_FRECUENCIA);
 
-	LPC_PWM1->PCR = 0x0; // PWM single-edge
-	LPC_PWM1->MR0 = 1000;
-	LPC_PWM1->MR1 = 50;
-	LPC_PWM1->MCR = (1<<1); // Reseteo del TC del PWM en match con PWM1MR0
-	LPC_PWM1->LER = (1<<1) | (1<<0); // Aplicar valores a MR0 y MR1
-	LPC_PWM1->PCR = (1<<9); // Habilitar output de PWM
-	LPC_PWM1->TCR = (1<<1); // Resteo de TC y PR
+	periodos_por_paso = (motor_frecuencia() + (RAMPA_PASOS_POR_S / 2)) / RAMPA_PASOS_POR_S;
 
-	velocidad = 1;
+	if (periodos_por_paso == 0)
+		periodos_por_paso = 1;
 }
 
 /**
  * @brief Esta función se encarga de setear la velocidad
  * 		  ingresada por teclado.
  *
- * @details Se hace una regla de 3 simple para un máximo
- * 		  	de 20[Km/h], logrando así que si el usuario
- * 		  	quiere ir a la máxima velocidad, el duty-cycle
- * 		  	del motor controlado por PWM será del 100%.
+ * @details La velocidad no salta: la referencia sigue una rampa
+ * 			con aceleración y jerk limitados (ver rampa.c) que avanza
+ * 			en PWM1_IRQHandler. La velocidad se sostiene a lazo
+ * 			cerrado con el encoder (ver control.c): el PID corrige el
+ * 			duty-cycle cuando la cinta se frena por el peso del usuario
+ * 			o por la tensión de alimentación. La regla de 3
+ * 			(20[Km/h] = 100%) queda como prealimentación.
  */
-void set_vel(uint8_t velocidad)
+void set_vel(uint32_t velocidad)
 {
-	LPC_PWM1->MR1 = velocidad * 50; //cycle_rate; // Actualiza MR1 con este nuevo valor
-	LPC_PWM1->LER = (1<<1); // Cargamos el nuevo valor de MR1 al comienzo del siguiente ciclo
+	rampa_objetivo(&rampa, velocidad * PF_MH_POR_DECIMA); // [m/h]
+
+	publicar_sesion();
+}
+
+/**
+ * @brief Esta función publica la celda de la sesión del bloque de
+ * 		  estado (ver estado.h). Se llama desde las tareas que
+ * 		  cambian alguno de sus campos.
+ */
+void publicar_sesion(void)
+{
+	estado_sesion_t s;
+
+	s.velocidad = velocidad;
+	s.temperatura = temperatura;
+	s.distancia = distancia;
+	s.tiempo_s = tiempo_s;
+	s.energia = metricas_energia_kcal(&metricas);
+	s.ppm_media = metricas_ppm_media(&metricas);
+	s.ritmo = metricas_ritmo_s_km(&metricas);
+
+	estado_sesion_publicar(&s);
+}
+
+/**
+ * @brief Handler del match de MR0, al comienzo de cada período
+ * 		  del PWM.
+ *
+ * @details Cada periodos_por_paso períodos (1[ms]) se avanza un
+ * 			paso la rampa, se entrega la referencia al
+ * 			lazo de velocidad y se carga el último duty calculado en
+ * 			MR1. Como éste es el único lugar donde se escribe MR1 y se
+ * 			hace recién empezado el período, el valor se latchea por
+ * 			LER entero al comienzo del siguiente, sin glitches.
+ * 			Cuando la rampa de frenado llega a 0, se avisa a la tarea
+ * 			que apaga el PWM.
+ */
+EN_RAM void PWM1_IRQHandler(void)
+{
+	PERFIL_ENTRAR(PERFIL_PWM);
+
+	if (motor_irq())
+	{
+		static uint32_t periodos = 0;
+
+		if (++periodos >= periodos_por_paso)
+		{
+			periodos = 0;
+
+			rampa_paso(&rampa);
+			control_referencia(rampa_actual(&rampa));
+
+			motor_duty(control_duty());
+
+			if (deteniendo && rampa_quieta(&rampa))
+			{
+				deteniendo = 0;
+
+				plan_publicar(EV_DETENIDO);
+			}
+		}
+	}
+
+	PERFIL_SALIR(PERFIL_PWM);
+}
+
+/**
+ * @brief Tarea que apaga el PWM al terminar la rampa de frenado,
+ * 		  salvo que se haya vuelto a encender la cinta.
+ *
+ * @details Recién con la cinta quieta se programa la página
+ * 			incompleta de la bitácora: el IAP deja la flash ocupada
+ * 			y no conviene que eso pase mientras frena.
+ */
+void tarea_detenido(void)
+{
+	if (rampa_quieta(&rampa) && (rampa_actual(&rampa) == 0))
+	{
+		control_cmd(DISABLE);
+		motor_cmd(DISABLE);
+
+		if (!on)
+		{
+			bitacora_vaciar(); // Página incompleta a la flash
+			bitacora_mantenimiento();
+
+			rueda_armar(&timer_reposo, REPOSO_ESPERA_TICKS, REPOSO_ESPERA_TICKS, vencer_reposo, NULL);
+		}
+	}
 }
 
 /**
  * @brief Esta función se encarga de deshabilitar los periféricos y
  * 		  resetear las variables necesarias para llevar el equipo a 0.
+ *
+ * @details La cinta frena con la rampa de desaceleración; el PWM se
+ * 			apaga en tarea_detenido cuando la referencia llega a 0.
  */
 void stop(void)
 {
 	set_vel(0);
 
-	PWM_Cmd(LPC_PWM1, DISABLE);
+	deteniendo = 1;
 
 	TIM_Cmd(LPC_TIM3, DISABLE);
-	TIM_Cmd(LPC_TIM0, DISABLE);
-	TIM_Cmd(LPC_TIM1, DISABLE);
-	TIM_Cmd(LPC_TIM2, DISABLE);
-
-	UART_TxCmd(LPC_UART2, DISABLE);
+	rueda_cancelar(&timer_telemetria);
+	adq_cmd(DISABLE);
+	rueda_cancelar(&timer_segundo);
+	// La transmisión sigue habilitada para volcar la sesión
 }
 
 /**
- * @brief Esta función configura el canal 0 del ADC
- * 		  para que funcione con el start asociado a
- * 		  al canal 0 de match del timer 1 (MAT1.0).
+ * @brief Esta función configura los canales del ADC
+ * 		  para que se barran en ráfaga y el GPDMA
+ * 		  copie las muestras a un buffer circular
+ * 		  (ver adquisicion.c).
  */
 void cfg_adc(void)
 {
-	// Configuramos P0.23 como AD0.0
+	// Configuramos P0.23, P0.25 y P0.26 como AD0.0, AD0.2 y AD0.3
 	PINSEL_CFG_Type cfg;
 
 	cfg.Portnum = 0;
-	cfg.Pinnum = 23;
 	cfg.Pinmode = PINSEL_PINMODE_TRISTATE;
 	cfg.Funcnum = 1;
 	cfg.OpenDrain = PINSEL_PINMODE_NORMAL;
 
+	cfg.Pinnum = 23;
 	PINSEL_ConfigPin(&cfg);
 
-	// Configuramos ADC
-	LPC_SC-> PCLKSEL0 |= (3 << 24);  // CCLK/8 = 100/8[Mhz] = 12.5[MHz]
+	cfg.Pinnum = 25;
+	PINSEL_ConfigPin(&cfg);
 
-	ADC_Init(LPC_ADC, 200000);
-	ADC_ChannelCmd(LPC_ADC, 0, ENABLE);
-	ADC_StartCmd(LPC_ADC, ADC_START_ON_MAT10);
-	ADC_EdgeStartConfig(LPC_ADC, ADC_START_ON_RISING);
-	ADC_IntConfig(LPC_ADC, ADC_ADGINTEN, SET);
+	cfg.Pinnum = 26;
+	PINSEL_ConfigPin(&cfg);
 
-	NVIC_ClearPendingIRQ(ADC_IRQn);
-	NVIC_EnableIRQ(ADC_IRQn);
+	// Configuramos P1.31 como AD0.5
+	cfg.Portnum = 1;
+	cfg.Pinnum = 31;
+	cfg.Funcnum = 3;
+
+	PINSEL_ConfigPin(&cfg);
+
+	// Configuramos ADC (PCLK en reloj_init)
+	// Ráfaga a ADQ_FS repartida entre los canales, 64x de sobremuestreo (~15 lecturas por segundo)
+	adq_init(ADQ_FS, ADQ_SOBREMUESTREO, canales_adc, sizeof(canales_adc) / sizeof(canales_adc[0]));
 }
 
 /**
- * @brief Este handler toma la lectura del ADC y la convierte
- * 		  a su equivalente en temperatura en base a las
- * 		  especificaciones del sensor de temperatura LM35.
+ * @brief Esta función inicializa el GPDMA. Cada módulo
+ * 		  configura su propio canal.
  */
-void ADC_IRQHandler(void)
+void cfg_dma(void)
 {
-	uint16_t adc_read = (ADC_GlobalGetData(LPC_ADC) >> 4) & 0xfff;
+	NVIC_DisableIRQ(DMA_IRQn);
 
-	temperatura = (adc_read * 0.08);
+	GPDMA_Init();
+
+	NVIC_EnableIRQ(DMA_IRQn);
 }
 
-void cfg_dma(void)
+/**
+ * @brief Esta función completa la configuración que no hace falta
+ * 		  para atender el teclado y los comandos: la recuperación y
+ * 		  el mantenimiento de la bitácora, el ADC y el encoder.
+ *
+ * @details Se llama desde timer_diferida, un tick después del
+ * 			arranque, o desde encender() si la cinta se enciende antes;
+ * 			sólo la primera llamada hace algo. En los dos casos la cinta
+ * 			está detenida, así que el mantenimiento puede borrar la
+ * 			flash.
+ */
+void cfg_diferida(void)
 {
-	NVIC_DisableIRQ(DMA_IRQn);
+	static uint8_t hecha = 0;
 
-	GPDMA_Channel_CFG_Type dma_cfg;
+	if (hecha)
+		return;
 
-	GPDMA_Init();
+	hecha = 1;
 
-	dma_cfg.ChannelNum = 0;
-	dma_cfg.SrcMemAddr = (uint32_t)DMASrc_Buffer;
-	dma_cfg.DstMemAddr = (uint32_t)DMADst_Buffer;
-	dma_cfg.TransferSize = DMA_TRANSFER_SIZE;
-	dma_cfg.TransferWidth = GPDMA_WIDTH_WORD;
-	dma_cfg.TransferType = GPDMA_TRANSFERTYPE_M2M;
-	dma_cfg.SrcConn = 0;
-	dma_cfg.DstConn = 0;
-	dma_cfg.DMALLI = 0;
+	rueda_cancelar(&timer_diferida);
 
-	GPDMA_Setup(&dma_cfg);
+	uint32_t t0 = ciclos_leer();
 
-	NVIC_EnableIRQ(DMA_IRQn);
+	bitacora_init(&iap_bitacora); // Recuperación de la bitácora persistente
+	recuperacion_us = (ciclos_leer() - t0) / (SystemCoreClock / 1000000);
+	bitacora_mantenimiento();
+
+	cfg_adc();
+	control_init(); // Velocidad de la cinta por encoder
+
+	arranque_marcar(ARRANQUE_DIFERIDO);
+	arranque_reportar(); // Sólo en Debug
+
+	rueda_armar(&timer_reposo, REPOSO_ESPERA_TICKS, REPOSO_ESPERA_TICKS, vencer_reposo, NULL);
+}
+
+/**
+ * @brief Callback de timer_diferida.
+ */
+void vencer_diferida(void *arg)
+{
+	(void)arg;
+
+	cfg_diferida();
+}
+
+/**
+ * @brief Esta función reajusta todos los periféricos que dependen de
+ * 		  PCLK. Es el callback de reloj_perfil, así que corre con CCLK
+ * 		  ya cambiado y las interrupciones enmascaradas.
+ *
+ * @details Los timers y el RIT mantienen sus cuentas en [us]; UART2
+ * 			recupera el baud rate, las interrupciones y la habilitación
+ * 			de la transmisión; el ADC y el PWM se reconfiguran a la
+ * 			misma frecuencia. Si el cambio a RELOJ_COMPLETO tuvo que
+ * 			esperar a la UART, la cinta ya arrancó: el PWM se vuelve a
+ * 			poner en marcha, con duty 0 hasta el próximo período.
+ */
+void reescalar_perifericos(void)
+{
+	tiempo_reescalar(LPC_TIM1, CLKPWR_PCLKSEL_TIMER1, 1); // Base de tiempo
+	tiempo_reescalar(LPC_TIM3, CLKPWR_PCLKSEL_TIMER3, PULSO_TICK_US);
+	teclado_reloj();
+	control_reloj();
+
+	cfg_uart2_linea();
+	UART_IntConfig(LPC_UART2, UART_INTCFG_RBR, ENABLE);
+	UART_IntConfig(LPC_UART2, UART_INTCFG_RLS, ENABLE);
+
+	adq_reloj();
+
+	uint8_t activo = motor_activo();
+
+	cfg_pwm_periodo(); // Deja el PWM detenido
+
+	if (activo)
+		motor_cmd(ENABLE);
+}
+
+/**
+ * @brief Esta función cambia el perfil de reloj.
+ *
+ * @details Si UART2 está transmitiendo, el cambio se reintenta
+ * 			desde timer_reloj cada RELOJ_ESPERA_TICKS: UART_Init vacía
+ * 			los FIFOs y cortaría la trama en curso. Mientras tanto
+ * 			todo sigue andando con el reloj anterior.
+ */
+void cambiar_reloj(reloj_perfil_t perfil)
+{
+	reloj_pendiente = perfil;
+
+	if (perfil == reloj_actual())
+		rueda_cancelar(&timer_reloj);
+	else if (!uart_tx_ocioso())
+	{
+		if (!rueda_armado(&timer_reloj))
+			rueda_armar(&timer_reloj, RELOJ_ESPERA_TICKS, RELOJ_ESPERA_TICKS, vencer_reloj, NULL);
+	}
+	else
+	{
+		rueda_cancelar(&timer_reloj);
+		reloj_perfil(perfil);
+	}
+}
+
+/**
+ * @brief Callback de timer_reloj.
+ */
+void vencer_reloj(void *arg)
+{
+	(void)arg;
+
+	cambiar_reloj(reloj_pendiente);
+}
+
+/**
+ * @brief Callback de timer_reposo. Pasa a RELOJ_REPOSO cuando la cinta
+ * 		  está detenida y no queda nada por transmitir; si no, se
+ * 		  reintenta en REPOSO_ESPERA_TICKS.
+ *
+ * @details 'A' o el comando ARRANCAR vuelven a RELOJ_COMPLETO en
+ * 			encender().
+ */
+void vencer_reposo(void *arg)
+{
+	(void)arg;
+
+	if (on || (rampa_actual(&rampa) != 0) || sesion_volcando() || perfil_volcando() || !uart_tx_ocioso())
+		return;
+
+	rueda_cancelar(&timer_reposo);
+	cambiar_reloj(RELOJ_REPOSO);
 }
 
+/**
+ * @brief Handler para las interrupciones del GPDMA.
+ *
+ * @details El canal UART_TX_DMA_CH transmite las tramas de
+ * 			telemetría y de sesión; al terminar se avisa al módulo
+ * 			de transmisión para liberar el buffer y, si se está
+ * 			volcando la sesión, se publica el evento para armar
+ * 			la trama siguiente.
+ * 			El canal ADQ_DMA_CH interrumpe cada vez que completa una
+ * 			mitad del buffer del ADC; el procesamiento se hace en
+ * 			tarea_adc.
+ */
 void DMA_IRQHandler(void)
 {
-	if(GPDMA_IntGetStatus(GPDMA_STAT_INTTC, 0))
-		GPDMA_ClearIntPending(GPDMA_STATCLR_INTTC, 0);
+	PERFIL_ENTRAR(PERFIL_DMA);
+
+	if (GPDMA_IntGetStatus(GPDMA_STAT_INT, UART_TX_DMA_CH))
+	{
+		if (GPDMA_IntGetStatus(GPDMA_STAT_INTTC, UART_TX_DMA_CH))
+			GPDMA_ClearIntPending(GPDMA_STATCLR_INTTC, UART_TX_DMA_CH);
+
+		if (GPDMA_IntGetStatus(GPDMA_STAT_INTERR, UART_TX_DMA_CH))
+			GPDMA_ClearIntPending(GPDMA_STATCLR_INTERR, UART_TX_DMA_CH);
+
+		uart_tx_dma_irq();
+
+		if (sesion_volcando() || perfil_volcando())
+			plan_publicar(EV_VOLCADO);
+	}
+
+	if (GPDMA_IntGetStatus(GPDMA_STAT_INT, ADQ_DMA_CH))
+	{
+		if (GPDMA_IntGetStatus(GPDMA_STAT_INTTC, ADQ_DMA_CH))
+		{
+			GPDMA_ClearIntPending(GPDMA_STATCLR_INTTC, ADQ_DMA_CH);
+
+			plan_publicar(EV_ADC);
+		}
+
+		if (GPDMA_IntGetStatus(GPDMA_STAT_INTERR, ADQ_DMA_CH))
+			GPDMA_ClearIntPending(GPDMA_STATCLR_INTERR, ADQ_DMA_CH);
+	}
+
+	PERFIL_SALIR(PERFIL_DMA);
+}
+
+/**
+ * @brief Handler del timer de velocidad del QEI, que ejecuta
+ * 		  el lazo de control de velocidad cada CONTROL_PERIODO_US
+ * 		  y publica la medición y el error del mismo período.
+ */
+EN_RAM void QEI_IRQHandler(void)
+{
+	PERFIL_ENTRAR(PERFIL_QEI);
+
+	if (control_qei_irq())
+	{
+		estado_control_t c = { control_velocidad_mh(), control_error_mh(), control_duty() };
+
+		estado_control_publicar(&c);
+	}
+
+	PERFIL_SALIR(PERFIL_QEI);
+}
+
+/**
+ * @brief Tarea que decima, filtra y escala la mitad completa del
+ * 		  buffer del ADC. La temperatura ya sale en centésimas de ºC
+ * 		  según las especificaciones del sensor LM35 (ver punto_fijo.h).
+ */
+void tarea_adc(void)
+{
+	adq_procesar();
 
-	if (GPDMA_IntGetStatus(GPDMA_STAT_INTERR, 0))
-		GPDMA_ClearIntPending(GPDMA_STATCLR_INTERR, 0);
+	temperatura = adq_valor(CH_TEMPERATURA);
 
-	GPDMA_ChannelCmd(0, DISABLE);
+	publicar_sesion();
 }
@@ -0,0 +1,244 @@
+/*
+===============================================================================
+ Nombre      : adquisicion.c
+ Description : Barrido de canales del ADC en ráfaga por GPDMA con
+               sobremuestreo, decimación, escalado y filtro por canal
+===============================================================================
+*/
+
+#include "lpc17xx_adc.h"
+#include "lpc17xx_gpdma.h"
+#include "adquisicion.h"
+#include "punto_fijo.h"
+
+#define ADQ_DMA_REG LPC_GPDMACH2 // Registros del canal ADQ_DMA_CH
+#define BARRERA() __asm volatile ("" ::: "memory") // Evita que el compilador reordene accesos
+
+/**
+ * @brief Estado de procesamiento de un canal.
+ */
+typedef struct
+{
+	int32_t ganancia_q16;
+	int32_t offset;
+	uint8_t filtro_k;
+	uint8_t primera; // Flag para inicializar el filtro con la primera salida
+	uint32_t acumulador; // Estado del filtro, escalado por 2^k
+} canal_t;
+
+static uint32_t muestras[2 * ADQ_MUESTRAS_MAX]; // Buffer circular en dos mitades
+static GPDMA_LLI_Type lli[2]; // Cada mitad enlaza con la otra
+static uint16_t por_mitad = ADQ_SOBREMUESTREO; // Palabras en cada mitad del buffer
+static uint8_t mascara = 0; // Canales habilitados
+static uint32_t fs_actual = 0; // Conversiones por segundo pedidas en adq_init
+static canal_t canales_estado[ADQ_CANALES];
+
+static adq_foto_t foto_actual;
+static volatile uint32_t secuencia = 0; // Impar mientras se actualiza foto_actual
+
+/**
+ * @brief Esta función configura el ADC para barrer en ráfaga los
+ * 		  canales indicados y un canal de GPDMA que copia cada
+ * 		  conversión a un buffer circular.
+ *
+ * @details El ADC convierte los canales habilitados en orden
+ * 			ascendente y cada resultado de ADGDR lleva el número de
+ * 			canal, así que todos comparten el mismo pedido de DMA:
+ * 			agregar un canal no agrega interrupciones.
+ * 			El GPDMA recorre dos listas enlazadas (LLI) que apuntan
+ * 			cada una a una mitad del buffer y se enlazan entre sí, por
+ * 			lo que la transferencia no termina nunca. Al completar
+ * 			cada mitad se genera una única interrupción, en la que se
+ * 			decima cada canal.
+ * 			Se asume que los pines ya están en función AD0.x, que el
+ * 			reloj del ADC ya fue configurado y que GPDMA_Init ya fue
+ * 			llamado.
+ *
+ * @param fs Conversiones por segundo (el ADC convierte en 65 ciclos);
+ * 			 cada canal se muestrea a fs / n.
+ * @param sobremuestreo Muestras por canal promediadas por salida.
+ * 						Cada factor 4 aporta un bit efectivo.
+ * @param canales Configuración de cada canal a barrer.
+ * @param n Cantidad de canales.
+ */
+void adq_init(uint32_t fs, uint16_t sobremuestreo, const adq_canal_cfg_t *canales, uint8_t n)
+{
+	mascara = 0;
+
+	for (uint8_t i = 0; i < n; i++)
+	{
+		canal_t *c = &canales_estado[canales[i].canal & 0x7];
+
+		c->ganancia_q16 = canales[i].ganancia_q16;
+		c->offset = canales[i].offset;
+		c->filtro_k = canales[i].filtro_k;
+		c->primera = 1;
+
+		mascara |= (1 << (canales[i].canal & 0x7));
+	}
+
+	if ((n == 0) || (sobremuestreo == 0) || ((sobremuestreo * n) > ADQ_MUESTRAS_MAX))
+		sobremuestreo = ADQ_MUESTRAS_MAX / (n ? n : 1);
+
+	por_mitad = sobremuestreo * n;
+	foto_actual.salidas = 0;
+	fs_actual = fs;
+
+	adq_reloj();
+
+	NVIC_DisableIRQ(ADC_IRQn); // Con DMA, la interrupción del ADC no se atiende
+
+	uint32_t control = GPDMA_DMACCxControl_TransferSize(por_mitad)
+			| GPDMA_DMACCxControl_SBSize(GPDMA_BSIZE_1)
+			| GPDMA_DMACCxControl_DBSize(GPDMA_BSIZE_1)
+			| GPDMA_DMACCxControl_SWidth(GPDMA_WIDTH_WORD)
+			| GPDMA_DMACCxControl_DWidth(GPDMA_WIDTH_WORD)
+			| GPDMA_DMACCxControl_DI
+			| GPDMA_DMACCxControl_I;
+
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		lli[i].SrcAddr = (uint32_t)&LPC_ADC->ADGDR;
+		lli[i].DstAddr = (uint32_t)&muestras[i * por_mitad];
+		lli[i].NextLLI = (uint32_t)&lli[1 - i];
+		lli[i].Control = control;
+	}
+
+	GPDMA_Channel_CFG_Type dma_cfg;
+
+	dma_cfg.ChannelNum = ADQ_DMA_CH;
+	dma_cfg.SrcMemAddr = 0;
+	dma_cfg.DstMemAddr = (uint32_t)muestras;
+	dma_cfg.TransferSize = por_mitad;
+	dma_cfg.TransferWidth = GPDMA_WIDTH_WORD;
+	dma_cfg.TransferType = GPDMA_TRANSFERTYPE_P2M;
+	dma_cfg.SrcConn = GPDMA_CONN_ADC;
+	dma_cfg.DstConn = 0;
+	dma_cfg.DMALLI = (uint32_t)&lli[1];
+
+	GPDMA_Setup(&dma_cfg);
+	GPDMA_ChannelCmd(ADQ_DMA_CH, ENABLE);
+}
+
+/**
+ * @brief Esta función configura el divisor del ADC para la PCLK
+ * 		  actual y habilita los canales. Se llama desde adq_init y
+ * 		  después de un cambio de reloj (ver reloj.h), con la ráfaga
+ * 		  detenida: ADC_Init reescribe el ADCR completo.
+ */
+void adq_reloj(void)
+{
+	if (!mascara)
+		return; // Todavía no se llamó a adq_init
+
+	ADC_Init(LPC_ADC, fs_actual);
+
+	for (uint8_t ch = 0; ch < ADQ_CANALES; ch++)
+		if (mascara & (1 << ch))
+			ADC_ChannelCmd(LPC_ADC, ch, ENABLE);
+
+	ADC_IntConfig(LPC_ADC, ADC_ADGINTEN, ENABLE); // Genera el pedido de DMA
+}
+
+/**
+ * @brief Esta función arranca o detiene las conversiones en ráfaga.
+ */
+void adq_cmd(FunctionalState estado)
+{
+	ADC_BurstCmd(LPC_ADC, estado);
+}
+
+/**
+ * @brief Esta función procesa la mitad del buffer que acaba de
+ * 		  completarse. Se llama a nivel de tarea, luego de que
+ * 		  DMA_IRQHandler publique el evento correspondiente.
+ *
+ * @details La mitad completa es la opuesta a la que está escribiendo
+ * 			el DMA, por lo que debe procesarse antes de que éste
+ * 			termine la mitad en curso (ADQ_SOBREMUESTREO muestras por
+ * 			canal, 64[ms] con la configuración por defecto). Se separan las muestras por canal (campo CHN de
+ * 			ADGDR) y se promedian; el resultado, en 1/16 de cuenta,
+ * 			pasa por el pasabajos de primer orden del canal:
+ * 				acumulador += x - acumulador / 2^k
+ * 			que conserva los bits fraccionarios entre salidas, y luego
+ * 			se escala. La foto se publica con un contador de secuencia
+ * 			para que los lectores nunca vean canales de salidas distintas.
+ */
+void adq_procesar(void)
+{
+	const uint32_t *bloque = muestras;
+
+	if (ADQ_DMA_REG->DMACCDestAddr < (uint32_t)&muestras[por_mitad])
+		bloque = &muestras[por_mitad]; // El DMA está en la primera mitad
+
+	uint32_t suma[ADQ_CANALES] = { 0 };
+	uint16_t cuenta[ADQ_CANALES] = { 0 };
+
+	for (uint16_t i = 0; i < por_mitad; i++)
+	{
+		uint8_t ch = ADC_GDR_CH(bloque[i]);
+
+		suma[ch] += ADC_GDR_RESULT(bloque[i]);
+		cuenta[ch]++;
+	}
+
+	secuencia++;
+
+	BARRERA();
+
+	for (uint8_t ch = 0; ch < ADQ_CANALES; ch++)
+	{
+		if (!(mascara & (1 << ch)) || (cuenta[ch] == 0))
+			continue;
+
+		canal_t *c = &canales_estado[ch];
+		uint32_t x = (suma[ch] << ADQ_FRAC_BITS) / cuenta[ch];
+
+		if (c->primera)
+		{
+			c->acumulador = x << c->filtro_k;
+			c->primera = 0;
+		}
+		else
+			c->acumulador += x - (c->acumulador >> c->filtro_k);
+
+		foto_actual.valor[ch] = pf_escalar_q16(c->acumulador >> c->filtro_k, c->ganancia_q16, c->offset);
+	}
+
+	foto_actual.salidas++;
+
+	BARRERA();
+
+	secuencia++;
+}
+
+/**
+ * @brief Esta función copia una foto consistente de todos los canales.
+ *
+ * @details Si una salida se publica mientras se copia, se repite la
+ * 			copia. No se deshabilitan interrupciones.
+ */
+void adq_leer(adq_foto_t *foto)
+{
+	uint32_t sec;
+
+	do
+	{
+		sec = secuencia;
+
+		BARRERA();
+
+		*foto = foto_actual;
+
+		BARRERA();
+	}
+	while ((sec & 1) || (sec != secuencia));
+}
+
+/**
+ * @brief Devuelve el último valor de un canal (una sola palabra, atómica).
+ */
+int32_t adq_valor(uint8_t canal)
+{
+	return foto_actual.valor[canal & 0x7];
+}
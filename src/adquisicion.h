@@ -0,0 +1,51 @@
+/*
+===============================================================================
+ Nombre      : adquisicion.h
+ Description : Barrido de canales del ADC en ráfaga por GPDMA con
+               sobremuestreo, decimación, escalado y filtro por canal
+===============================================================================
+*/
+
+#ifndef ADQUISICION_H_
+#define ADQUISICION_H_
+
+#include "lpc17xx.h"
+
+#define ADQ_DMA_CH 2 // Canal de GPDMA asociado al ADC
+#define ADQ_CANALES 8 // AD0.0 - AD0.7
+#define ADQ_FS 4000 // Conversiones por segundo por defecto (repartidas entre los canales)
+#define ADQ_SOBREMUESTREO 64 // Muestras por canal por salida decimada
+#define ADQ_MUESTRAS_MAX 256 // Sobremuestreo * canales habilitados
+#define ADQ_FRAC_BITS 4 // Las lecturas crudas se manejan en 1/16 de cuenta
+
+/**
+ * @brief Configuración de un canal del barrido.
+ *
+ * @details valor = (lectura [1/16 de cuenta] * ganancia_q16) / 2^16 + offset,
+ * 			en la unidad que elija el consumidor (ver PF_Q16 en punto_fijo.h).
+ */
+typedef struct
+{
+	uint8_t canal; // 0..7 (AD0.x)
+	int32_t ganancia_q16;
+	int32_t offset;
+	uint8_t filtro_k; // Pasabajos: y += (x - y) / 2^k (0 = sin filtro)
+} adq_canal_cfg_t;
+
+/**
+ * @brief Foto consistente de todos los canales.
+ */
+typedef struct
+{
+	int32_t valor[ADQ_CANALES]; // Ya escalado y filtrado
+	uint32_t salidas; // Cantidad de salidas decimadas desde adq_init
+} adq_foto_t;
+
+void adq_init(uint32_t fs, uint16_t sobremuestreo, const adq_canal_cfg_t *canales, uint8_t n);
+void adq_reloj(void);
+void adq_cmd(FunctionalState estado);
+void adq_procesar(void);
+void adq_leer(adq_foto_t *foto);
+int32_t adq_valor(uint8_t canal);
+
+#endif /* ADQUISICION_H_ */
@@ -0,0 +1,81 @@
+/*
+===============================================================================
+ Nombre      : arranque.c
+ Description : Traza de las fases del arranque con el contador de ciclos
+               del DWT
+===============================================================================
+*/
+
+#include "arranque.h"
+
+#if ARRANQUE_REPORTE
+#include "trama.h"
+#include "uart_tx.h"
+#endif
+
+// En el .bss: ResetISR los llena después de borrarlo
+uint32_t arranque_ciclos[ARRANQUE_FASES];
+uint32_t arranque_hz[ARRANQUE_FASES];
+
+/**
+ * @brief Devuelve el tiempo desde el reset hasta el fin de una
+ * 		  fase [us], o 0 si todavía no se marcó.
+ *
+ * @details Cada fase se convierte con el CCLK guardado en su marca.
+ * 			El final de SystemInit y de reloj_init ya corre con el
+ * 			PLL, así que ARRANQUE_RELOJ y ARRANQUE_PLL0 quedan
+ * 			sobreestimadas en unos pocos [us].
+ */
+uint32_t arranque_us(arranque_fase_t fase)
+{
+	uint32_t us = 0;
+	uint32_t previo = 0;
+
+	if (arranque_ciclos[fase] == 0)
+		return 0;
+
+	for (uint8_t f = 0; f <= fase; f++)
+	{
+		if (arranque_hz[f] == 0) // Fase sin marcar
+			continue;
+
+		us += (arranque_ciclos[f] - previo) / (arranque_hz[f] / 1000000);
+		previo = arranque_ciclos[f];
+	}
+
+	return us;
+}
+
+#if ARRANQUE_REPORTE
+
+/**
+ * @brief Esta función envía la traza por UART2 en una trama de tipo
+ * 		  TRAMA_TIPO_ARRANQUE. Si no hay un buffer de trama libre,
+ * 		  no se envía.
+ *
+ * @details Payload (little-endian): cantidad de fases (1 B) y el
+ * 			tiempo desde el reset al fin de cada una [us] (4 B c/u),
+ * 			en el orden de arranque_fase_t.
+ */
+void arranque_reportar(void)
+{
+	uint8_t payload[1 + (4 * ARRANQUE_FASES)];
+	uint8_t *trama = uart_tx_trama_obtener();
+
+	if (!trama)
+		return;
+
+	payload[0] = ARRANQUE_FASES;
+
+	for (uint8_t f = 0; f < ARRANQUE_FASES; f++)
+	{
+		uint32_t us = arranque_us(f);
+
+		for (uint8_t i = 0; i < 4; i++)
+			payload[1 + (4 * f) + i] = (us >> (8 * i)) & 0xff;
+	}
+
+	uart_tx_trama_enviar(trama, trama_armar(trama, TRAMA_TIPO_ARRANQUE, 0, payload, sizeof(payload)));
+}
+
+#endif
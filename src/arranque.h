@@ -0,0 +1,89 @@
+/*
+===============================================================================
+ Nombre      : arranque.h
+ Description : Traza de las fases del arranque con el contador de ciclos
+               del DWT
+
+ ResetISR pone el contador en 0 al salir del reset, así que cada marca
+ es el tiempo desde el reset hasta el fin de esa fase. Las tres
+ primeras las toma ResetISR (ver cr_startup_lpc175x_6x.c) y las guarda
+ después de inicializar el .bss; el resto, main.
+
+ Junto con cada marca se guarda el CCLK vigente, con el que se
+ convierte la fase a [us]. ARRANQUE_RELOJ corre a 4[MHz] (IRC) hasta
+ que SystemInit conecta el PLL, y ARRANQUE_PLL0 al oscilador de
+ 12[MHz] mientras reloj_init vuelve a enganchar el PLL0 (ver reloj.h).
+
+ El reporte por UART2 sólo se compila en la configuración Debug (DEBUG
+ definido) o si se define ARRANQUE_REPORTE en 1; las marcas se toman
+ siempre.
+===============================================================================
+*/
+
+#ifndef ARRANQUE_H_
+#define ARRANQUE_H_
+
+#include "ciclos.h"
+
+#ifndef ARRANQUE_REPORTE
+#ifdef DEBUG
+#define ARRANQUE_REPORTE 1
+#else
+#define ARRANQUE_REPORTE 0
+#endif
+#endif
+
+#define ARRANQUE_IRC_HZ 4000000 // Reloj al salir del reset
+
+/**
+ * @brief Fases del arranque, en orden.
+ */
+typedef enum
+{
+	ARRANQUE_RELOJ = 0, // SystemInit: PLL0 y divisores
+	ARRANQUE_DATA,      // Copia del .data desde la flash
+	ARRANQUE_BSS,       // Borrado del .bss
+	ARRANQUE_PLL0,      // reloj_init: PLL0 a 120[MHz]
+	ARRANQUE_MAIN,      // Planificador, sesión y métricas
+	ARRANQUE_GPIO,
+	ARRANQUE_TIMERS,    // Captura, base de tiempo y rueda
+	ARRANQUE_UART,      // GPDMA y UART2
+	ARRANQUE_LISTO,     // Teclado y comandos atendidos
+	ARRANQUE_DIFERIDO,  // Bitácora, ADC y encoder (ver cfg_diferida)
+	ARRANQUE_FASES
+} arranque_fase_t;
+
+extern uint32_t arranque_ciclos[ARRANQUE_FASES];
+extern uint32_t arranque_hz[ARRANQUE_FASES];
+
+/**
+ * @brief Registra el fin de una fase [ciclos desde el reset] y el
+ * 		  CCLK con el que corrió.
+ */
+static inline void arranque_marcar_hz(arranque_fase_t fase, uint32_t hz)
+{
+	arranque_ciclos[fase] = ciclos_leer();
+	arranque_hz[fase] = hz;
+}
+
+/**
+ * @brief Registra el fin de una fase que corrió a SystemCoreClock.
+ */
+static inline void arranque_marcar(arranque_fase_t fase)
+{
+	arranque_marcar_hz(fase, SystemCoreClock);
+}
+
+uint32_t arranque_us(arranque_fase_t fase);
+
+#if ARRANQUE_REPORTE
+
+void arranque_reportar(void);
+
+#else
+
+#define arranque_reportar() ((void)0)
+
+#endif
+
+#endif /* ARRANQUE_H_ */
@@ -0,0 +1,300 @@
+/*
+===============================================================================
+ Nombre      : bitacora.c
+ Description : Bitácora persistente de sesiones en flash, con nivelación
+               de desgaste y recuperación ante cortes de energía
+===============================================================================
+*/
+
+#include "bitacora.h"
+
+#define BLANCO 0xff // Valor de la flash borrada
+
+static const bitacora_flash_t *fl = 0;
+static uint32_t total = 0; // Páginas de la región
+static uint32_t por_sector = 0;
+
+static uint32_t puntero = 0; // Próxima página a programar
+static uint32_t libres = 0; // Páginas borradas a partir de puntero
+static uint32_t secuencia = 0; // Secuencia de la próxima página
+
+static uint8_t pagina[BITACORA_PAGINA] __attribute__ ((aligned(4))); // El IAP copia desde RAM alineada
+static uint8_t en_pagina = 0; // Registros acumulados en pagina
+static uint32_t descartados = 0;
+static uint32_t errores = 0;
+
+static const uint8_t *direccion(uint32_t p);
+static uint8_t valida(const uint8_t *p);
+static uint8_t en_blanco(const uint8_t *p);
+static uint32_t leer32(const uint8_t *p);
+static void escribir32(uint8_t *p, uint32_t v);
+static uint16_t crc_pagina(const uint8_t *p);
+static void programar(void);
+
+/**
+ * @brief Esta función recupera el estado de la bitácora.
+ *
+ * @details Se recorren los encabezados de todas las páginas buscando
+ * 			la de mayor secuencia; la escritura sigue después de ella,
+ * 			salteando páginas no vacías (restos de un corte durante la
+ * 			programación). Sólo se leen completas las páginas que se
+ * 			cuentan como libres, por lo que el costo está acotado por
+ * 			el tamaño de la región.
+ */
+void bitacora_init(const bitacora_flash_t *flash)
+{
+	fl = flash;
+	por_sector = flash->sector_size / BITACORA_PAGINA;
+	total = por_sector * flash->sectores;
+	en_pagina = 0;
+	descartados = 0;
+	errores = 0;
+
+	uint8_t hay = 0;
+	uint32_t ultima = 0;
+
+	secuencia = 0;
+
+	for (uint32_t p = 0; p < total; p++)
+	{
+		const uint8_t *d = direccion(p);
+
+		if (leer32(d) != BITACORA_MAGIA)
+			continue;
+
+		uint32_t s = leer32(d + 4);
+
+		if (!hay || ((int32_t)(s - secuencia) >= 0))
+		{
+			hay = 1;
+			ultima = p;
+			secuencia = s;
+		}
+	}
+
+	if (hay)
+	{
+		puntero = (ultima + 1) % total;
+		secuencia++;
+	}
+	else
+	{
+		puntero = 0;
+		secuencia = 0;
+	}
+
+	for (uint32_t i = 0; (i < total) && !en_blanco(direccion(puntero)); i++)
+		puntero = (puntero + 1) % total;
+
+	for (libres = 0; libres < total; libres++)
+		if (!en_blanco(direccion((puntero + libres) % total)))
+			break;
+}
+
+/**
+ * @brief Esta función agrega un registro a la página en RAM y la
+ * 		  programa cuando se completa. Se llama a nivel de tarea.
+ *
+ * @details Si no quedan páginas borradas (el borrado se hace con la
+ * 			cinta detenida, ver bitacora_mantenimiento), la página
+ * 			queda completa en RAM y los registros siguientes se
+ * 			descartan.
+ */
+void bitacora_agregar(const trama_registro_t *r)
+{
+	if (en_pagina == BITACORA_REGISTROS)
+	{
+		if (libres)
+			programar();
+
+		if (en_pagina == BITACORA_REGISTROS)
+		{
+			descartados++;
+
+			return;
+		}
+	}
+
+	trama_registro_serializar(r, &pagina[BITACORA_ENCABEZADO + (en_pagina * TRAMA_REGISTRO_SIZE)]);
+
+	if ((++en_pagina == BITACORA_REGISTROS) && libres)
+		programar();
+}
+
+/**
+ * @brief Esta función programa la página en RAM aunque esté
+ * 		  incompleta (fin de sesión).
+ */
+void bitacora_vaciar(void)
+{
+	if (en_pagina && libres)
+		programar();
+}
+
+/**
+ * @brief Esta función borra el próximo sector si queda menos de un
+ * 		  sector de páginas libres.
+ *
+ * @details El borrado de un sector bloquea la flash durante decenas
+ * 			de milisegundos, por lo que sólo debe llamarse con la
+ * 			cinta detenida. Se pierden las páginas más viejas. Si la
+ * 			zona libre termina en una página dañada a mitad de sector,
+ * 			se abandona el resto de ese sector.
+ */
+void bitacora_mantenimiento(void)
+{
+	if (libres >= por_sector)
+		return;
+
+	uint32_t q = (puntero + libres) % total;
+
+	if (q % por_sector)
+	{
+		if (libres)
+			return;
+
+		puntero = (puntero + por_sector - (puntero % por_sector)) % total;
+		q = puntero;
+	}
+
+	if (fl->borrar(q / por_sector))
+	{
+		errores++;
+
+		return;
+	}
+
+	libres += por_sector;
+
+	if (libres > total)
+		libres = total;
+}
+
+/**
+ * @brief Devuelve la cantidad de páginas ocupadas (válidas o no).
+ */
+uint32_t bitacora_paginas(void)
+{
+	return total - libres;
+}
+
+/**
+ * @brief Esta función lee la página i, contando desde la más vieja.
+ *
+ * @param registros Lugar para BITACORA_REGISTROS registros.
+ * @return Cantidad de registros leídos, 0 si la página es inválida.
+ */
+uint8_t bitacora_pagina(uint32_t i, trama_registro_t *registros)
+{
+	if (i >= bitacora_paginas())
+		return 0;
+
+	const uint8_t *d = direccion((puntero + libres + i) % total);
+
+	if (!valida(d))
+		return 0;
+
+	for (uint8_t j = 0; j < d[8]; j++)
+		trama_registro_deserializar(&d[BITACORA_ENCABEZADO + (j * TRAMA_REGISTRO_SIZE)], &registros[j]);
+
+	return d[8];
+}
+
+uint32_t bitacora_libres(void)
+{
+	return libres;
+}
+
+uint32_t bitacora_descartados(void)
+{
+	return descartados;
+}
+
+uint32_t bitacora_errores(void)
+{
+	return errores;
+}
+
+/**
+ * @brief Esta función completa el encabezado de la página en RAM y
+ * 		  la programa en la posición del puntero.
+ *
+ * @details Si la programación falla, la página de flash queda
+ * 			inutilizable hasta el próximo borrado: se avanza igual
+ * 			y se reintenta en la siguiente.
+ */
+static void programar(void)
+{
+	escribir32(pagina, BITACORA_MAGIA);
+	escribir32(pagina + 4, secuencia);
+	pagina[8] = en_pagina;
+	pagina[9] = BLANCO;
+
+	for (uint32_t i = BITACORA_ENCABEZADO + (en_pagina * TRAMA_REGISTRO_SIZE); i < BITACORA_PAGINA; i++)
+		pagina[i] = BLANCO;
+
+	uint16_t crc = crc_pagina(pagina);
+
+	pagina[10] = crc & 0xff;
+	pagina[11] = crc >> 8;
+
+	uint8_t error = fl->programar(puntero * BITACORA_PAGINA, pagina);
+
+	puntero = (puntero + 1) % total;
+	libres--;
+
+	if (error)
+	{
+		errores++;
+
+		return;
+	}
+
+	secuencia++;
+	en_pagina = 0;
+}
+
+static const uint8_t *direccion(uint32_t p)
+{
+	return fl->base + (p * BITACORA_PAGINA);
+}
+
+static uint8_t valida(const uint8_t *p)
+{
+	if ((leer32(p) != BITACORA_MAGIA) || (p[8] > BITACORA_REGISTROS))
+		return 0;
+
+	return crc_pagina(p) == (p[10] | (p[11] << 8));
+}
+
+static uint8_t en_blanco(const uint8_t *p)
+{
+	const uint32_t *w = (const uint32_t *)p;
+
+	for (uint32_t i = 0; i < (BITACORA_PAGINA / 4); i++)
+		if (w[i] != 0xffffffff)
+			return 0;
+
+	return 1;
+}
+
+static uint32_t leer32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void escribir32(uint8_t *p, uint32_t v)
+{
+	for (uint8_t i = 0; i < 4; i++)
+		p[i] = (v >> (8 * i)) & 0xff;
+}
+
+/**
+ * @brief CRC de la página, salteando los bytes del propio CRC.
+ */
+static uint16_t crc_pagina(const uint8_t *p)
+{
+	uint16_t crc = trama_crc16(p, 10, 0xffff);
+
+	return trama_crc16(p + BITACORA_ENCABEZADO, BITACORA_PAGINA - BITACORA_ENCABEZADO, crc);
+}
@@ -0,0 +1,74 @@
+/*
+===============================================================================
+ Nombre      : bitacora.h
+ Description : Bitácora persistente de sesiones en flash, con nivelación
+               de desgaste y recuperación ante cortes de energía
+
+ La bitácora ocupa una región de sectores consecutivos que se recorre en
+ forma circular, página por página (la unidad mínima de programación del
+ IAP es de 256 bytes). Cada página:
+
+   +--------+-----------+---+---+--------+--------------------+------+
+   | magia  | secuencia | n | - | CRC-16 | registros (30 x 8) | 0xff |
+   |  4 B   |    4 B    |1 B|1 B|  2 B   |       240 B        | 4 B  |
+   +--------+-----------+---+---+--------+--------------------+------+
+
+ El CRC (ver trama_crc16) cubre toda la página salvo el propio CRC. Una
+ página a medio programar por un corte de energía no pasa el CRC y se
+ saltea. Un sector sólo se borra cuando el puntero de escritura llega a
+ él, por lo que todos los sectores se gastan por igual.
+
+ Este módulo no accede al hardware: las operaciones de flash se reciben
+ en un bitacora_flash_t (ver iap.h), que en una PC puede simularse con
+ un arreglo en RAM.
+===============================================================================
+*/
+
+#ifndef BITACORA_H_
+#define BITACORA_H_
+
+#include <stdint.h>
+#include "trama.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BITACORA_PAGINA 256 // [bytes]
+#define BITACORA_ENCABEZADO 12
+#define BITACORA_REGISTROS ((BITACORA_PAGINA - BITACORA_ENCABEZADO) / TRAMA_REGISTRO_SIZE)
+#define BITACORA_MAGIA 0x31474f4c // "LOG1"
+
+/**
+ * @brief Operaciones de flash sobre la región de la bitácora.
+ *
+ * @details Los desplazamientos son relativos al comienzo de la región
+ * 			y los sectores se numeran desde 0. La lectura es directa
+ * 			(la flash está mapeada en memoria). Las funciones devuelven
+ * 			0 si la operación fue exitosa.
+ */
+typedef struct
+{
+	const uint8_t *base;
+	uint32_t sector_size; // [bytes], múltiplo de BITACORA_PAGINA
+	uint8_t sectores;
+	uint8_t (*borrar)(uint8_t sector);
+	uint8_t (*programar)(uint32_t offset, const uint8_t *pagina);
+} bitacora_flash_t;
+
+void bitacora_init(const bitacora_flash_t *flash);
+void bitacora_agregar(const trama_registro_t *r);
+void bitacora_vaciar(void);
+void bitacora_mantenimiento(void);
+
+uint32_t bitacora_paginas(void);
+uint8_t bitacora_pagina(uint32_t i, trama_registro_t *registros);
+uint32_t bitacora_libres(void);
+uint32_t bitacora_descartados(void);
+uint32_t bitacora_errores(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BITACORA_H_ */
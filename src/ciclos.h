@@ -0,0 +1,45 @@
+/*
+===============================================================================
+ Nombre      : ciclos.h
+ Description : Acceso al contador de ciclos del DWT (Cortex-M3)
+===============================================================================
+*/
+
+#ifndef CICLOS_H_
+#define CICLOS_H_
+
+#include "lpc17xx.h"
+
+// El simulador de host/sim los define antes, como variables
+#ifndef CICLOS_DWT_CYCCNT
+#define CICLOS_DEMCR (*(volatile uint32_t *)0xE000EDFC) // Debug Exception and Monitor Control
+#define CICLOS_DWT_CTRL (*(volatile uint32_t *)0xE0001000)
+#define CICLOS_DWT_CYCCNT (*(volatile uint32_t *)0xE0001004)
+#endif
+
+#define CICLOS_DEMCR_TRCENA (1UL << 24)
+#define CICLOS_DWT_CYCCNTENA (1UL << 0)
+
+/**
+ * @brief Habilita el contador de ciclos del DWT.
+ *
+ * @details No lo pone en 0: ResetISR lo arranca desde el reset para
+ * 			la traza del arranque (ver arranque.h), y varios módulos
+ * 			llaman a esta función al inicializarse.
+ */
+static inline void ciclos_init(void)
+{
+	CICLOS_DEMCR |= CICLOS_DEMCR_TRCENA;
+	CICLOS_DWT_CTRL |= CICLOS_DWT_CYCCNTENA;
+}
+
+/**
+ * @brief Devuelve el valor actual del contador de ciclos. Las
+ * 		  diferencias se calculan en aritmética sin signo.
+ */
+static inline __attribute__ ((always_inline)) uint32_t ciclos_leer(void)
+{
+	return CICLOS_DWT_CYCCNT;
+}
+
+#endif /* CICLOS_H_ */
@@ -0,0 +1,230 @@
+/*
+===============================================================================
+ Nombre      : control.c
+ Description : Control de lazo cerrado de la velocidad de la cinta con
+               realimentación por encoder (QEI)
+===============================================================================
+*/
+
+#include "lpc17xx_pinsel.h"
+#include "lpc17xx_qei.h"
+#include "control.h"
+#include "pid.h"
+#include "punto_fijo.h"
+#include "ram.h"
+
+#define CONTROL_VENTANA_MASK (CONTROL_VENTANA - 1)
+
+// Ganancias por defecto (medida en [m/h], salida en duty Q16, ver motor.h)
+#define CONTROL_KP PF_Q16(MOTOR_DUTY_MAX, 50000) // 1[Km/h] de error = 2% de duty
+#define CONTROL_KI PF_Q16(MOTOR_DUTY_MAX, 1000000) // 1[Km/h] sostenido 1[s] = 10% de duty
+#define CONTROL_KD 0
+
+static pid_control_t pid;
+static volatile uint8_t activo = 0;
+static volatile uint32_t referencia = 0; // [m/h]
+
+static uint32_t capturas[CONTROL_VENTANA]; // Flancos de los últimos períodos
+static uint32_t suma = 0;
+static uint8_t idx = 0;
+static volatile uint32_t pulsos = 0; // Flancos desde control_init
+static volatile uint32_t velocidad_mh = 0;
+static volatile int32_t error_mh = 0;
+static volatile int32_t error_max_mh = 0;
+static volatile uint32_t duty = 0;
+
+/**
+ * @brief Esta función configura el QEI para medir la velocidad
+ * 		  de la cinta y deja el lazo abierto.
+ *
+ * @details MCI0 (P1.20) y MCI1 (P1.23) reciben las fases del encoder.
+ * 			El timer de velocidad del QEI interrumpe cada
+ * 			CONTROL_PERIODO_US con la cantidad de flancos contados
+ * 			en el período, lo que fija el ritmo del lazo sin usar
+ * 			otro timer.
+ */
+void control_init(void)
+{
+	PINSEL_CFG_Type cfg;
+
+	cfg.Portnum = 1;
+	cfg.Funcnum = 1;
+	cfg.Pinmode = PINSEL_PINMODE_PULLUP;
+	cfg.OpenDrain = PINSEL_PINMODE_NORMAL;
+
+	cfg.Pinnum = 20; // MCI0
+	PINSEL_ConfigPin(&cfg);
+
+	cfg.Pinnum = 23; // MCI1
+	PINSEL_ConfigPin(&cfg);
+
+	QEI_CFG_Type config;
+
+	QEI_ConfigStructInit(&config);
+	config.CaptureMode = QEI_CAPMODE_4X;
+
+	QEI_Init(LPC_QEI, &config);
+
+	control_reloj();
+
+	pid_init(&pid, CONTROL_KP, CONTROL_KI, CONTROL_KD, 0, MOTOR_DUTY_MAX);
+
+	for (uint8_t i = 0; i < CONTROL_VENTANA; i++)
+		capturas[i] = 0;
+
+	suma = 0;
+	pulsos = 0;
+	activo = 0;
+
+	QEI_IntCmd(LPC_QEI, QEI_INTCFG_TIM, ENABLE);
+
+	NVIC_SetPriority(QEI_IRQn, 6);
+	NVIC_EnableIRQ(QEI_IRQn);
+}
+
+/**
+ * @brief Esta función ajusta la recarga del timer de velocidad a la
+ * 		  PCLK actual, para que el período siga siendo
+ * 		  CONTROL_PERIODO_US. Se llama después de un cambio de reloj
+ * 		  (ver reloj.h).
+ *
+ * @details El timer de velocidad se vuelve a 0, como el contador del
+ * 			RIT en teclado_reloj.
+ */
+void control_reloj(void)
+{
+	QEI_RELOADCFG_Type recarga;
+
+	recarga.ReloadOption = QEI_TIMERRELOAD_USVAL;
+	recarga.ReloadValue = CONTROL_PERIODO_US;
+
+	QEI_SetTimerReload(LPC_QEI, &recarga);
+	QEI_Reset(LPC_QEI, QEI_RESET_VEL);
+}
+
+/**
+ * @brief Esta función cierra o abre el lazo.
+ *
+ * @details Al abrirlo se deja el duty en 0; al cerrarlo se descarta
+ * 			el estado anterior del PID. El duty lo carga en MR1
+ * 			PWM1_IRQHandler.
+ */
+void control_cmd(FunctionalState estado)
+{
+	activo = 0;
+
+	pid_reiniciar(&pid);
+
+	if (estado == ENABLE)
+	{
+		error_max_mh = 0;
+		activo = 1;
+	}
+	else
+		duty = 0;
+}
+
+/**
+ * @brief Esta función fija la velocidad de referencia [m/h].
+ */
+EN_RAM void control_referencia(uint32_t vel_mh)
+{
+	referencia = vel_mh;
+}
+
+/**
+ * @brief Esta función debe llamarse desde QEI_IRQHandler ante la
+ * 		  interrupción del timer de velocidad.
+ *
+ * @details La velocidad se mide sumando los flancos de los últimos
+ * 			CONTROL_VENTANA períodos (suma corrida, costo constante).
+ * 			Con el lazo cerrado, se ejecuta un paso del PID con la
+ * 			prealimentación de lazo abierto. El nuevo duty lo carga
+ * 			en MR1 PWM1_IRQHandler, único que escribe MR1.
+ * 			Accede a los registros sin pasar por el driver, que está
+ * 			en la flash, como motor_irq (ver ram.h).
+ *
+ * @return 1 si la interrupción es la del timer de velocidad, cuyo
+ * 		   flag queda limpio.
+ */
+EN_RAM uint8_t control_qei_irq(void)
+{
+	if (!(LPC_QEI->QEIINTSTAT & QEI_INTFLAG_TIM_Int))
+		return 0;
+
+	LPC_QEI->QEICLR = QEI_INTFLAG_TIM_Int;
+
+	uint32_t cap = LPC_QEI->QEICAP;
+
+	pulsos += cap;
+	suma += cap - capturas[idx];
+	capturas[idx] = cap;
+	idx = (idx + 1) & CONTROL_VENTANA_MASK;
+
+	velocidad_mh = (suma * CONTROL_MH_POR_PULSO) / CONTROL_VENTANA;
+
+	if (!activo)
+		return 1;
+
+	// En 32 bits hasta 65[Km/h]: UDIV, sin la división de 64 bits de la biblioteca, que está en la flash
+	int32_t ff = (int32_t)((referencia * MOTOR_DUTY_MAX) / CONTROL_VEL_PLENA_MH);
+	int32_t e = (int32_t)referencia - (int32_t)velocidad_mh;
+
+	duty = pid_paso(&pid, referencia, velocidad_mh, ff);
+	error_mh = e;
+
+	if (e < 0)
+		e = -e;
+
+	if (e > error_max_mh)
+		error_max_mh = e;
+
+	return 1;
+}
+
+/**
+ * @brief Devuelve la velocidad medida de la cinta [m/h].
+ */
+EN_RAM uint32_t control_velocidad_mh(void)
+{
+	return velocidad_mh;
+}
+
+/**
+ * @brief Devuelve el último error de seguimiento (referencia - medida) [m/h].
+ */
+EN_RAM int32_t control_error_mh(void)
+{
+	return error_mh;
+}
+
+/**
+ * @brief Devuelve el máximo error absoluto desde que se cerró el lazo [m/h].
+ */
+int32_t control_error_max_mh(void)
+{
+	return error_max_mh;
+}
+
+EN_RAM uint32_t control_duty(void)
+{
+	return duty;
+}
+
+/**
+ * @brief Devuelve la distancia recorrida por la cinta según el
+ * 		  encoder [m], independiente de la velocidad ingresada.
+ */
+uint32_t control_distancia_m(void)
+{
+	return pulsos / CONTROL_PULSOS_POR_METRO;
+}
+
+/**
+ * @brief Devuelve los flancos contados desde control_init, para
+ * 		  integrar la distancia sin perder fracciones de metro.
+ */
+uint32_t control_pulsos(void)
+{
+	return pulsos;
+}
@@ -0,0 +1,40 @@
+/*
+===============================================================================
+ Nombre      : control.h
+ Description : Control de lazo cerrado de la velocidad de la cinta con
+               realimentación por encoder (QEI)
+===============================================================================
+*/
+
+#ifndef CONTROL_H_
+#define CONTROL_H_
+
+#include "lpc17xx.h"
+#include "motor.h"
+
+#define CONTROL_PERIODO_US 10000 // Período del lazo (recarga del timer de velocidad del QEI)
+#define CONTROL_PULSOS_POR_METRO 4000 // Flancos por metro de cinta (encoder en modo 4X)
+#define CONTROL_VENTANA 4 // Períodos sumados para medir la velocidad (debe ser potencia de 2)
+#define CONTROL_VEL_PLENA_MH 20000 // Prealimentación: velocidad a lazo abierto con 100% de duty [m/h]
+
+// Metros por hora que representa un flanco contado en un período
+#define CONTROL_MH_POR_PULSO (3600000000ULL / ((uint64_t)CONTROL_PULSOS_POR_METRO * CONTROL_PERIODO_US))
+
+#if (3600000000ULL % (CONTROL_PULSOS_POR_METRO * CONTROL_PERIODO_US)) != 0
+#error "CONTROL_PULSOS_POR_METRO * CONTROL_PERIODO_US debe dividir a 3.6e9"
+#endif
+
+void control_init(void);
+void control_reloj(void);
+void control_cmd(FunctionalState estado);
+void control_referencia(uint32_t vel_mh);
+uint8_t control_qei_irq(void);
+
+uint32_t control_velocidad_mh(void);
+int32_t control_error_mh(void);
+int32_t control_error_max_mh(void);
+uint32_t control_duty(void);
+uint32_t control_distancia_m(void);
+uint32_t control_pulsos(void);
+
+#endif /* CONTROL_H_ */
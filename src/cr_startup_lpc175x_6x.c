@@ -47,6 +47,11 @@ extern "C" {
 extern void SystemInit(void);
 #endif
 
+// Boot phase trace (DWT cycle counter), see arranque.h
+#include "arranque.h"
+// Vector table and hot handlers in SRAM, see ram.h
+#include "ram.h"
+
 //*****************************************************************************
 //
 // Forward declaration of the default handlers. These are aliased.
@@ -212,26 +217,56 @@ void (* const g_pfnVectors[])(void) = {
     CANActivity_IRQHandler,                 // 50, 0xc8 - CAN Activity interrupt to wakeup
 };
 
+_Static_assert(sizeof(g_pfnVectors) == sizeof(ram_vectores), "ram_vectores must hold the whole vector table");
+
 //*****************************************************************************
 // Functions to carry out the initialization of RW and BSS data sections. These
 // are written as separate functions rather than being inlined within the
 // ResetISR() function in order to cope with MCUs with multiple banks of
 // memory.
+//
+// The bulk of each section is moved 16 bytes at a time with LDM/STM (one
+// instruction fetch and one burst per 4 words instead of 4 loads and 4
+// stores), and the remaining words with the plain loop. r7 is left alone
+// because it is the frame pointer in unoptimized builds.
 //*****************************************************************************
 __attribute__ ((section(".after_vectors")))
 void data_init(unsigned int romstart, unsigned int start, unsigned int len) {
     unsigned int *pulDest = (unsigned int*) start;
     unsigned int *pulSrc = (unsigned int*) romstart;
-    unsigned int loop;
-    for (loop = 0; loop < len; loop = loop + 4)
+    unsigned int loop = len >> 4;
+    if (loop) {
+        __asm volatile ("1:\n\t"
+                        "ldmia %0!, {r3-r6}\n\t"
+                        "stmia %1!, {r3-r6}\n\t"
+                        "subs %2, %2, #1\n\t"
+                        "bne 1b"
+                        : "+r" (pulSrc), "+r" (pulDest), "+r" (loop)
+                        :
+                        : "r3", "r4", "r5", "r6", "cc", "memory");
+    }
+    for (loop = 0; loop < (len & 0xf); loop = loop + 4)
         *pulDest++ = *pulSrc++;
 }
 
 __attribute__ ((section(".after_vectors")))
 void bss_init(unsigned int start, unsigned int len) {
     unsigned int *pulDest = (unsigned int*) start;
-    unsigned int loop;
-    for (loop = 0; loop < len; loop = loop + 4)
+    unsigned int loop = len >> 4;
+    if (loop) {
+        __asm volatile ("movs r3, #0\n\t"
+                        "movs r4, #0\n\t"
+                        "movs r5, #0\n\t"
+                        "movs r6, #0\n"
+                        "1:\n\t"
+                        "stmia %0!, {r3-r6}\n\t"
+                        "subs %1, %1, #1\n\t"
+                        "bne 1b"
+                        : "+r" (pulDest), "+r" (loop)
+                        :
+                        : "r3", "r4", "r5", "r6", "cc", "memory");
+    }
+    for (loop = 0; loop < (len & 0xf); loop = loop + 4)
         *pulDest++ = 0;
 }
 
@@ -256,6 +291,23 @@ __attribute__ ((section(".after_vectors")))
 void
 ResetISR(void) {
 
+    //
+    // Start the DWT cycle counter at zero, so that the boot trace
+    // measures time since reset.
+    //
+    ciclos_init();
+    CICLOS_DWT_CYCCNT = 0;
+
+#if defined (__USE_CMSIS) || defined (__USE_LPCOPEN)
+    //
+    // Bring up the PLL before touching RAM, so that the section copy runs
+    // at the core clock instead of the 4MHz IRC. SystemInit only writes
+    // peripheral registers and does not rely on .data or .bss.
+    //
+    SystemInit();
+#endif
+    unsigned int t_reloj = ciclos_leer();
+
     //
     // Copy the data sections from flash to SRAM.
     //
@@ -272,6 +324,7 @@ ResetISR(void) {
         SectionLen = *SectionTableAddr++;
         data_init(LoadAddr, ExeAddr, SectionLen);
     }
+    unsigned int t_data = ciclos_leer();
     // At this point, SectionTableAddr = &__bss_section_table;
     // Zero fill the bss segment
     while (SectionTableAddr < &__bss_section_table_end) {
@@ -279,9 +332,25 @@ ResetISR(void) {
         SectionLen = *SectionTableAddr++;
         bss_init(ExeAddr, SectionLen);
     }
+    unsigned int t_bss = ciclos_leer();
 
-#if defined (__USE_CMSIS) || defined (__USE_LPCOPEN)
-    SystemInit();
+    // The trace lives in .bss, so it can only be stored now
+    arranque_ciclos[ARRANQUE_RELOJ] = t_reloj;
+    arranque_ciclos[ARRANQUE_DATA] = t_data;
+    arranque_ciclos[ARRANQUE_BSS] = t_bss;
+    arranque_hz[ARRANQUE_RELOJ] = ARRANQUE_IRC_HZ;
+    arranque_hz[ARRANQUE_DATA] = SystemCoreClock;
+    arranque_hz[ARRANQUE_BSS] = SystemCoreClock;
+
+    //
+    // Copy the vector table to SRAM and fetch vectors from there, so that
+    // interrupt entry does not wait on flash (see ram.h).
+    //
+    for (unsigned int i = 0; i < RAM_VECTORES; i++)
+        ram_vectores[i] = g_pfnVectors[i];
+#if RAM_HABILITADA
+    SCB->VTOR = (unsigned int) ram_vectores;
+    __DSB();
 #endif
 
 #if defined (__cplusplus)
@@ -0,0 +1,155 @@
+/*
+===============================================================================
+ Nombre      : crucero.c
+ Description : Modo crucero por frecuencia cardíaca: ajusta la velocidad
+               para mantener las pulsaciones dentro de una zona
+===============================================================================
+*/
+
+#include "crucero.h"
+
+// Zonas de frecuencia cardíaca [ppm], para una máxima de ~190[ppm]
+static const uint16_t zonas[CRUCERO_ZONAS][2] =
+{
+	{ 95, 115 },  // 1: recuperación
+	{ 115, 135 }, // 2: aeróbico suave
+	{ 135, 150 }, // 3: aeróbico
+	{ 150, 165 }, // 4: umbral
+	{ 165, 180 }  // 5: máximo
+};
+
+/**
+ * @brief Esta función activa el modo crucero.
+ *
+ * @param zona Zona de frecuencia cardíaca, de 1 a CRUCERO_ZONAS.
+ * @param vel_max Velocidad máxima que puede pedir el lazo [décimas de Km/h].
+ */
+void crucero_iniciar(crucero_t *c, uint8_t zona, uint16_t vel_max)
+{
+	if ((zona == 0) || (zona > CRUCERO_ZONAS))
+	{
+		crucero_cancelar(c);
+
+		return;
+	}
+
+	c->zona = zona;
+	c->estado = CRUCERO_EN_ZONA;
+	c->ticks = 0;
+	c->ppm_min = zonas[zona - 1][0];
+	c->ppm_max = zonas[zona - 1][1];
+	c->vel_max = vel_max;
+}
+
+/**
+ * @brief Devuelve la zona de una frecuencia cardíaca: 0 por debajo
+ * 		  de la zona 1 y CRUCERO_ZONAS por encima de la última.
+ */
+uint8_t crucero_zona(uint32_t ppm)
+{
+	uint8_t z = 0;
+
+	while ((z < CRUCERO_ZONAS) && (ppm >= zonas[z][0]))
+		z++;
+
+	return z;
+}
+
+void crucero_cancelar(crucero_t *c)
+{
+	c->zona = 0;
+	c->estado = CRUCERO_INACTIVO;
+}
+
+/**
+ * @brief Esta función se llama en cada tick de 1[s] y devuelve la
+ * 		  velocidad a aplicar.
+ *
+ * @details La velocidad recibida es la vigente, así que un ajuste
+ * 			manual no se pisa: el lazo sigue corrigiendo desde ahí.
+ * 			- Si no hay frecuencia cardíaca o el último latido es más
+ * 			  viejo que CRUCERO_SENAL_MAX_S, no se puede controlar: se
+ * 			  baja a CRUCERO_VEL_SEGURA (la rampa limita la frenada) y
+ * 			  se espera. Al volver la señal se retoma después de un
+ * 			  período completo, para no corregir con una medición que
+ * 			  recién se está estabilizando.
+ * 			- Cada CRUCERO_PERIODO_S se mide el error respecto de la
+ * 			  zona. Dentro de la zona no se corrige. Una vez fuera, se
+ * 			  corrige hasta entrar CRUCERO_HISTERESIS ppm, para no
+ * 			  oscilar en el borde.
+ * 			- El paso es proporcional al error y está acotado, con
+ * 			  una bajada más rápida que la subida.
+ *
+ * @param ppm Frecuencia cardíaca, 0 si no hay medición.
+ * @param edad_s Segundos desde el último latido aceptado.
+ * @param velocidad Velocidad actual [décimas de Km/h].
+ */
+uint32_t crucero_tick(crucero_t *c, uint32_t ppm, uint32_t edad_s, uint32_t velocidad)
+{
+	if (c->zona == 0)
+		return velocidad;
+
+	if ((ppm == 0) || (edad_s > CRUCERO_SENAL_MAX_S))
+	{
+		if (c->estado != CRUCERO_SIN_SENAL)
+		{
+			c->estado = CRUCERO_SIN_SENAL;
+			c->perdidas++;
+		}
+
+		c->ticks = 0;
+
+		return (velocidad > CRUCERO_VEL_SEGURA) ? CRUCERO_VEL_SEGURA : velocidad;
+	}
+
+	if (c->estado == CRUCERO_SIN_SENAL)
+		c->estado = CRUCERO_EN_ZONA;
+
+	if (++c->ticks < CRUCERO_PERIODO_S)
+		return velocidad;
+
+	c->ticks = 0;
+
+	int32_t min = c->ppm_min;
+	int32_t max = c->ppm_max;
+	int32_t error = 0; // [ppm], > 0 si las pulsaciones están altas
+
+	if (c->estado == CRUCERO_CORRIGIENDO)
+	{
+		min += CRUCERO_HISTERESIS;
+		max -= CRUCERO_HISTERESIS;
+	}
+
+	if ((int32_t)ppm > max)
+		error = (int32_t)ppm - max;
+	else if ((int32_t)ppm < min)
+		error = (int32_t)ppm - min;
+
+	if (error == 0)
+	{
+		c->estado = CRUCERO_EN_ZONA;
+
+		return velocidad;
+	}
+
+	c->estado = CRUCERO_CORRIGIENDO;
+
+	int32_t paso = -error / CRUCERO_GANANCIA;
+
+	if (paso == 0)
+		paso = (error > 0) ? -1 : 1;
+
+	if (paso > CRUCERO_SUBIDA_MAX)
+		paso = CRUCERO_SUBIDA_MAX;
+	else if (paso < -CRUCERO_BAJADA_MAX)
+		paso = -CRUCERO_BAJADA_MAX;
+
+	int32_t v = (int32_t)velocidad + paso;
+
+	if (v < CRUCERO_VEL_MIN)
+		v = CRUCERO_VEL_MIN;
+	else if (v > c->vel_max)
+		v = c->vel_max;
+
+	return (uint32_t)v;
+}
@@ -0,0 +1,74 @@
+/*
+===============================================================================
+ Nombre      : crucero.h
+ Description : Modo crucero por frecuencia cardíaca: ajusta la velocidad
+               para mantener las pulsaciones dentro de una zona
+
+ Es un lazo externo lento, por encima del lazo de velocidad (ver
+ control.c): cada CRUCERO_PERIODO_S se compara la frecuencia cardíaca
+ con la zona elegida y se corrige la velocidad de referencia en pasos
+ acotados. La corrección es incremental (la velocidad acumula los
+ pasos), por lo que actúa como un integrador puro; el período largo y
+ los límites de paso dejan que el cuerpo responda (30 a 60[s]) antes
+ de volver a corregir.
+
+ Este módulo no depende del hardware: recibe la frecuencia cardíaca y
+ la antigüedad del último latido, y devuelve la velocidad. Se puede
+ compilar en una PC junto con un modelo de la respuesta cardíaca.
+===============================================================================
+*/
+
+#ifndef CRUCERO_H_
+#define CRUCERO_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CRUCERO_ZONAS 5 // Zonas 1 a 5
+#define CRUCERO_PERIODO_S 5 // Período del lazo externo [ticks de 1[s]]
+#define CRUCERO_HISTERESIS 3 // [ppm] que hay que entrar en la zona para dejar de corregir
+#define CRUCERO_GANANCIA 4 // [ppm de error por décima de Km/h]
+#define CRUCERO_SUBIDA_MAX 4 // [décimas de Km/h por período]
+#define CRUCERO_BAJADA_MAX 8 // [décimas de Km/h por período]
+#define CRUCERO_VEL_MIN 20 // [décimas de Km/h]
+#define CRUCERO_VEL_SEGURA 40 // [décimas de Km/h], sin señal de pulso
+#define CRUCERO_SENAL_MAX_S 8 // Antigüedad máxima del último latido [s]
+
+// Estados
+#define CRUCERO_INACTIVO 0
+#define CRUCERO_EN_ZONA 1
+#define CRUCERO_CORRIGIENDO 2
+#define CRUCERO_SIN_SENAL 3
+
+typedef struct
+{
+	uint8_t zona; // 1..CRUCERO_ZONAS, 0 = inactivo
+	uint8_t estado;
+	uint8_t ticks; // Ticks desde la última corrección
+	uint16_t ppm_min;
+	uint16_t ppm_max;
+	uint16_t vel_max; // [décimas de Km/h]
+	uint32_t perdidas; // Veces que se perdió la señal
+} crucero_t;
+
+void crucero_iniciar(crucero_t *c, uint8_t zona, uint16_t vel_max);
+void crucero_cancelar(crucero_t *c);
+uint32_t crucero_tick(crucero_t *c, uint32_t ppm, uint32_t edad_s, uint32_t velocidad);
+uint8_t crucero_zona(uint32_t ppm);
+
+/**
+ * @brief Devuelve 1 si el modo crucero está activo.
+ */
+static inline uint8_t crucero_activo(const crucero_t *c)
+{
+	return c->zona != 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRUCERO_H_ */
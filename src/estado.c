@@ -0,0 +1,120 @@
+/*
+===============================================================================
+ Nombre      : estado.c
+ Description : Bloque de estado compartido para telemetría, publicado
+               con seqlocks (un escritor por celda)
+===============================================================================
+*/
+
+#include "estado.h"
+#include "ram.h"
+
+#define BARRERA() __asm volatile ("" ::: "memory") // Evita que el compilador reordene accesos
+#define PALABRAS(x) (sizeof(x) / sizeof(uint32_t))
+
+// Celdas
+#define PULSO 0
+#define CONTROL 1
+#define SESION 2
+#define CELDAS 3
+
+static volatile uint32_t secuencia[CELDAS];
+static estado_foto_t actual;
+static uint32_t reintentos = 0;
+
+_Static_assert((sizeof(estado_pulso_t) % 4) == 0, "Las celdas se copian por palabras");
+_Static_assert((sizeof(estado_control_t) % 4) == 0, "Las celdas se copian por palabras");
+_Static_assert((sizeof(estado_sesion_t) % 4) == 0, "Las celdas se copian por palabras");
+
+static void publicar(uint8_t celda, uint32_t *destino, const uint32_t *origen, uint32_t palabras);
+static void copiar(uint32_t *destino, const uint32_t *origen, uint32_t palabras);
+
+/**
+ * @brief Publica la celda del pulso. Sólo desde TIMER3_IRQHandler.
+ */
+EN_RAM void estado_pulso_publicar(const estado_pulso_t *p)
+{
+	publicar(PULSO, (uint32_t *)&actual.pulso, (const uint32_t *)p, PALABRAS(*p));
+}
+
+/**
+ * @brief Publica la celda del lazo de velocidad. Sólo desde QEI_IRQHandler.
+ */
+EN_RAM void estado_control_publicar(const estado_control_t *c)
+{
+	publicar(CONTROL, (uint32_t *)&actual.control, (const uint32_t *)c, PALABRAS(*c));
+}
+
+/**
+ * @brief Publica la celda de la sesión. Sólo desde tareas.
+ */
+void estado_sesion_publicar(const estado_sesion_t *s)
+{
+	publicar(SESION, (uint32_t *)&actual.sesion, (const uint32_t *)s, PALABRAS(*s));
+}
+
+/**
+ * @brief Esta función copia una foto consistente de todas las celdas.
+ *
+ * @details Se toman las secuencias, se copia todo y se verifica que
+ * 			ninguna secuencia fuera impar ni cambiara; si no, se
+ * 			repite. El escritor que interrumpe la copia termina su
+ * 			publicación antes de devolver el control, así que al
+ * 			reintentar ya no hay escritura en curso: en la práctica
+ * 			se repite a lo sumo una vez por interrupción que cae
+ * 			durante la copia.
+ */
+void estado_leer(estado_foto_t *foto)
+{
+	uint32_t sec[CELDAS];
+	uint8_t consistente;
+
+	do
+	{
+		for (uint8_t i = 0; i < CELDAS; i++)
+			sec[i] = secuencia[i];
+
+		BARRERA();
+
+		copiar((uint32_t *)foto, (const uint32_t *)&actual, PALABRAS(actual));
+
+		BARRERA();
+
+		consistente = 1;
+
+		for (uint8_t i = 0; i < CELDAS; i++)
+			if ((sec[i] & 1) || (sec[i] != secuencia[i]))
+				consistente = 0;
+
+		if (!consistente)
+			reintentos++;
+	}
+	while (!consistente);
+}
+
+/**
+ * @brief Devuelve las copias repetidas por una publicación concurrente.
+ */
+uint32_t estado_reintentos(void)
+{
+	return reintentos;
+}
+
+EN_RAM static void publicar(uint8_t celda, uint32_t *destino, const uint32_t *origen, uint32_t palabras)
+{
+	secuencia[celda]++;
+
+	BARRERA();
+
+	copiar(destino, origen, palabras);
+
+	BARRERA();
+
+	secuencia[celda]++;
+}
+
+EN_RAM static void copiar(uint32_t *destino, const uint32_t *origen, uint32_t palabras)
+{
+	for (uint32_t i = 0; i < palabras; i++)
+		destino[i] = origen[i];
+}
@@ -0,0 +1,78 @@
+/*
+===============================================================================
+ Nombre      : estado.h
+ Description : Bloque de estado compartido para telemetría, publicado
+               con seqlocks (un escritor por celda)
+
+ Cada celda tiene un único escritor, que la publica sin deshabilitar
+ interrupciones: incrementa la secuencia (impar = escribiendo), copia
+ los campos y la vuelve a incrementar. Un lector copia todas las
+ celdas y repite si alguna secuencia era impar o cambió mientras
+ copiaba, así que siempre obtiene una foto consistente de todas las
+ celdas juntas.
+
+   celda    escritor
+   pulso    TIMER3_IRQHandler
+   control  QEI_IRQHandler
+   sesion   tareas del planificador (no se interrumpen entre sí)
+
+ Un lector nunca debe tener más prioridad que el escritor de una
+ celda que lee (quedaría reintentando con el escritor suspendido):
+ se lee sólo desde tareas.
+===============================================================================
+*/
+
+#ifndef ESTADO_H_
+#define ESTADO_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Todos los campos son de 32 bits: las celdas se copian por palabras
+
+typedef struct
+{
+	uint32_t ppm;      // [pulsaciones/min], 0 sin medición
+	uint32_t ppm_x10;  // [décimas de pulsaciones/min], de la misma medición
+	uint32_t t_ultimo; // Captura del último latido aceptado [ticks de PULSO_TICK_US]
+} estado_pulso_t;
+
+typedef struct
+{
+	uint32_t velocidad_mh; // Medida por el encoder
+	int32_t error_mh;      // Referencia - medida, del mismo período
+	uint32_t duty;         // Q16
+} estado_control_t;
+
+typedef struct
+{
+	uint32_t velocidad;   // [décimas de Km/h]
+	int32_t temperatura;  // [centésimas de ºC]
+	uint32_t distancia;   // [m]
+	uint32_t tiempo_s;    // [s]
+	uint32_t energia;     // [kcal]
+	uint32_t ppm_media;   // [pulsaciones/min]
+	uint32_t ritmo;       // [s/km]
+} estado_sesion_t;
+
+typedef struct
+{
+	estado_pulso_t pulso;
+	estado_control_t control;
+	estado_sesion_t sesion;
+} estado_foto_t;
+
+void estado_pulso_publicar(const estado_pulso_t *p);
+void estado_control_publicar(const estado_control_t *c);
+void estado_sesion_publicar(const estado_sesion_t *s);
+void estado_leer(estado_foto_t *foto);
+uint32_t estado_reintentos(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESTADO_H_ */
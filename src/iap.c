@@ -0,0 +1,124 @@
+/*
+===============================================================================
+ Nombre      : iap.c
+ Description : Programación de la flash interna mediante IAP
+===============================================================================
+*/
+
+#include "iap.h"
+#include "ram.h"
+
+typedef void (*iap_entrada_t)(uint32_t *cmd, uint32_t *res);
+
+static uint32_t iap(uint32_t *cmd);
+static uint8_t bitacora_borrar(uint8_t sector);
+static uint8_t bitacora_programar(uint32_t offset, const uint8_t *pagina);
+
+const bitacora_flash_t iap_bitacora =
+{
+	(const uint8_t *)IAP_BITACORA_DIR,
+	IAP_SECTOR_SIZE,
+	IAP_BITACORA_SECTORES,
+	bitacora_borrar,
+	bitacora_programar
+};
+
+/**
+ * @brief Esta función borra los sectores inicio a fin (inclusive).
+ *
+ * @return Código de estado del IAP.
+ */
+uint32_t iap_borrar(uint8_t inicio, uint8_t fin)
+{
+	uint32_t cmd[5] = { IAP_PREPARAR, inicio, fin, 0, 0 };
+	uint32_t estado = iap(cmd);
+
+	if (estado != IAP_CMD_SUCCESS)
+		return estado;
+
+	cmd[0] = IAP_BORRAR;
+	cmd[1] = inicio;
+	cmd[2] = fin;
+	cmd[3] = SystemCoreClock / 1000; // [KHz]
+
+	return iap(cmd);
+}
+
+/**
+ * @brief Esta función copia un bloque de RAM a la flash.
+ *
+ * @details dir debe estar alineada a 256 bytes, datos a 4 bytes,
+ * 			y len debe ser 256, 512, 1024 o 4096. Todo el bloque
+ * 			debe caer en un mismo sector.
+ *
+ * @return Código de estado del IAP.
+ */
+uint32_t iap_programar(uint32_t dir, const void *datos, uint32_t len)
+{
+	uint32_t sector = (dir < 0x10000) ? (dir >> 12) : (16 + ((dir - 0x10000) >> 15));
+	uint32_t cmd[5] = { IAP_PREPARAR, sector, sector, 0, 0 };
+	uint32_t estado = iap(cmd);
+
+	if (estado != IAP_CMD_SUCCESS)
+		return estado;
+
+	cmd[0] = IAP_COPIAR;
+	cmd[1] = dir;
+	cmd[2] = (uint32_t)datos;
+	cmd[3] = len;
+	cmd[4] = SystemCoreClock / 1000; // [KHz]
+
+	return iap(cmd);
+}
+
+/**
+ * @brief Esta función llama al IAP con las interrupciones de
+ * 		  prioridad IAP_PRIORIDAD o menor enmascaradas.
+ *
+ * @details Mientras el IAP programa o borra, la flash no puede leerse.
+ * 			Con la tabla de vectores en RAM, BASEPRI deja pasar sólo
+ * 			a PWM1 y TIMER3, cuyos handlers no tocan la flash: la rampa
+ * 			y el lazo siguen avanzando cada 1[ms] y los latidos se
+ * 			procesan al llegar, aun durante el borrado de un sector.
+ * 			El resto espera como mucho lo que dura una página (~1[ms]).
+ * 			Con RAM_HABILITADA en 0 todo está en la flash y se
+ * 			enmascaran todas las interrupciones.
+ * 			El IAP usa los 32 bytes superiores de la RAM local, que
+ * 			deben quedar fuera de la pila en la configuración del linker.
+ */
+static uint32_t iap(uint32_t *cmd)
+{
+	uint32_t res[5];
+
+#if RAM_HABILITADA
+	uint32_t basepri = __get_BASEPRI();
+
+	__set_BASEPRI(IAP_PRIORIDAD << (8 - __NVIC_PRIO_BITS));
+
+	((iap_entrada_t)IAP_ENTRADA)(cmd, res);
+
+	__set_BASEPRI(basepri);
+#else
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	((iap_entrada_t)IAP_ENTRADA)(cmd, res);
+
+	__set_PRIMASK(primask);
+#endif
+
+	return res[0];
+}
+
+static uint8_t bitacora_borrar(uint8_t sector)
+{
+	uint8_t s = IAP_BITACORA_SECTOR + sector;
+
+	return iap_borrar(s, s) != IAP_CMD_SUCCESS;
+}
+
+static uint8_t bitacora_programar(uint32_t offset, const uint8_t *pagina)
+{
+	return iap_programar(IAP_BITACORA_DIR + offset, pagina, BITACORA_PAGINA) != IAP_CMD_SUCCESS;
+}
@@ -0,0 +1,41 @@
+/*
+===============================================================================
+ Nombre      : iap.h
+ Description : Programación de la flash interna mediante IAP
+===============================================================================
+*/
+
+#ifndef IAP_H_
+#define IAP_H_
+
+#include "lpc17xx.h"
+#include "bitacora.h"
+
+#define IAP_ENTRADA 0x1fff1ff1 // Punto de entrada del IAP en la ROM (modo Thumb)
+
+// Comandos del IAP (UM10360, cap. 32)
+#define IAP_PREPARAR 50
+#define IAP_COPIAR 51
+#define IAP_BORRAR 52
+
+#define IAP_CMD_SUCCESS 0
+
+/*
+ Durante el IAP sólo se atienden las interrupciones de prioridad más
+ alta (menor número) que IAP_PRIORIDAD: PWM1 (4) y TIMER3 (3), que
+ corren enteras desde la RAM (ver ram.h).
+*/
+#define IAP_PRIORIDAD 5
+
+// Región de la bitácora: sectores 28 y 29 (los dos últimos de 32[KB]); la aplicación no debe ocuparlos
+#define IAP_BITACORA_SECTOR 28
+#define IAP_BITACORA_SECTORES 2
+#define IAP_BITACORA_DIR 0x00070000
+#define IAP_SECTOR_SIZE 0x8000
+
+uint32_t iap_borrar(uint8_t inicio, uint8_t fin);
+uint32_t iap_programar(uint32_t dir, const void *datos, uint32_t len);
+
+extern const bitacora_flash_t iap_bitacora;
+
+#endif /* IAP_H_ */
@@ -0,0 +1,158 @@
+/*
+===============================================================================
+ Nombre      : latencia.c
+ Description : Medición de la latencia de entrada a una interrupción
+               con la tabla de vectores y el handler en flash o en RAM
+===============================================================================
+*/
+
+#include "latencia.h"
+
+#if LATENCIA_HABILITADA
+
+#include <cr_section_macros.h>
+#include "ciclos.h"
+#include "ram.h"
+#include "trama.h"
+#include "uart_tx.h"
+
+#define IRQ_FLASH TIMER0_IRQn // Libres desde que la base de tiempo usa TIMER1
+#define IRQ_RAM TIMER2_IRQn
+#define PRIORIDAD 0 // Por encima de todos los handlers del equipo
+
+extern void (* const g_pfnVectors[])(void); // Tabla en flash (cr_startup_lpc175x_6x.c)
+
+static volatile uint32_t entrada;
+static latencia_stats_t stats[LATENCIA_CASOS];
+static uint8_t proximo = 0;
+static uint8_t seq = 0;
+
+void latencia_init(void)
+{
+	for (uint8_t i = 0; i < LATENCIA_CASOS; i++)
+	{
+		stats[i].cuenta = 0;
+		stats[i].min = 0xffffffff;
+		stats[i].max = 0;
+		stats[i].suma = 0;
+	}
+
+	proximo = 0;
+
+	ciclos_init();
+
+	NVIC_SetPriority(IRQ_FLASH, PRIORIDAD);
+	NVIC_SetPriority(IRQ_RAM, PRIORIDAD);
+	NVIC_EnableIRQ(IRQ_FLASH);
+	NVIC_EnableIRQ(IRQ_RAM);
+}
+
+/**
+ * @brief Esta función mide un caso, rotando entre los cuatro en
+ * 		  llamadas sucesivas. Se llama a nivel de tarea.
+ *
+ * @details BASEPRI enmascara todos los handlers del equipo durante la
+ * 			medición, así que nada se interpone entre el disparo y la
+ * 			entrada; el VTOR vuelve a su valor antes de desenmascarar.
+ * 			La latencia incluye la escritura del ISPR, que es constante.
+ */
+void latencia_medir(void)
+{
+	latencia_caso_t caso = proximo;
+	uint8_t tabla_ram = (caso == LATENCIA_TABLA_RAM) || (caso == LATENCIA_RAM);
+	IRQn_Type irq = ((caso == LATENCIA_ISR_RAM) || (caso == LATENCIA_RAM)) ? IRQ_RAM : IRQ_FLASH;
+	uint32_t basepri = __get_BASEPRI();
+	uint32_t vtor = SCB->VTOR;
+
+	__set_BASEPRI(1 << (8 - __NVIC_PRIO_BITS)); // Sólo PRIORIDAD interrumpe
+
+	SCB->VTOR = tabla_ram ? (uint32_t)ram_vectores : (uint32_t)g_pfnVectors;
+	__DSB();
+
+	entrada = 0;
+
+	uint32_t disparo = ciclos_leer();
+
+	NVIC_SetPendingIRQ(irq);
+	__DSB();
+	__ISB(); // La interrupción se toma acá
+
+	uint32_t latencia = entrada - disparo;
+
+	SCB->VTOR = vtor;
+	__DSB();
+
+	__set_BASEPRI(basepri);
+
+	latencia_stats_t *s = &stats[caso];
+
+	s->cuenta++;
+	s->suma += latencia;
+
+	if (latencia < s->min)
+		s->min = latencia;
+
+	if (latencia > s->max)
+		s->max = latencia;
+
+	proximo = (proximo + 1) % LATENCIA_CASOS;
+}
+
+void latencia_estadisticas(latencia_caso_t caso, latencia_stats_t *stats_caso)
+{
+	*stats_caso = stats[caso];
+}
+
+/**
+ * @brief Esta función envía las estadísticas por UART2 en una trama
+ * 		  de tipo TRAMA_TIPO_LATENCIA. Si no hay un buffer de trama
+ * 		  libre, no se envía.
+ *
+ * @details Payload (little-endian): por cada caso, en el orden de
+ * 			latencia_caso_t, cuenta, mínimo, máximo y media (4 B c/u).
+ * 			La diferencia entre máximo y mínimo es el jitter.
+ */
+void latencia_reportar(void)
+{
+	uint8_t payload[16 * LATENCIA_CASOS];
+	uint8_t *trama = uart_tx_trama_obtener();
+
+	if (!trama)
+		return;
+
+	for (uint8_t c = 0; c < LATENCIA_CASOS; c++)
+	{
+		const latencia_stats_t *s = &stats[c];
+		uint32_t campos[4] =
+		{
+			s->cuenta,
+			s->cuenta ? s->min : 0,
+			s->max,
+			s->cuenta ? (uint32_t)(s->suma / s->cuenta) : 0
+		};
+
+		for (uint8_t j = 0; j < 4; j++)
+			for (uint8_t i = 0; i < 4; i++)
+				payload[(16 * c) + (4 * j) + i] = (campos[j] >> (8 * i)) & 0xff;
+	}
+
+	uart_tx_trama_enviar(trama, trama_armar(trama, TRAMA_TIPO_LATENCIA, seq++, payload, sizeof(payload)));
+}
+
+/*
+ Handlers de medición: la primera instrucción útil lee el contador.
+ Se lee el registro directamente: es todo el handler, con o sin
+ optimización.
+*/
+
+void TIMER0_IRQHandler(void)
+{
+	entrada = CICLOS_DWT_CYCCNT;
+}
+
+__RAMFUNC(RAM) void TIMER2_IRQHandler(void)
+{
+	entrada = CICLOS_DWT_CYCCNT;
+}
+
+#endif
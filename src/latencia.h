@@ -0,0 +1,76 @@
+/*
+===============================================================================
+ Nombre      : latencia.h
+ Description : Medición de la latencia de entrada a una interrupción
+               con la tabla de vectores y el handler en flash o en RAM
+
+ Se disparan por software dos interrupciones libres (TIMER0 y TIMER2)
+ con prioridad 0 y se mide con el contador de ciclos desde la escritura
+ del pendiente hasta la primera instrucción del handler. El handler de
+ TIMER0 está en la flash y el de TIMER2 en la SRAM local, y la tabla se
+ elige cambiando el VTOR durante la medición (las dos tablas tienen el
+ mismo contenido, ver ram.h), así que una misma compilación mide los
+ cuatro casos.
+
+ Se mide desde tarea_rueda, después de código arbitrario de las
+ tareas, así que el estado del acelerador de la flash es el de
+ operación normal. No incluye la espera a que termine la instrucción
+ en curso, que no depende de dónde está el código.
+
+ Sólo se compila en la configuración Debug (DEBUG definido) o si se
+ define LATENCIA_HABILITADA en 1.
+===============================================================================
+*/
+
+#ifndef LATENCIA_H_
+#define LATENCIA_H_
+
+#include "lpc17xx.h"
+
+#ifndef LATENCIA_HABILITADA
+#ifdef DEBUG
+#define LATENCIA_HABILITADA 1
+#else
+#define LATENCIA_HABILITADA 0
+#endif
+#endif
+
+/**
+ * @brief Ubicación de la tabla de vectores y del handler.
+ */
+typedef enum
+{
+	LATENCIA_FLASH = 0, // Tabla y handler en flash
+	LATENCIA_TABLA_RAM, // Tabla en RAM, handler en flash
+	LATENCIA_ISR_RAM,   // Tabla en flash, handler en RAM
+	LATENCIA_RAM,       // Tabla y handler en RAM
+	LATENCIA_CASOS
+} latencia_caso_t;
+
+/**
+ * @brief Estadísticas de un caso [ciclos].
+ */
+typedef struct
+{
+	uint32_t cuenta;
+	uint32_t min;
+	uint32_t max;
+	uint64_t suma;
+} latencia_stats_t;
+
+#if LATENCIA_HABILITADA
+
+void latencia_init(void);
+void latencia_medir(void);
+void latencia_estadisticas(latencia_caso_t caso, latencia_stats_t *stats);
+void latencia_reportar(void);
+
+#else
+
+#define latencia_init() ((void)0)
+#define latencia_medir() ((void)0)
+#define latencia_reportar() ((void)0)
+
+#endif
+
+#endif /* LATENCIA_H_ */
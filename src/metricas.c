@@ -0,0 +1,94 @@
+/*
+===============================================================================
+ Nombre      : metricas.c
+ Description : Métricas de la sesión integradas en cada tick de 1[s]:
+               distancia, energía, promedios y tiempo por zona cardíaca
+===============================================================================
+*/
+
+#include "metricas.h"
+
+#define VO2_REPOSO 210000UL // 3.5[ml/kg/min] * 60000
+
+/**
+ * @brief Esta función comienza una sesión nueva.
+ *
+ * @param pulsos Valor actual del contador absoluto del encoder,
+ * 				 que se toma como origen de la distancia.
+ */
+void metricas_iniciar(metricas_t *m, uint32_t pulsos_por_metro, uint32_t peso_kg, uint32_t pulsos)
+{
+	m->pulsos_por_metro = pulsos_por_metro ? pulsos_por_metro : 1;
+	m->peso_kg = peso_kg;
+	m->pulsos_previos = pulsos;
+	m->pulsos = 0;
+	m->tiempo_s = 0;
+	m->vel_mh = 0;
+	m->energia_cal = 0;
+	m->energia_resto = 0;
+	m->ppm_suma = 0;
+	m->ppm_ticks = 0;
+
+	for (uint8_t i = 0; i < METRICAS_ZONAS; i++)
+		m->tiempo_zona[i] = 0;
+}
+
+/**
+ * @brief Esta función integra un tick de 1[s].
+ *
+ * @details La distancia del tick sale de la diferencia del contador
+ * 			del encoder (sin signo, así que el desborde no afecta), y
+ * 			de ella la velocidad media del tick, que es la que se usa
+ * 			para la energía. El costo es fijo: sin divisiones de 64
+ * 			bits ni bucles.
+ *
+ * @param pulsos Contador absoluto del encoder.
+ * @param ppm Frecuencia cardíaca, 0 si no hay medición.
+ * @param inclinacion Pendiente de la cinta [décimas de %].
+ */
+void metricas_tick(metricas_t *m, uint32_t pulsos, uint32_t ppm, uint32_t inclinacion)
+{
+	uint32_t avance = pulsos - m->pulsos_previos;
+
+	m->pulsos_previos = pulsos;
+	m->pulsos += avance;
+	m->tiempo_s++;
+	m->vel_mh = (avance * 3600) / m->pulsos_por_metro;
+
+	/*
+	 * Consumo de oxígeno [ml/kg/min * 60000]. Con v = vel_mh / 60 y
+	 * pendiente = inclinacion / 1000, kh * v queda kh * 1000 * vel_mh
+	 * y kv * v * pendiente queda kv * vel_mh * inclinacion.
+	 */
+	uint32_t vo2 = VO2_REPOSO;
+
+	if (m->vel_mh > METRICAS_CORRER_MH) // kh = 0.2, kv = 0.9
+		vo2 += (200 * m->vel_mh) + ((9 * m->vel_mh * inclinacion) / 10);
+	else // kh = 0.1, kv = 1.8
+		vo2 += (100 * m->vel_mh) + ((9 * m->vel_mh * inclinacion) / 5);
+
+	m->energia_resto += vo2 * m->peso_kg;
+	m->energia_cal += m->energia_resto / METRICAS_ENERGIA_DIV;
+	m->energia_resto %= METRICAS_ENERGIA_DIV;
+
+	if (ppm)
+	{
+		m->ppm_suma += ppm;
+		m->ppm_ticks++;
+		m->tiempo_zona[METRICAS_ZONA(crucero_zona(ppm))]++;
+	}
+	else
+		m->tiempo_zona[METRICAS_SIN_PULSO]++;
+}
+
+/**
+ * @brief Devuelve el ritmo medio de la sesión [s/km], o 0 si
+ * 		  todavía no se recorrió distancia.
+ */
+uint32_t metricas_ritmo_s_km(const metricas_t *m)
+{
+	if (m->pulsos == 0)
+		return 0;
+
+	return (uint32_t)(((uint64_t)m->tiempo_s * 1000 * m->pulsos_por_metro) / m->pulsos);
+}
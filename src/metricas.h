@@ -0,0 +1,92 @@
+/*
+===============================================================================
+ Nombre      : metricas.h
+ Description : Métricas de la sesión integradas en cada tick de 1[s]:
+               distancia, energía, promedios y tiempo por zona cardíaca
+
+ Todo se acumula en enteros sin redondear en cada paso, así que las
+ cifras no se degradan con la duración de la sesión, y cada una se
+ obtiene en O(1) en cualquier momento:
+
+   distancia  flancos del encoder (ver control.h)
+   energía    calorías enteras + resto en [cal / METRICAS_ENERGIA_DIV]
+   ppm media  suma de las mediciones / ticks con medición
+
+ La energía sigue las ecuaciones metabólicas del ACSM para caminar y
+ correr en cinta, con el consumo de oxígeno expresado en
+ [ml/kg/min * 60000] y 5[cal] por [ml] de oxígeno:
+
+   VO2 = 3.5 + kh * v + kv * v * pendiente    (v en [m/min])
+
+ Este módulo no depende del hardware.
+===============================================================================
+*/
+
+#ifndef METRICAS_H_
+#define METRICAS_H_
+
+#include <stdint.h>
+#include "crucero.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define METRICAS_PESO_KG 70 // Peso por defecto del usuario
+#define METRICAS_CORRER_MH 7500 // Por encima se usa la ecuación de correr [m/h]
+#define METRICAS_ENERGIA_DIV 720000UL // 60[s] * 60000 / 5[cal/ml]
+
+// Histograma de tiempo por zona cardíaca
+#define METRICAS_SIN_PULSO 0 // Ticks sin medición de frecuencia cardíaca
+#define METRICAS_ZONA(z) ((z) + 1) // z = 0 (debajo de la zona 1) .. CRUCERO_ZONAS
+#define METRICAS_ZONAS (CRUCERO_ZONAS + 2)
+
+typedef struct
+{
+	uint32_t pulsos_por_metro;
+	uint32_t peso_kg;
+	uint32_t pulsos_previos; // Contador absoluto del encoder en el tick anterior
+	uint32_t pulsos; // Flancos desde el comienzo de la sesión
+	uint32_t tiempo_s;
+	uint32_t vel_mh; // Velocidad media del último tick [m/h]
+	uint32_t energia_cal;
+	uint32_t energia_resto; // [cal / METRICAS_ENERGIA_DIV]
+	uint32_t ppm_suma;
+	uint32_t ppm_ticks;
+	uint32_t tiempo_zona[METRICAS_ZONAS]; // [s]
+} metricas_t;
+
+void metricas_iniciar(metricas_t *m, uint32_t pulsos_por_metro, uint32_t peso_kg, uint32_t pulsos);
+void metricas_tick(metricas_t *m, uint32_t pulsos, uint32_t ppm, uint32_t inclinacion);
+
+uint32_t metricas_ritmo_s_km(const metricas_t *m);
+
+/**
+ * @brief Devuelve la distancia de la sesión [m].
+ */
+static inline uint32_t metricas_distancia_m(const metricas_t *m)
+{
+	return m->pulsos / m->pulsos_por_metro;
+}
+
+/**
+ * @brief Devuelve la energía gastada en la sesión [kcal].
+ */
+static inline uint32_t metricas_energia_kcal(const metricas_t *m)
+{
+	return m->energia_cal / 1000;
+}
+
+/**
+ * @brief Devuelve la frecuencia cardíaca media, o 0 sin mediciones [ppm].
+ */
+static inline uint32_t metricas_ppm_media(const metricas_t *m)
+{
+	return m->ppm_ticks ? ((m->ppm_suma + (m->ppm_ticks / 2)) / m->ppm_ticks) : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METRICAS_H_ */
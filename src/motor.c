@@ -0,0 +1,133 @@
+/*
+===============================================================================
+ Nombre      : motor.c
+ Description : PWM del motor (PWM1.1, P1.18) con frecuencia configurable
+===============================================================================
+*/
+
+#include "lpc17xx_pwm.h"
+#include "lpc17xx_clkpwr.h"
+#include "motor.h"
+#include "ram.h"
+
+static uint32_t periodo = 0; // Cuentas de PCLK por período (MR0)
+static uint32_t pclk = 0;
+
+/**
+ * @brief Esta función configura PWM1.1 en modo single-edge con
+ * 		  la frecuencia más cercana a la pedida.
+ *
+ * @details El PWM corre a PCLK = CCLK (fijado en reloj_init) sin
+ * 			prescaler, que es la mayor resolución posible: el período
+ * 			tiene PCLK / frecuencia cuentas (6000 a 20[KHz] con CCLK =
+ * 			120[MHz], 0.017% por cuenta). MR0 interrumpe al comienzo de
+ * 			cada período. Se vuelve a llamar después de un cambio de
+ * 			reloj (ver reloj.h).
+ * 			El PWM queda detenido y con duty 0 hasta motor_cmd.
+ *
+ * @return Cantidad de cuentas del período, es decir, la cantidad de
+ * 		   pasos distintos de duty.
+ */
+uint32_t motor_init(uint32_t frecuencia)
+{
+	PWM_TIMERCFG_Type config;
+	PWM_MATCHCFG_Type config_match;
+
+	pclk = CLKPWR_GetPCLK(CLKPWR_PCLKSEL_PWM1);
+	periodo = (pclk + (frecuencia / 2)) / frecuencia;
+
+	config.PrescaleOption = PWM_TIMER_PRESCALE_TICKVAL;
+	config.PrescaleValue = 1;
+
+	PWM_Init(LPC_PWM1, PWM_MODE_TIMER, &config);
+
+	PWM_ChannelConfig(LPC_PWM1, 1, PWM_CHANNEL_SINGLE_EDGE);
+	PWM_MatchUpdate(LPC_PWM1, 0, periodo, PWM_MATCH_UPDATE_NEXT_RST);
+	PWM_MatchUpdate(LPC_PWM1, 1, 0, PWM_MATCH_UPDATE_NEXT_RST);
+
+	config_match.MatchChannel = 0;
+	config_match.IntOnMatch = ENABLE;
+	config_match.StopOnMatch = DISABLE;
+	config_match.ResetOnMatch = ENABLE; // Reseteo del TC del PWM en match con PWM1MR0
+
+	PWM_ConfigMatch(LPC_PWM1, &config_match);
+	PWM_ChannelCmd(LPC_PWM1, 1, ENABLE); // Habilitar output de PWM
+	PWM_ResetCounter(LPC_PWM1);
+
+	NVIC_SetPriority(PWM1_IRQn, 4);
+	NVIC_EnableIRQ(PWM1_IRQn);
+
+	return periodo;
+}
+
+/**
+ * @brief Esta función arranca o detiene el PWM.
+ */
+void motor_cmd(FunctionalState estado)
+{
+	if (estado == ENABLE)
+	{
+		PWM_Cmd(LPC_PWM1, ENABLE); // Modo PWM
+		PWM_CounterCmd(LPC_PWM1, ENABLE);
+	}
+	else
+	{
+		PWM_Cmd(LPC_PWM1, DISABLE);
+		PWM_CounterCmd(LPC_PWM1, DISABLE);
+	}
+}
+
+/**
+ * @brief Esta función carga un nuevo duty (Q16) en MR1, que se
+ * 		  aplica al comienzo del siguiente período.
+ *
+ * @details Se llama desde PWM1_IRQHandler, que se sigue atendiendo
+ * 			mientras el IAP programa (ver ram.h), así que escribe MR1
+ * 			y LER sin pasar por el driver, que está en la flash.
+ */
+EN_RAM void motor_duty(uint32_t duty)
+{
+	if (duty > MOTOR_DUTY_MAX)
+		duty = MOTOR_DUTY_MAX;
+
+	LPC_PWM1->MR1 = (uint32_t)((((uint64_t)duty * periodo) + (1 << 15)) >> 16);
+	LPC_PWM1->LER = PWM_LER_EN_MATCHn_LATCH(1);
+}
+
+/**
+ * @brief Esta función debe llamarse desde PWM1_IRQHandler.
+ *
+ * @return 1 si la interrupción es la del comienzo de un período
+ * 		   (MR0), cuyo flag queda limpio.
+ */
+EN_RAM uint8_t motor_irq(void)
+{
+	if (!(LPC_PWM1->IR & PWM_IR_PWMMRn(0)))
+		return 0;
+
+	LPC_PWM1->IR = PWM_IR_PWMMRn(0);
+
+	return 1;
+}
+
+/**
+ * @brief Devuelve 1 si el PWM está en marcha (ver motor_cmd).
+ */
+uint8_t motor_activo(void)
+{
+	return (LPC_PWM1->TCR & PWM_TCR_PWM_ENABLE) != 0;
+}
+
+uint32_t motor_periodo(void)
+{
+	return periodo;
+}
+
+/**
+ * @brief Devuelve la frecuencia obtenida [Hz], que difiere de la
+ * 		  pedida si PCLK no es múltiplo de ella.
+ */
+uint32_t motor_frecuencia(void)
+{
+	return periodo ? (pclk / periodo) : 0;
+}
@@ -0,0 +1,24 @@
+/*
+===============================================================================
+ Nombre      : motor.h
+ Description : PWM del motor (PWM1.1, P1.18) con frecuencia configurable
+===============================================================================
+*/
+
+#ifndef MOTOR_H_
+#define MOTOR_H_
+
+#include "lpc17xx.h"
+
+#define MOTOR_FRECUENCIA 20000 // [Hz], fuera del rango audible
+#define MOTOR_DUTY_MAX 65535 // Duty en Q16: 65535 = 100%
+
+uint32_t motor_init(uint32_t frecuencia);
+void motor_cmd(FunctionalState estado);
+void motor_duty(uint32_t duty);
+uint8_t motor_irq(void);
+uint8_t motor_activo(void);
+uint32_t motor_periodo(void);
+uint32_t motor_frecuencia(void);
+
+#endif /* MOTOR_H_ */
@@ -0,0 +1,208 @@
+/*
+===============================================================================
+ Nombre      : perfil.c
+ Description : Medición de la duración de los handlers de interrupción
+               con el contador de ciclos del DWT
+===============================================================================
+*/
+
+#include "perfil.h"
+
+#if PERFIL_HABILITADO
+
+#include "ciclos.h"
+#include "ram.h"
+#include "trama.h"
+#include "uart_tx.h"
+
+/**
+ * @brief Handler en curso. Se apilan tantos como niveles de
+ * 		  anidamiento haya.
+ */
+typedef struct
+{
+	uint32_t entrada;
+	uint32_t preempcion; // Ciclos consumidos por handlers anidados
+} marco_t;
+
+static marco_t pila[PERFIL_CANTIDAD];
+static uint8_t profundidad = 0;
+static perfil_stats_t stats[PERFIL_CANTIDAD];
+
+static volatile uint8_t volcando = 0; // Lo consulta DMA_IRQHandler
+static uint8_t volcado_id = 0;
+static uint8_t volcado_seq = 0;
+
+static void escribir32(uint8_t *p, uint32_t v);
+
+void perfil_init(void)
+{
+	for (uint8_t i = 0; i < PERFIL_CANTIDAD; i++)
+	{
+		stats[i].cuenta = 0;
+		stats[i].min = 0xffffffff;
+		stats[i].max = 0;
+		stats[i].suma = 0;
+		stats[i].preempcion = 0;
+		stats[i].anidamiento_max = 0;
+
+		for (uint8_t j = 0; j < PERFIL_BINS; j++)
+			stats[i].histograma[j] = 0;
+	}
+
+	profundidad = 0;
+
+	ciclos_init();
+}
+
+/**
+ * @brief Esta función se llama al comienzo del handler medido.
+ *
+ * @details Las operaciones sobre la pila se hacen con PRIMASK
+ * 			activo (unos pocos ciclos) para que un handler anidado
+ * 			no se intercale entre la lectura del contador y el apilado.
+ */
+EN_RAM void perfil_entrar(perfil_isr_t id)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	if (profundidad < PERFIL_CANTIDAD)
+	{
+		marco_t *m = &pila[profundidad++];
+
+		m->preempcion = 0;
+		m->entrada = ciclos_leer();
+
+		if (profundidad > stats[id].anidamiento_max)
+			stats[id].anidamiento_max = profundidad;
+	}
+
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Esta función se llama al final del handler medido.
+ *
+ * @details El tiempo total del handler se descuenta del handler que
+ * 			interrumpió, que queda debajo en la pila.
+ */
+EN_RAM void perfil_salir(perfil_isr_t id)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	if (profundidad)
+	{
+		marco_t *m = &pila[--profundidad];
+		uint32_t total = ciclos_leer() - m->entrada;
+		uint32_t neto = total - m->preempcion;
+		perfil_stats_t *s = &stats[id];
+
+		if (profundidad)
+			pila[profundidad - 1].preempcion += total;
+
+		s->cuenta++;
+		s->suma += neto;
+		s->preempcion += m->preempcion;
+
+		if (neto < s->min)
+			s->min = neto;
+
+		if (neto > s->max)
+			s->max = neto;
+
+		int32_t bin = (neto ? (31 - __CLZ(neto)) : 0) - (PERFIL_BIN_MIN - 1);
+
+		if (bin < 0)
+			bin = 0;
+		else if (bin >= PERFIL_BINS)
+			bin = PERFIL_BINS - 1;
+
+		if (s->histograma[bin] != 0xffff)
+			s->histograma[bin]++;
+	}
+
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Esta función copia las estadísticas de un handler.
+ */
+void perfil_estadisticas(perfil_isr_t id, perfil_stats_t *s)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	*s = stats[id];
+
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Esta función comienza el envío de las estadísticas por
+ * 		  UART2, una trama de tipo TRAMA_TIPO_PERFIL por handler.
+ *
+ * @details Payload (little-endian): id (1 B), anidamiento máximo (1 B),
+ * 			cuenta, mínimo, máximo, media y preempción media (4 B c/u)
+ * 			e histograma (PERFIL_BINS x 2 B).
+ */
+void perfil_volcar(void)
+{
+	volcado_id = 0;
+	volcando = 1;
+
+	perfil_volcar_continuar();
+}
+
+/**
+ * @brief Esta función arma tramas de estadísticas mientras haya
+ * 		  buffers de trama libres. Se llama a nivel de tarea.
+ */
+void perfil_volcar_continuar(void)
+{
+	while (volcando && uart_tx_tramas_libres())
+	{
+		perfil_stats_t s;
+		uint8_t payload[22 + (2 * PERFIL_BINS)];
+
+		perfil_estadisticas(volcado_id, &s);
+
+		payload[0] = volcado_id;
+		payload[1] = s.anidamiento_max;
+		escribir32(&payload[2], s.cuenta);
+		escribir32(&payload[6], s.cuenta ? s.min : 0);
+		escribir32(&payload[10], s.max);
+		escribir32(&payload[14], s.cuenta ? (uint32_t)(s.suma / s.cuenta) : 0);
+		escribir32(&payload[18], s.cuenta ? (uint32_t)(s.preempcion / s.cuenta) : 0);
+
+		for (uint8_t i = 0; i < PERFIL_BINS; i++)
+		{
+			payload[22 + (2 * i)] = s.histograma[i] & 0xff;
+			payload[23 + (2 * i)] = s.histograma[i] >> 8;
+		}
+
+		uint8_t *trama = uart_tx_trama_obtener();
+
+		uart_tx_trama_enviar(trama, trama_armar(trama, TRAMA_TIPO_PERFIL, volcado_seq++, payload, sizeof(payload)));
+
+		if (++volcado_id == PERFIL_CANTIDAD)
+			volcando = 0;
+	}
+}
+
+uint8_t perfil_volcando(void)
+{
+	return volcando;
+}
+
+static void escribir32(uint8_t *p, uint32_t v)
+{
+	for (uint8_t i = 0; i < 4; i++)
+		p[i] = (v >> (8 * i)) & 0xff;
+}
+
+#endif
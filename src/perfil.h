@@ -0,0 +1,86 @@
+/*
+===============================================================================
+ Nombre      : perfil.h
+ Description : Medición de la duración de los handlers de interrupción
+               con el contador de ciclos del DWT
+
+ Sólo se compila en la configuración Debug (DEBUG definido) o si se
+ define PERFIL_HABILITADO en 1; en Release las macros no generan código.
+===============================================================================
+*/
+
+#ifndef PERFIL_H_
+#define PERFIL_H_
+
+#include "lpc17xx.h"
+
+#ifndef PERFIL_HABILITADO
+#ifdef DEBUG
+#define PERFIL_HABILITADO 1
+#else
+#define PERFIL_HABILITADO 0
+#endif
+#endif
+
+#define PERFIL_BINS 16 // Histograma log2: bin 0 < 32 ciclos, bin 15 >= 2^19 ciclos
+#define PERFIL_BIN_MIN 5
+
+/**
+ * @brief Handlers medidos.
+ */
+typedef enum
+{
+	PERFIL_RIT = 0,
+	PERFIL_TIMER1,
+	PERFIL_TIMER3,
+	PERFIL_UART2,
+	PERFIL_DMA,
+	PERFIL_QEI,
+	PERFIL_PWM,
+	PERFIL_CANTIDAD
+} perfil_isr_t;
+
+/**
+ * @brief Estadísticas de un handler [ciclos].
+ *
+ * @details Los tiempos son exclusivos: no incluyen lo que el handler
+ * 			estuvo interrumpido por otros de mayor prioridad, que se
+ * 			acumula aparte en preempcion.
+ */
+typedef struct
+{
+	uint32_t cuenta;
+	uint32_t min;
+	uint32_t max;
+	uint64_t suma;
+	uint64_t preempcion;
+	uint8_t anidamiento_max; // Handlers activos al entrar, incluido éste
+	uint16_t histograma[PERFIL_BINS];
+} perfil_stats_t;
+
+#if PERFIL_HABILITADO
+
+#define PERFIL_ENTRAR(id) perfil_entrar(id)
+#define PERFIL_SALIR(id) perfil_salir(id)
+
+void perfil_init(void);
+void perfil_entrar(perfil_isr_t id);
+void perfil_salir(perfil_isr_t id);
+void perfil_estadisticas(perfil_isr_t id, perfil_stats_t *stats);
+void perfil_volcar(void);
+void perfil_volcar_continuar(void);
+uint8_t perfil_volcando(void);
+
+#else
+
+#define PERFIL_ENTRAR(id) ((void)0)
+#define PERFIL_SALIR(id) ((void)0)
+
+#define perfil_init() ((void)0)
+#define perfil_volcar() ((void)0)
+#define perfil_volcar_continuar() ((void)0)
+#define perfil_volcando() 0
+
+#endif
+
+#endif /* PERFIL_H_ */
@@ -0,0 +1,75 @@
+/*
+===============================================================================
+ Nombre      : pid.c
+ Description : Controlador PID en punto fijo con anti-windup
+===============================================================================
+*/
+
+#include "pid.h"
+#include "ram.h"
+
+void pid_init(pid_control_t *pid, int32_t kp, int32_t ki, int32_t kd, int32_t salida_min, int32_t salida_max)
+{
+	pid->kp = kp;
+	pid->ki = ki;
+	pid->kd = kd;
+	pid->salida_min = salida_min;
+	pid->salida_max = salida_max;
+
+	pid_reiniciar(pid);
+}
+
+/**
+ * @brief Esta función descarta el estado acumulado (integral y
+ * 		  medida anterior).
+ */
+void pid_reiniciar(pid_control_t *pid)
+{
+	pid->integral = 0;
+	pid->medida_anterior = 0;
+	pid->primera = 1;
+}
+
+/**
+ * @brief Esta función ejecuta un paso del lazo.
+ *
+ * @details salida = prealimentación + Kp * e + I - Kd * Δmedida, con
+ * 			e = referencia - medida, saturada a [salida_min, salida_max].
+ * 			Anti-windup por integración condicional: con la salida
+ * 			saturada, la integral sólo acepta errores que la saquen de
+ * 			la saturación, así que no sigue creciendo mientras el
+ * 			actuador está al límite.
+ *
+ * @return Salida a aplicar al actuador.
+ */
+EN_RAM int32_t pid_paso(pid_control_t *pid, int32_t referencia, int32_t medida, int32_t prealimentacion)
+{
+	int32_t e = referencia - medida;
+	int32_t dm = pid->primera ? 0 : (medida - pid->medida_anterior);
+
+	pid->primera = 0;
+	pid->medida_anterior = medida;
+
+	int64_t pd = ((int64_t)pid->kp * e) - ((int64_t)pid->kd * dm);
+	int64_t integral = pid->integral + ((int64_t)pid->ki * e);
+	int64_t salida = prealimentacion + ((pd + integral + (1 << 15)) >> 16);
+
+	if (salida > pid->salida_max)
+	{
+		salida = pid->salida_max;
+
+		if (e < 0)
+			pid->integral = integral;
+	}
+	else if (salida < pid->salida_min)
+	{
+		salida = pid->salida_min;
+
+		if (e > 0)
+			pid->integral = integral;
+	}
+	else
+		pid->integral = integral;
+
+	return (int32_t)salida;
+}
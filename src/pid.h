@@ -0,0 +1,44 @@
+/*
+===============================================================================
+ Nombre      : pid.h
+ Description : Controlador PID en punto fijo con anti-windup
+
+ Las ganancias están en Q16.16 (ver PF_Q16 en punto_fijo.h) y convierten
+ unidades de la medida en unidades de la salida por paso del lazo. El
+ término derivativo actúa sobre la medida, no sobre el error, para que
+ un cambio de referencia no produzca un pico en la salida.
+
+ Este módulo no depende del hardware.
+===============================================================================
+*/
+
+#ifndef PID_H_
+#define PID_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+	int32_t kp; // Q16
+	int32_t ki; // Q16, por paso
+	int32_t kd; // Q16, por paso
+	int32_t salida_min;
+	int32_t salida_max;
+	int64_t integral; // Q16, en unidades de la salida
+	int32_t medida_anterior;
+	uint8_t primera;
+} pid_control_t;
+
+void pid_init(pid_control_t *pid, int32_t kp, int32_t ki, int32_t kd, int32_t salida_min, int32_t salida_max);
+void pid_reiniciar(pid_control_t *pid);
+int32_t pid_paso(pid_control_t *pid, int32_t referencia, int32_t medida, int32_t prealimentacion);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PID_H_ */
@@ -0,0 +1,149 @@
+/*
+===============================================================================
+ Nombre      : planificador.c
+ Description : Planificador de eventos run-to-completion con WFI
+===============================================================================
+*/
+
+#include "planificador.h"
+#include "ciclos.h"
+#include "ram.h"
+
+static plan_handler_t handlers[EV_CANTIDAD];
+static volatile uint32_t pendientes[EV_CANTIDAD]; // Publicaciones sin despachar
+static volatile uint32_t t_primera[EV_CANTIDAD]; // Ciclo de la primera publicación pendiente
+static volatile uint32_t publicados[EV_CANTIDAD];
+static plan_stats_t stats[EV_CANTIDAD];
+
+static uint32_t sumar(volatile uint32_t *p, uint32_t v);
+static uint32_t tomar(volatile uint32_t *p);
+
+void plan_init(void)
+{
+	for (uint8_t i = 0; i < EV_CANTIDAD; i++)
+	{
+		handlers[i] = 0;
+		pendientes[i] = 0;
+		publicados[i] = 0;
+
+		stats[i].despachos = 0;
+		stats[i].profundidad_max = 0;
+		stats[i].latencia_max = 0;
+		stats[i].latencia_ultima = 0;
+	}
+
+	ciclos_init();
+}
+
+void plan_registrar(evento_t ev, plan_handler_t handler)
+{
+	handlers[ev] = handler;
+}
+
+/**
+ * @brief Esta función publica un evento. Puede llamarse desde
+ * 		  cualquier handler de interrupción.
+ *
+ * @details Cada tipo de evento tiene un contador de publicaciones
+ * 			que se incrementa con LDREX/STREX, sin deshabilitar
+ * 			interrupciones. Como toda excepción limpia el monitor
+ * 			exclusivo, una ISR que interrumpa a otra en medio del
+ * 			incremento hace que ésta reintente.
+ * 			La primera publicación pendiente guarda el instante para
+ * 			medir la latencia hasta el despacho.
+ */
+EN_RAM void plan_publicar(evento_t ev)
+{
+	if (sumar(&pendientes[ev], 1) == 1)
+		t_primera[ev] = ciclos_leer();
+
+	sumar(&publicados[ev], 1);
+}
+
+/**
+ * @brief Esta función se llama en el lazo de main.
+ *
+ * @details Despacha, en orden de prioridad, el evento pendiente más
+ * 			urgente y vuelve; cada handler corre hasta terminar.
+ * 			Las publicaciones acumuladas de un mismo tipo se atienden
+ * 			con un solo despacho (los datos viven en la cola de cada
+ * 			módulo). Si no hay nada pendiente, se duerme con WFI:
+ * 			la comprobación se hace con PRIMASK activo para que una
+ * 			interrupción entre la comprobación y el WFI no se pierda
+ * 			(WFI despierta igual con interrupciones enmascaradas).
+ */
+void plan_ejecutar(void)
+{
+	for (uint8_t ev = 0; ev < EV_CANTIDAD; ev++)
+	{
+		if (pendientes[ev] == 0)
+			continue;
+
+		uint32_t t = ciclos_leer() - t_primera[ev];
+		uint32_t n = tomar(&pendientes[ev]);
+
+		stats[ev].despachos++;
+		stats[ev].latencia_ultima = t;
+
+		if (t > stats[ev].latencia_max)
+			stats[ev].latencia_max = t;
+
+		if (n > stats[ev].profundidad_max)
+			stats[ev].profundidad_max = n;
+
+		if (handlers[ev])
+			handlers[ev]();
+
+		return;
+	}
+
+	__disable_irq();
+
+	uint32_t hay = 0;
+
+	for (uint8_t ev = 0; ev < EV_CANTIDAD; ev++)
+		hay |= pendientes[ev];
+
+	if (!hay)
+		__WFI();
+
+	__enable_irq();
+}
+
+/**
+ * @brief Esta función copia las estadísticas de un tipo de evento.
+ */
+void plan_estadisticas(evento_t ev, plan_stats_t *s)
+{
+	*s = stats[ev];
+
+	s->publicados = publicados[ev];
+}
+
+/**
+ * @brief Suma atómica; devuelve el valor resultante.
+ */
+EN_RAM static uint32_t sumar(volatile uint32_t *p, uint32_t v)
+{
+	uint32_t x;
+
+	do
+		x = __LDREXW((uint32_t *)p) + v;
+	while (__STREXW(x, (uint32_t *)p));
+
+	return x;
+}
+
+/**
+ * @brief Intercambio atómico con 0; devuelve el valor anterior.
+ */
+static uint32_t tomar(volatile uint32_t *p)
+{
+	uint32_t x;
+
+	do
+		x = __LDREXW((uint32_t *)p);
+	while (__STREXW(0, (uint32_t *)p));
+
+	return x;
+}
@@ -0,0 +1,49 @@
+/*
+===============================================================================
+ Nombre      : planificador.h
+ Description : Planificador de eventos run-to-completion con WFI
+===============================================================================
+*/
+
+#ifndef PLANIFICADOR_H_
+#define PLANIFICADOR_H_
+
+#include "lpc17xx.h"
+
+/**
+ * @brief Eventos, en orden de prioridad (el primero es el más urgente).
+ */
+typedef enum
+{
+	EV_ADC = 0,     // Mitad del buffer del ADC completa
+	EV_TECLADO,     // Hay eventos en la cola del teclado
+	EV_COMANDO,     // Llegaron tramas de comando por UART2
+	EV_RUEDA,       // Venció un tick de la rueda de timers
+	EV_SEGUNDO,     // Tick de 1[s]
+	EV_TELEMETRIA,  // Toca enviar una trama de telemetría
+	EV_VOLCADO,     // Se liberó un buffer de trama durante el volcado de la sesión
+	EV_DETENIDO,    // La rampa de frenado llegó a 0
+	EV_CANTIDAD
+} evento_t;
+
+typedef void (*plan_handler_t)(void);
+
+/**
+ * @brief Estadísticas de un tipo de evento.
+ */
+typedef struct
+{
+	uint32_t publicados;
+	uint32_t despachos; // Veces que se ejecutó el handler
+	uint32_t profundidad_max; // Máximo de publicaciones acumuladas antes de un despacho
+	uint32_t latencia_max; // Máximo entre la primera publicación y el despacho [ciclos]
+	uint32_t latencia_ultima; // [ciclos]
+} plan_stats_t;
+
+void plan_init(void);
+void plan_registrar(evento_t ev, plan_handler_t handler);
+void plan_publicar(evento_t ev);
+void plan_ejecutar(void);
+void plan_estadisticas(evento_t ev, plan_stats_t *stats);
+
+#endif /* PLANIFICADOR_H_ */
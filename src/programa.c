@@ -0,0 +1,169 @@
+/*
+===============================================================================
+ Nombre      : programa.c
+ Description : Programas de entrenamiento por segmentos (duración, velocidad)
+===============================================================================
+*/
+
+#include "programa.h"
+
+#define CANTIDAD(x) (sizeof(x) / sizeof((x)[0]))
+
+// Caminata: entrada en calor, ritmo sostenido y vuelta a la calma
+static const programa_segmento_t caminata[] =
+{
+	PROGRAMA_SEG(300, 40),
+	PROGRAMA_SEG(1200, 55),
+	PROGRAMA_SEG(300, 35)
+};
+
+// Intervalos: 6 series de 1[min] rápido y 1.5[min] de recuperación
+static const programa_segmento_t intervalos[] =
+{
+	PROGRAMA_SEG(300, 50),
+	PROGRAMA_SEG(60, 120), PROGRAMA_SEG(90, 60),
+	PROGRAMA_SEG(60, 120), PROGRAMA_SEG(90, 60),
+	PROGRAMA_SEG(60, 120), PROGRAMA_SEG(90, 60),
+	PROGRAMA_SEG(60, 120), PROGRAMA_SEG(90, 60),
+	PROGRAMA_SEG(60, 120), PROGRAMA_SEG(90, 60),
+	PROGRAMA_SEG(60, 120), PROGRAMA_SEG(90, 60),
+	PROGRAMA_SEG(300, 40)
+};
+
+// Pirámide: la velocidad sube y baja de a 2[Km/h] cada 3[min]
+static const programa_segmento_t piramide[] =
+{
+	PROGRAMA_SEG(180, 50),
+	PROGRAMA_SEG(180, 70),
+	PROGRAMA_SEG(180, 90),
+	PROGRAMA_SEG(180, 110),
+	PROGRAMA_SEG(180, 90),
+	PROGRAMA_SEG(180, 70),
+	PROGRAMA_SEG(180, 50)
+};
+
+static const programa_t programas[] =
+{
+	{ caminata, CANTIDAD(caminata) },
+	{ intervalos, CANTIDAD(intervalos) },
+	{ piramide, CANTIDAD(piramide) }
+};
+
+_Static_assert(CANTIDAD(programas) <= 9, "Los programas se eligen con un solo dígito (1-9)");
+_Static_assert(CANTIDAD(caminata) <= PROGRAMA_SEGMENTOS_MAX, "Demasiados segmentos");
+_Static_assert(CANTIDAD(intervalos) <= PROGRAMA_SEGMENTOS_MAX, "Demasiados segmentos");
+_Static_assert(CANTIDAD(piramide) <= PROGRAMA_SEGMENTOS_MAX, "Demasiados segmentos");
+
+static const programa_t *actual = 0; // NULL = sin programa
+static uint8_t segmento = 0;
+static uint16_t restante = 0; // Segundos que le quedan al segmento
+static uint8_t pausado = 0;
+
+uint8_t programa_cantidad(void)
+{
+	return CANTIDAD(programas);
+}
+
+/**
+ * @brief Esta función comienza el programa n (desde 0) por su
+ * 		  primer segmento. La velocidad a aplicar se obtiene con
+ * 		  programa_velocidad.
+ */
+void programa_iniciar(uint8_t n)
+{
+	if (n >= CANTIDAD(programas))
+		return;
+
+	actual = &programas[n];
+	segmento = 0;
+	restante = actual->segmentos[0].duracion_s;
+	pausado = 0;
+}
+
+void programa_cancelar(void)
+{
+	actual = 0;
+}
+
+/**
+ * @brief Esta función se llama una vez por segundo, a nivel de
+ * 		  tarea.
+ *
+ * @details El cambio de segmento ocurre exactamente en el tick en el
+ * 			que se agota su duración; entre ticks no se hace nada.
+ * 			Al terminar el último segmento, el programa finaliza con
+ * 			velocidad 0.
+ *
+ * @return 1 si cambió la velocidad a aplicar.
+ */
+uint8_t programa_tick(void)
+{
+	if ((actual == 0) || pausado)
+		return 0;
+
+	if (--restante)
+		return 0;
+
+	return programa_saltar();
+}
+
+/**
+ * @brief Esta función pasa al siguiente segmento.
+ *
+ * @return 1 si cambió la velocidad a aplicar.
+ */
+uint8_t programa_saltar(void)
+{
+	if (actual == 0)
+		return 0;
+
+	if (++segmento >= actual->cantidad)
+	{
+		actual = 0;
+
+		return 1;
+	}
+
+	restante = actual->segmentos[segmento].duracion_s;
+
+	return 1;
+}
+
+/**
+ * @brief Esta función pausa o reanuda el programa. En pausa, el
+ * 		  segmento no avanza y la velocidad no cambia.
+ */
+void programa_pausa(void)
+{
+	if (actual)
+		pausado = !pausado;
+}
+
+uint8_t programa_activo(void)
+{
+	return actual != 0;
+}
+
+uint8_t programa_pausado(void)
+{
+	return pausado;
+}
+
+uint8_t programa_segmento(void)
+{
+	return segmento;
+}
+
+uint16_t programa_restante_s(void)
+{
+	return restante;
+}
+
+/**
+ * @brief Devuelve la velocidad del segmento en curso, o 0 si no
+ * 		  hay programa [décimas de Km/h].
+ */
+uint32_t programa_velocidad(void)
+{
+	return actual ? actual->segmentos[segmento].velocidad : 0;
+}
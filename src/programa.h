@@ -0,0 +1,54 @@
+/*
+===============================================================================
+ Nombre      : programa.h
+ Description : Programas de entrenamiento por segmentos (duración, velocidad)
+===============================================================================
+*/
+
+#ifndef PROGRAMA_H_
+#define PROGRAMA_H_
+
+#include <stdint.h>
+
+#define PROGRAMA_VEL_MAX 200 // [décimas de Km/h], igual a MAX_SPEED
+#define PROGRAMA_SEGMENTOS_MAX 32
+
+/**
+ * @brief Segmento de un programa.
+ */
+typedef struct
+{
+	uint16_t duracion_s;
+	uint16_t velocidad; // [décimas de Km/h]
+} programa_segmento_t;
+
+/**
+ * @brief Programa: tabla de segmentos en flash.
+ */
+typedef struct
+{
+	const programa_segmento_t *segmentos;
+	uint8_t cantidad;
+} programa_t;
+
+/*
+ * Segmento verificado en compilación: una duración nula o una velocidad
+ * fuera de rango da un arreglo de tamaño negativo (error de compilación).
+ */
+#define PROGRAMA_SEG(t, v) { (t) + (0 * sizeof(char[(((t) > 0) && ((t) <= 0xffff)) ? 1 : -1])), \
+							 (v) + (0 * sizeof(char[((v) <= PROGRAMA_VEL_MAX) ? 1 : -1])) }
+
+uint8_t programa_cantidad(void);
+void programa_iniciar(uint8_t n);
+void programa_cancelar(void);
+uint8_t programa_tick(void);
+uint8_t programa_saltar(void);
+void programa_pausa(void);
+
+uint8_t programa_activo(void);
+uint8_t programa_pausado(void);
+uint8_t programa_segmento(void);
+uint16_t programa_restante_s(void);
+uint32_t programa_velocidad(void);
+
+#endif /* PROGRAMA_H_ */
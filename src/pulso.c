@@ -0,0 +1,163 @@
+/*
+===============================================================================
+ Nombre      : pulso.c
+ Description : Estimación de la frecuencia cardíaca a partir de capturas
+===============================================================================
+*/
+
+#include "pulso.h"
+#include "ram.h"
+
+#define TICKS_POR_MINUTO (60000000UL / PULSO_TICK_US)
+#define INTERVALO_MIN (TICKS_POR_MINUTO / PULSO_PPM_MAX)
+#define INTERVALO_MAX (TICKS_POR_MINUTO / PULSO_PPM_MIN)
+
+static uint32_t intervalos[PULSO_VENTANA]; // Últimos intervalos válidos [ticks]
+static uint8_t indice = 0; // Próxima posición a reemplazar
+static uint8_t cantidad = 0; // Intervalos válidos en la ventana
+static uint32_t suma = 0; // Suma de los intervalos de la ventana
+static uint32_t t_anterior = 0; // Captura desde la que se mide el próximo intervalo
+static uint32_t t_aceptado = 0; // Captura del último latido aceptado en la ventana
+static uint8_t primero = 1; // Flag para indicar que no hay latido de referencia
+static uint8_t rechazos_seguidos = 0;
+static uint32_t rechazados = 0;
+static volatile uint32_t ppm_x10 = 0;
+
+static void reiniciar_ventana(void);
+
+void pulso_init(void)
+{
+	reiniciar_ventana();
+
+	primero = 1;
+	rechazados = 0;
+	t_aceptado = 0;
+}
+
+/**
+ * @brief Esta función procesa un nuevo latido.
+ *
+ * @details Se llama desde TIMER3_IRQHandler con el valor de 32 bits
+ * 			del registro de captura. El intervalo se calcula en
+ * 			aritmética sin signo, por lo que el desborde del timer
+ * 			no afecta el resultado.
+ * 			- Un intervalo menor al mínimo fisiológico es un rebote o
+ * 			  un doble conteo: se ignora la captura y se sigue midiendo
+ * 			  desde el último latido válido.
+ * 			- Un intervalo mayor al máximo indica que se perdió la
+ * 			  señal: se reinicia la ventana, sin medición, tomando
+ * 			  este latido como referencia.
+ * 			- Un intervalo que se aparta más de PULSO_DESVIO_MAX % de la
+ * 			  media se rechaza, salvo que se repita PULSO_RECHAZOS_MAX
+ * 			  veces seguidas (el ritmo cambió de verdad). El próximo
+ * 			  intervalo se mide desde este latido.
+ * 			La suma se actualiza restando el intervalo que sale de la
+ * 			ventana y sumando el nuevo, por lo que el costo es
+ * 			constante independientemente de PULSO_VENTANA.
+ */
+EN_RAM void pulso_capturar(uint32_t t)
+{
+	if (primero)
+	{
+		t_anterior = t;
+		primero = 0;
+
+		return;
+	}
+
+	uint32_t intervalo = t - t_anterior;
+
+	if (intervalo < INTERVALO_MIN)
+	{
+		rechazados++;
+
+		return;
+	}
+
+	t_anterior = t;
+
+	if (intervalo > INTERVALO_MAX)
+	{
+		rechazados++;
+
+		reiniciar_ventana();
+
+		return;
+	}
+
+	if (cantidad >= 2)
+	{
+		uint32_t desvio = (suma * PULSO_DESVIO_MAX) / 100; // Tolerancia escalada por cantidad
+		uint32_t esperado = intervalo * cantidad;
+
+		if ((esperado > suma + desvio) || (esperado + desvio < suma))
+		{
+			rechazados++;
+
+			if (++rechazos_seguidos < PULSO_RECHAZOS_MAX)
+				return;
+
+			reiniciar_ventana();
+		}
+	}
+
+	rechazos_seguidos = 0;
+
+	if (cantidad == PULSO_VENTANA)
+		suma -= intervalos[indice];
+	else
+		cantidad++;
+
+	intervalos[indice] = intervalo;
+	suma += intervalo;
+	indice = (indice + 1) % PULSO_VENTANA;
+	t_aceptado = t;
+
+	ppm_x10 = ((10 * TICKS_POR_MINUTO * cantidad) + (suma / 2)) / suma;
+}
+
+/**
+ * @brief Devuelve la frecuencia cardíaca en décimas de pulsaciones
+ * 		  por minuto, o 0 si todavía no hay medición.
+ */
+EN_RAM uint32_t pulso_ppm_x10(void)
+{
+	return ppm_x10;
+}
+
+/**
+ * @brief Devuelve la frecuencia cardíaca redondeada en pulsaciones por minuto.
+ */
+EN_RAM uint32_t pulso_ppm(void)
+{
+	return (ppm_x10 + 5) / 10;
+}
+
+/**
+ * @brief Devuelve la captura del último latido aceptado [ticks de PULSO_TICK_US].
+ *
+ * @details Los latidos rechazados no cuentan: con la señal perdida o
+ * 			ruidosa, la antigüedad de este latido sigue creciendo.
+ */
+EN_RAM uint32_t pulso_t_ultimo(void)
+{
+	return t_aceptado;
+}
+
+uint32_t pulso_rechazados(void)
+{
+	return rechazados;
+}
+
+/**
+ * @brief Descarta la ventana y la medición, que ya no corresponde al
+ * 		  ritmo actual.
+ */
+EN_RAM static void reiniciar_ventana(void)
+{
+	indice = 0;
+	cantidad = 0;
+	suma = 0;
+	rechazos_seguidos = 0;
+	ppm_x10 = 0;
+}
@@ -0,0 +1,27 @@
+/*
+===============================================================================
+ Nombre      : pulso.h
+ Description : Estimación de la frecuencia cardíaca a partir de capturas
+===============================================================================
+*/
+
+#ifndef PULSO_H_
+#define PULSO_H_
+
+#include <stdint.h>
+
+#define PULSO_TICK_US 100 // Resolución del timer de captura [us]
+#define PULSO_VENTANA 8 // Latidos promediados
+#define PULSO_PPM_MIN 30 // Límites fisiológicos aceptados
+#define PULSO_PPM_MAX 220
+#define PULSO_DESVIO_MAX 40 // Desvío máximo respecto de la media [%]
+#define PULSO_RECHAZOS_MAX 3 // Rechazos seguidos tras los que se reinicia la ventana
+
+void pulso_init(void);
+void pulso_capturar(uint32_t t);
+uint32_t pulso_ppm_x10(void);
+uint32_t pulso_ppm(void);
+uint32_t pulso_t_ultimo(void);
+uint32_t pulso_rechazados(void);
+
+#endif /* PULSO_H_ */
@@ -0,0 +1,55 @@
+/*
+===============================================================================
+ Nombre      : punto_fijo.h
+ Description : Representación en punto fijo de las magnitudes del equipo
+
+ El Cortex-M3 no tiene FPU, así que ninguna magnitud se guarda en
+ float. Se usan enteros escalados con las siguientes unidades:
+
+   Magnitud      Tipo       Unidad                    Ejemplo
+   -----------   --------   -----------------------   ----------------
+   temperatura   int32_t    centésimas de ºC          2534 = 25.34[ºC]
+   velocidad     uint32_t   décimas de Km/h           125  = 12.5[Km/h]
+   vel. medida   uint32_t   m/h (milésimas de Km/h)   12500 = 12.5[Km/h]
+   distancia     uint32_t   metros                    1500 = 1.5[Km]
+   tiempo_s      uint32_t   segundos
+   ppm           uint32_t   pulsaciones por minuto    (pulso_ppm_x10 da décimas)
+   corriente     int32_t    mA
+   tension       int32_t    mV
+   inclinacion   int32_t    décimas de %              35   = 3.5[%]
+
+ Las ganancias de los canales del ADC se expresan en Q16.16
+ (65536 = 1.0), construidas con PF_Q16 a partir de una fracción.
+
+ Las conversiones son exactas en aritmética entera: sólo se redondea
+ al final, una vez.
+===============================================================================
+*/
+
+#ifndef PUNTO_FIJO_H_
+#define PUNTO_FIJO_H_
+
+#include <stdint.h>
+
+#define PF_MH_POR_DECIMA 100 // 0.1[Km/h] = 100[m/h]
+#define PF_Q16(num, den) ((int32_t)(((int64_t)(num) << 16) / (den)))
+
+/*
+ * LM35: 10[mV/ºC]. Con la calibración del equipo (0.08[ºC] por cuenta
+ * del ADC de 12 bits) cada cuenta equivale exactamente a 8 centésimas.
+ */
+#define PF_LM35_CENTI_POR_CUENTA 8
+
+/**
+ * @brief Escala una lectura con una ganancia en Q16.16 y suma el
+ * 		  offset, redondeando al entero más cercano.
+ *
+ * @details Es el único redondeo de la cadena de conversión de cada
+ * 			canal del ADC (ver adquisicion.h).
+ */
+static inline int32_t pf_escalar_q16(uint32_t x, int32_t ganancia_q16, int32_t offset)
+{
+	return (int32_t)((((int64_t)x * ganancia_q16) + (1 << 15)) >> 16) + offset;
+}
+
+#endif /* PUNTO_FIJO_H_ */
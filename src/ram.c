@@ -0,0 +1,19 @@
+/*
+===============================================================================
+ Nombre      : ram.c
+ Description : Ejecución de los handlers críticos y de la tabla de
+               vectores desde la SRAM local
+===============================================================================
+*/
+
+#include "ram.h"
+
+/**
+ * @brief Copia de la tabla de vectores, la llena ResetISR.
+ *
+ * @details El VTOR exige alinear la tabla a la potencia de 2 siguiente
+ * 			a su tamaño (51 palabras: 256 bytes). Está en el .bss de la
+ * 			SRAM local (0x10000000), que para el VTOR es región de
+ * 			código.
+ */
+__attribute__ ((aligned(256))) ram_vector_t ram_vectores[RAM_VECTORES];
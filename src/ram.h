@@ -0,0 +1,53 @@
+/*
+===============================================================================
+ Nombre      : ram.h
+ Description : Ejecución de los handlers críticos y de la tabla de
+               vectores desde la SRAM local
+
+ Los handlers marcados con EN_RAM van a la sección .ramfunc del banco
+ RAM (RamLoc32), que el linker administrado de MCUXpresso agrega a la
+ tabla de secciones de datos: ResetISR los copia junto con el .data,
+ sin cambios en el script del linker. La SRAM local está en los buses
+ I-Code/D-Code, sin estados de espera, así que la entrada al handler
+ no depende del acelerador de la flash.
+
+ ResetISR copia la tabla de vectores a ram_vectores y, si
+ RAM_HABILITADA es 1, apunta el VTOR ahí. Con RAM_HABILITADA en 0
+ todo queda en la flash, para comparar (ver latencia.h y perfil.h).
+
+ Los handlers de PWM1 y TIMER3 siguen habilitados mientras el IAP
+ programa la flash (ver iap.c), así que ni ellos ni nada de lo que
+ llaman puede estar en la flash: las funciones de los módulos que usan
+ van marcadas con EN_RAM, en lugar de los drivers acceden a los
+ registros desde motor.c y tiempo.c, y las funciones inline que usan
+ son always_inline para que no queden fuera de línea en Debug.
+
+ Este encabezado no depende del hardware, así que los módulos
+ portables pueden marcar funciones con EN_RAM; en la PC se compila
+ con RAM_HABILITADA en 0.
+===============================================================================
+*/
+
+#ifndef RAM_H_
+#define RAM_H_
+
+#include <stdint.h>
+
+#ifndef RAM_HABILITADA
+#define RAM_HABILITADA 1
+#endif
+
+#if RAM_HABILITADA
+#include <cr_section_macros.h>
+#define EN_RAM __RAMFUNC(RAM)
+#else
+#define EN_RAM
+#endif
+
+#define RAM_VECTORES (16 + 35) // Excepciones del núcleo e interrupciones del LPC175x/6x
+
+typedef void (*ram_vector_t)(void);
+
+extern ram_vector_t ram_vectores[RAM_VECTORES];
+
+#endif /* RAM_H_ */
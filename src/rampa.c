@@ -0,0 +1,99 @@
+/*
+===============================================================================
+ Nombre      : rampa.c
+ Description : Generador de rampas de velocidad con aceleración y
+               jerk limitados (curva S)
+===============================================================================
+*/
+
+#include "rampa.h"
+#include "ram.h"
+
+/**
+ * @brief Esta función fija los límites de la rampa.
+ *
+ * @param acel Aceleración máxima al subir la velocidad [m/h por s].
+ * @param decel Aceleración máxima al bajarla [m/h por s].
+ * @param jerk Variación máxima de la aceleración [m/h por s^2].
+ */
+void rampa_config(rampa_t *r, uint32_t acel, uint32_t decel, uint32_t jerk)
+{
+	r->acel = (int32_t)(((uint64_t)acel << 16) / RAMPA_PASOS_POR_S);
+	r->decel = (int32_t)(((uint64_t)decel << 16) / RAMPA_PASOS_POR_S);
+	r->jerk = (int32_t)(((uint64_t)jerk << 16) / ((uint64_t)RAMPA_PASOS_POR_S * RAMPA_PASOS_POR_S));
+
+	if (r->jerk == 0)
+		r->jerk = 1;
+}
+
+/**
+ * @brief Esta función lleva la rampa a una velocidad, sin transición.
+ */
+void rampa_reiniciar(rampa_t *r, uint32_t vel_mh)
+{
+	r->actual = (int32_t)(vel_mh << 16);
+	r->objetivo = r->actual;
+	r->tasa = 0;
+}
+
+/**
+ * @brief Esta función cambia la velocidad a la que tiende la rampa.
+ */
+void rampa_objetivo(rampa_t *r, uint32_t vel_mh)
+{
+	r->objetivo = (int32_t)(vel_mh << 16);
+}
+
+/**
+ * @brief Esta función avanza la rampa un paso.
+ *
+ * @details La tasa cambia a lo sumo jerk por paso. Mientras la
+ * 			distancia al objetivo alcance para llevar la tasa a 0
+ * 			con ese jerk (tasa^2 / 2 * jerk), se acelera hasta el
+ * 			límite; si no, se empieza a frenar. Así la referencia
+ * 			sigue una curva S sin pasarse del objetivo. Si el
+ * 			objetivo cambia de sentido, primero se anula la tasa.
+ * 			El costo es fijo: un producto de 64 bits y algunas
+ * 			comparaciones.
+ */
+EN_RAM void rampa_paso(rampa_t *r)
+{
+	int32_t objetivo = r->objetivo;
+	int32_t d = objetivo - r->actual;
+	int32_t t = r->tasa;
+
+	if ((d == 0) && (t == 0))
+		return;
+
+	int32_t ad = (d < 0) ? -d : d;
+	int32_t at = (t < 0) ? -t : t;
+	uint8_t opuesto = (t != 0) && ((t > 0) != (d > 0));
+
+	if (opuesto) // Se anula la tasa antes de cambiar de sentido
+		at = (at > r->jerk) ? (at - r->jerk) : 0;
+	else if (((int64_t)at * at) >= ((int64_t)2 * r->jerk * ad)) // Hay que frenar para no pasarse
+		at = (at > r->jerk) ? (at - r->jerk) : r->jerk;
+	else
+	{
+		int32_t limite = (d > 0) ? r->acel : r->decel;
+
+		at += r->jerk;
+
+		if (at > limite)
+			at = limite;
+	}
+
+	if (opuesto)
+		t = (t > 0) ? at : -at;
+	else
+		t = (d > 0) ? at : -at;
+
+	r->actual += t;
+	r->tasa = t;
+
+	if (((d > 0) && (r->actual >= objetivo)) || ((d < 0) && (r->actual <= objetivo)) || (d == 0))
+	{
+		r->actual = objetivo;
+		r->tasa = 0;
+	}
+}
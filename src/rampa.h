@@ -0,0 +1,70 @@
+/*
+===============================================================================
+ Nombre      : rampa.h
+ Description : Generador de rampas de velocidad con aceleración y
+               jerk limitados (curva S)
+
+ La rampa avanza un paso por período del PWM. Posición (la velocidad de
+ referencia) y tasa (la aceleración) se guardan en Q16.16 para que
+ incrementos de menos de 1[m/h] por paso no se pierdan:
+
+   actual [m/h * 2^16]
+   tasa   [m/h * 2^16 por paso]
+   jerk   [m/h * 2^16 por paso^2]
+
+ Este módulo no depende del hardware.
+===============================================================================
+*/
+
+#ifndef RAMPA_H_
+#define RAMPA_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RAMPA_PASOS_POR_S 1000 // Un paso por período del PWM (1[ms])
+
+// Límites por defecto
+#define RAMPA_ACEL 1000 // [m/h por s] = 1[Km/h] por segundo
+#define RAMPA_DECEL 1500 // [m/h por s]
+#define RAMPA_JERK 4000 // [m/h por s^2]: la aceleración máxima se alcanza en 250[ms]
+
+typedef struct
+{
+	volatile int32_t objetivo; // Q16
+	int32_t actual; // Q16
+	int32_t tasa; // Q16 por paso, con signo
+	int32_t acel; // Q16 por paso
+	int32_t decel; // Q16 por paso
+	int32_t jerk; // Q16 por paso^2
+} rampa_t;
+
+void rampa_config(rampa_t *r, uint32_t acel, uint32_t decel, uint32_t jerk);
+void rampa_reiniciar(rampa_t *r, uint32_t vel_mh);
+void rampa_objetivo(rampa_t *r, uint32_t vel_mh);
+void rampa_paso(rampa_t *r);
+
+/**
+ * @brief Devuelve la velocidad de referencia actual [m/h].
+ */
+static inline __attribute__ ((always_inline)) uint32_t rampa_actual(const rampa_t *r)
+{
+	return (uint32_t)(r->actual >> 16);
+}
+
+/**
+ * @brief Devuelve 1 si la rampa llegó al objetivo y está quieta.
+ */
+static inline __attribute__ ((always_inline)) uint8_t rampa_quieta(const rampa_t *r)
+{
+	return (r->actual == r->objetivo) && (r->tasa == 0);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAMPA_H_ */
@@ -0,0 +1,203 @@
+/*
+===============================================================================
+ Nombre      : reloj.c
+ Description : Administración del reloj: PLL0 a 120[MHz], divisores de
+               PCLK y perfil de bajo consumo
+===============================================================================
+*/
+
+#include "lpc17xx_clkpwr.h"
+#include "ciclos.h"
+#include "reloj.h"
+
+#define PLL0CON_PLLE (1 << 0)
+#define PLL0CON_PLLC (1 << 1)
+#define PLL0STAT_PLLE (1 << 24)
+#define PLL0STAT_PLLC (1 << 25)
+#define PLL0STAT_PLOCK (1 << 26)
+#define FLASHCFG_FLASHTIM_POS 12 // Los bits 11:0 deben conservar su valor
+#define FLASH_HZ_POR_CICLO 20000000 // Un ciclo de acceso a la flash cada 20[MHz] de CCLK
+
+_Static_assert((RELOJ_FCCO_HZ >= 275000000) && (RELOJ_FCCO_HZ <= 550000000), "FCCO fuera de rango");
+_Static_assert((RELOJ_FCCO_HZ / RELOJ_DIV_COMPLETO) <= 120000000, "CCLK máximo del LPC1769: 120[MHz]");
+_Static_assert(((RELOJ_FCCO_HZ % RELOJ_DIV_COMPLETO) == 0) && (((RELOJ_FCCO_HZ / RELOJ_DIV_COMPLETO) % 4000000) == 0), "PCLK/4 debe ser un múltiplo de 1[MHz]");
+_Static_assert(((RELOJ_FCCO_HZ % RELOJ_DIV_REPOSO) == 0) && (((RELOJ_FCCO_HZ / RELOJ_DIV_REPOSO) % 4000000) == 0), "PCLK/4 debe ser un múltiplo de 1[MHz]");
+
+/**
+ * @brief Divisores de PCLK de los periféricos usados.
+ */
+static const struct
+{
+	uint32_t periferico;
+	uint32_t divisor;
+} pclk[] =
+{
+	{ CLKPWR_PCLKSEL_TIMER1, CLKPWR_PCLKSEL_CCLK_DIV_4 }, // Base de tiempo
+	{ CLKPWR_PCLKSEL_TIMER3, CLKPWR_PCLKSEL_CCLK_DIV_4 }, // Captura del pulso
+	{ CLKPWR_PCLKSEL_UART2, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCLKSEL_RIT, CLKPWR_PCLKSEL_CCLK_DIV_4 }, // Teclado
+	{ CLKPWR_PCLKSEL_QEI, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCLKSEL_ADC, CLKPWR_PCLKSEL_CCLK_DIV_8 }, // 15[MHz]; ADC_Init divide hasta la frecuencia pedida
+	{ CLKPWR_PCLKSEL_PWM1, CLKPWR_PCLKSEL_CCLK_DIV_1 } // Máxima resolución del duty (ver motor.c)
+};
+
+static reloj_callback_t reescalar = 0;
+static reloj_perfil_t actual = RELOJ_COMPLETO;
+static uint32_t transicion_us = 0;
+static uint32_t transicion_max_us = 0;
+
+static void alimentar(void);
+static void flash(uint32_t cclk);
+
+/**
+ * @brief Esta función lleva CCLK a 120[MHz] y fija los divisores de
+ * 		  PCLK. Se llama al comienzo de main, antes de configurar
+ * 		  cualquier periférico.
+ *
+ * @details SystemInit ya arrancó el oscilador principal y lo eligió
+ * 			como fuente del PLL0. Mientras el PLL0 engancha, CCLK es
+ * 			el oscilador sin dividir (12[MHz]).
+ *
+ * @param callback Se llama en cada cambio de perfil, con CCLK ya
+ * 				   cambiado y las interrupciones enmascaradas.
+ */
+void reloj_init(reloj_callback_t callback)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	if (LPC_SC->PLL0STAT & PLL0STAT_PLLC)
+	{
+		LPC_SC->PLL0CON = PLL0CON_PLLE; // Desconectar antes de deshabilitar
+		alimentar();
+	}
+
+	LPC_SC->PLL0CON = 0;
+	alimentar();
+
+	LPC_SC->CCLKCFG = 0;
+
+	for (uint8_t i = 0; i < (sizeof(pclk) / sizeof(pclk[0])); i++)
+		CLKPWR_SetPCLKDiv(pclk[i].periferico, pclk[i].divisor); // Errata PCLKSELx.1: con el PLL0 desconectado
+
+	flash(RELOJ_FCCO_HZ / RELOJ_DIV_COMPLETO); // Antes de acelerar
+
+	LPC_SC->PLL0CFG = (RELOJ_PLL0_M - 1) | ((RELOJ_PLL0_N - 1) << 16);
+	alimentar();
+
+	LPC_SC->PLL0CON = PLL0CON_PLLE;
+	alimentar();
+
+	while (!(LPC_SC->PLL0STAT & PLL0STAT_PLOCK));
+
+	LPC_SC->CCLKCFG = RELOJ_DIV_COMPLETO - 1; // Antes de conectar
+
+	LPC_SC->PLL0CON = PLL0CON_PLLE | PLL0CON_PLLC;
+	alimentar();
+
+	while ((LPC_SC->PLL0STAT & (PLL0STAT_PLLE | PLL0STAT_PLLC)) != (PLL0STAT_PLLE | PLL0STAT_PLLC));
+
+	__set_PRIMASK(primask);
+
+	SystemCoreClockUpdate();
+
+	reescalar = callback;
+	actual = RELOJ_COMPLETO;
+	transicion_us = 0;
+	transicion_max_us = 0;
+}
+
+/**
+ * @brief Esta función cambia de perfil y reajusta los periféricos.
+ *
+ * @details Sólo cambia el divisor de CCLK: el PLL0 sigue enganchado,
+ * 			así que la transición dura lo que el reajuste. Todo se
+ * 			hace con las interrupciones enmascaradas, para que ningún
+ * 			handler vea un periférico a medio reajustar. Los estados
+ * 			de espera de la flash se suben antes de acelerar y se
+ * 			bajan después de frenar.
+ * 			La duración se mide con el contador de ciclos, cada tramo
+ * 			convertido con el CCLK con el que corrió.
+ */
+void reloj_perfil(reloj_perfil_t perfil)
+{
+	if (perfil == actual)
+		return;
+
+	uint32_t divisor = (perfil == RELOJ_COMPLETO) ? RELOJ_DIV_COMPLETO : RELOJ_DIV_REPOSO;
+	uint32_t cclk = RELOJ_FCCO_HZ / divisor;
+	uint32_t previo = SystemCoreClock;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	uint32_t t0 = ciclos_leer();
+
+	if (cclk > previo)
+		flash(cclk);
+
+	LPC_SC->CCLKCFG = divisor - 1;
+
+	uint32_t t1 = ciclos_leer();
+
+	if (cclk < previo)
+		flash(cclk);
+
+	SystemCoreClockUpdate();
+
+	actual = perfil;
+
+	if (reescalar)
+		reescalar();
+
+	uint32_t t2 = ciclos_leer();
+
+	__set_PRIMASK(primask);
+
+	transicion_us = ((t1 - t0) / (previo / 1000000)) + ((t2 - t1) / (cclk / 1000000));
+
+	if (transicion_us > transicion_max_us)
+		transicion_max_us = transicion_us;
+}
+
+reloj_perfil_t reloj_actual(void)
+{
+	return actual;
+}
+
+/**
+ * @brief Devuelve la duración del último cambio de perfil [us].
+ */
+uint32_t reloj_transicion_us(void)
+{
+	return transicion_us;
+}
+
+/**
+ * @brief Devuelve la duración del cambio de perfil más largo [us].
+ */
+uint32_t reloj_transicion_max_us(void)
+{
+	return transicion_max_us;
+}
+
+/**
+ * @brief Secuencia de feed que aplica los cambios de PLL0CON y
+ * 		  PLL0CFG. Las dos escrituras no deben interrumpirse.
+ */
+static void alimentar(void)
+{
+	LPC_SC->PLL0FEED = 0xaa;
+	LPC_SC->PLL0FEED = 0x55;
+}
+
+/**
+ * @brief Esta función fija los ciclos de acceso a la flash para un CCLK.
+ */
+static void flash(uint32_t cclk)
+{
+	uint32_t ciclos = (cclk + FLASH_HZ_POR_CICLO - 1) / FLASH_HZ_POR_CICLO; // 6 a 120[MHz], 2 a 24[MHz]
+
+	LPC_SC->FLASHCFG = (LPC_SC->FLASHCFG & 0xfff) | ((ciclos - 1) << FLASHCFG_FLASHTIM_POS);
+}
@@ -0,0 +1,53 @@
+/*
+===============================================================================
+ Nombre      : reloj.h
+ Description : Administración del reloj: PLL0 a 120[MHz], divisores de
+               PCLK y perfil de bajo consumo
+
+ reloj_init reprograma el PLL0 que dejó SystemInit (100[MHz]) para
+ FCCO = 360[MHz] y fija los divisores de PCLK de todos los periféricos
+ usados, con el PLL0 desconectado como exige la errata PCLKSELx.1.
+ Después, los perfiles sólo cambian el divisor de CCLK (CCLKCFG), que
+ no requiere volver a enganchar el PLL0:
+
+   perfil          CCLK        PCLK = CCLK/4   flash
+   RELOJ_COMPLETO  120[MHz]    30[MHz]         6 ciclos
+   RELOJ_REPOSO    24[MHz]     6[MHz]          2 ciclos
+
+ Con los dos perfiles PCLK/4 es un múltiplo entero de 1[MHz], así que
+ los timers siguen contando [us] exactos. Al cambiar de perfil se llama
+ al callback registrado en reloj_init, que reajusta todos los
+ periféricos que dependen de PCLK (ver reescalar_perifericos).
+===============================================================================
+*/
+
+#ifndef RELOJ_H_
+#define RELOJ_H_
+
+#include "lpc17xx.h"
+
+#define RELOJ_XTAL_HZ 12000000 // Oscilador principal
+#define RELOJ_PLL0_M 15
+#define RELOJ_PLL0_N 1
+#define RELOJ_FCCO_HZ ((2UL * RELOJ_PLL0_M * RELOJ_XTAL_HZ) / RELOJ_PLL0_N) // Entre 275 y 550[MHz]
+#define RELOJ_DIV_COMPLETO 3 // CCLK = FCCO / 3 = 120[MHz]
+#define RELOJ_DIV_REPOSO 15  // CCLK = FCCO / 15 = 24[MHz]
+
+/**
+ * @brief Perfiles de reloj.
+ */
+typedef enum
+{
+	RELOJ_COMPLETO = 0,
+	RELOJ_REPOSO
+} reloj_perfil_t;
+
+typedef void (*reloj_callback_t)(void);
+
+void reloj_init(reloj_callback_t reescalar);
+void reloj_perfil(reloj_perfil_t perfil);
+reloj_perfil_t reloj_actual(void);
+uint32_t reloj_transicion_us(void);
+uint32_t reloj_transicion_max_us(void);
+
+#endif /* RELOJ_H_ */
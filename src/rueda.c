@@ -0,0 +1,180 @@
+/*
+===============================================================================
+ Nombre      : rueda.c
+ Description : Rueda jerárquica de timers por software
+===============================================================================
+*/
+
+#include "rueda.h"
+
+#define RANURA_MASK (RUEDA_RANURAS - 1)
+#define INDICE(t, nivel) (((t) >> (RUEDA_BITS * (nivel))) & RANURA_MASK)
+
+static rueda_timer_t *ranuras[RUEDA_NIVELES][RUEDA_RANURAS];
+static uint32_t ahora = 0; // [ticks]
+
+static void insertar(rueda_timer_t *t);
+static void desenlazar(rueda_timer_t *t);
+static void cascada(uint8_t nivel);
+
+/**
+ * @brief Esta función vacía la rueda y fija el tick actual.
+ */
+void rueda_init(uint32_t tick)
+{
+	for (uint8_t n = 0; n < RUEDA_NIVELES; n++)
+		for (uint32_t i = 0; i < RUEDA_RANURAS; i++)
+			ranuras[n][i] = 0;
+
+	ahora = tick;
+}
+
+/**
+ * @brief Esta función arma (o rearma) un timer.
+ *
+ * @param ticks Ticks hasta el primer vencimiento; 0 se toma como 1.
+ * @param periodo Ticks entre vencimientos siguientes, 0 para un
+ * 				  timer de una sola vez.
+ */
+void rueda_armar(rueda_timer_t *t, uint32_t ticks, uint32_t periodo, rueda_callback_t callback, void *arg)
+{
+	if (t->ant)
+		desenlazar(t);
+
+	if (ticks == 0)
+		ticks = 1;
+	else if (ticks > RUEDA_ALCANCE)
+		ticks = RUEDA_ALCANCE;
+
+	t->vence = ahora + ticks;
+	t->periodo = (periodo > RUEDA_ALCANCE) ? RUEDA_ALCANCE : periodo;
+	t->callback = callback;
+	t->arg = arg;
+
+	insertar(t);
+}
+
+/**
+ * @brief Esta función desarma un timer. No hace nada si ya estaba
+ * 		  desarmado, así que se puede llamar desde su propio callback.
+ */
+void rueda_cancelar(rueda_timer_t *t)
+{
+	if (t->ant)
+		desenlazar(t);
+}
+
+/**
+ * @brief Esta función avanza la rueda un tick y ejecuta los
+ * 		  callbacks de los timers que vencen.
+ *
+ * @details Cuando el nivel 0 da la vuelta, se baja la ranura que
+ * 			corresponde del nivel 1; si éste también da la vuelta,
+ * 			la del nivel 2, y así. La lista de la ranura que vence se
+ * 			separa antes de recorrerla, así que un callback puede
+ * 			armar o cancelar cualquier timer, incluido el propio. Un
+ * 			timer periódico se rearma antes de llamar a su callback,
+ * 			contando desde el vencimiento (sin deriva).
+ *
+ * @return Cantidad de timers vencidos.
+ */
+uint32_t rueda_avanzar(void)
+{
+	uint32_t vencidos = 0;
+
+	ahora++;
+
+	for (uint8_t n = 1; (n < RUEDA_NIVELES) && (INDICE(ahora, n - 1) == 0); n++)
+		cascada(n);
+
+	rueda_timer_t *lista = ranuras[0][INDICE(ahora, 0)];
+
+	ranuras[0][INDICE(ahora, 0)] = 0;
+
+	if (lista)
+		lista->ant = &lista;
+
+	while (lista)
+	{
+		rueda_timer_t *t = lista;
+
+		desenlazar(t);
+
+		if (t->periodo)
+		{
+			t->vence += t->periodo;
+
+			insertar(t);
+		}
+
+		t->callback(t->arg);
+
+		vencidos++;
+	}
+
+	return vencidos;
+}
+
+/**
+ * @brief Devuelve el tick actual de la rueda.
+ */
+uint32_t rueda_ahora(void)
+{
+	return ahora;
+}
+
+/**
+ * @brief Esta función ubica un timer en la ranura que corresponde
+ * 		  a lo que le falta para vencer.
+ */
+static void insertar(rueda_timer_t *t)
+{
+	uint32_t falta = t->vence - ahora;
+	uint8_t n = 0;
+
+	while ((n < (RUEDA_NIVELES - 1)) && (falta >= (1UL << (RUEDA_BITS * (n + 1)))))
+		n++;
+
+	rueda_timer_t **cabeza = &ranuras[n][INDICE(t->vence, n)];
+
+	t->sig = *cabeza;
+	t->ant = cabeza;
+
+	if (*cabeza)
+		(*cabeza)->ant = &t->sig;
+
+	*cabeza = t;
+}
+
+static void desenlazar(rueda_timer_t *t)
+{
+	*t->ant = t->sig;
+
+	if (t->sig)
+		t->sig->ant = t->ant;
+
+	t->sig = 0;
+	t->ant = 0;
+}
+
+/**
+ * @brief Esta función reubica los timers de la ranura actual de un
+ * 		  nivel, que ahora están a menos de una vuelta del nivel
+ * 		  inferior.
+ */
+static void cascada(uint8_t nivel)
+{
+	uint32_t i = INDICE(ahora, nivel);
+	rueda_timer_t *t = ranuras[nivel][i];
+
+	ranuras[nivel][i] = 0;
+
+	while (t)
+	{
+		rueda_timer_t *sig = t->sig;
+
+		insertar(t);
+
+		t = sig;
+	}
+}
@@ -0,0 +1,67 @@
+/*
+===============================================================================
+ Nombre      : rueda.h
+ Description : Rueda jerárquica de timers por software
+
+ RUEDA_NIVELES niveles de RUEDA_RANURAS ranuras cada uno. El nivel 0
+ tiene una ranura por tick; cada ranura del nivel n abarca
+ RUEDA_RANURAS^n ticks. Un timer se ubica en el nivel que corresponde
+ a lo que le falta para vencer, y baja de nivel (cascada) cuando el
+ nivel inferior da la vuelta. Los timers de una ranura forman una
+ lista doblemente enlazada dentro de los mismos timers (no se reserva
+ memoria), así que armar y cancelar son O(1), y cada tick cuesta
+ O(1) más los timers que vencen; cada timer baja a lo sumo
+ RUEDA_NIVELES - 1 veces en toda su vida.
+
+ Todas las funciones se llaman desde el mismo contexto (una tarea
+ del planificador); los callbacks corren en ese contexto.
+
+ Este módulo no depende del hardware.
+===============================================================================
+*/
+
+#ifndef RUEDA_H_
+#define RUEDA_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RUEDA_BITS 6
+#define RUEDA_RANURAS (1UL << RUEDA_BITS)
+#define RUEDA_NIVELES 4
+#define RUEDA_ALCANCE ((1UL << (RUEDA_BITS * RUEDA_NIVELES)) - 1) // Máximo de ticks hasta el vencimiento
+
+typedef void (*rueda_callback_t)(void *arg);
+
+typedef struct rueda_timer
+{
+	struct rueda_timer *sig;
+	struct rueda_timer **ant; // Puntero que apunta a este timer (NULL = desarmado)
+	uint32_t vence; // [ticks]
+	uint32_t periodo; // [ticks], 0 = una sola vez
+	rueda_callback_t callback;
+	void *arg;
+} rueda_timer_t;
+
+void rueda_init(uint32_t ahora);
+void rueda_armar(rueda_timer_t *t, uint32_t ticks, uint32_t periodo, rueda_callback_t callback, void *arg);
+void rueda_cancelar(rueda_timer_t *t);
+uint32_t rueda_avanzar(void);
+uint32_t rueda_ahora(void);
+
+/**
+ * @brief Devuelve 1 si el timer está armado.
+ */
+static inline uint8_t rueda_armado(const rueda_timer_t *t)
+{
+	return t->ant != 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RUEDA_H_ */
@@ -0,0 +1,188 @@
+/*
+===============================================================================
+ Nombre      : sesion.c
+ Description : Grabación de la sesión en la SRAM AHB y volcado por UART2
+===============================================================================
+*/
+
+#include <cr_section_macros.h>
+#include "sesion.h"
+#include "uart_tx.h"
+
+// Los bancos de SRAM AHB (RAM2) no los usa ningún otro módulo
+__BSS(RAM2) static uint8_t registros[SESION_CAPACIDAD][TRAMA_REGISTRO_SIZE];
+
+static uint32_t inicio = 0; // Registro más viejo
+static uint32_t cantidad = 0;
+static uint16_t decimacion_actual = SESION_DECIMACION;
+static uint16_t decimacion_inicial = SESION_DECIMACION;
+static uint16_t ticks = 0; // Ticks desde el último registro
+static sesion_politica_t politica_actual = SESION_SOBRESCRIBIR;
+
+static volatile uint8_t volcando = 0; // Lo consulta DMA_IRQHandler
+static uint32_t volcado_idx = 0;
+static uint32_t volcado_total = 0;
+static uint8_t volcado_seq = 0;
+
+static void compactar(void);
+
+/**
+ * @brief Esta función configura la grabación.
+ *
+ * @param decimacion Segundos entre registros al comenzar una sesión.
+ * @param politica Qué hacer cuando se llenan los SESION_CAPACIDAD registros.
+ */
+void sesion_init(uint16_t decimacion, sesion_politica_t politica)
+{
+	decimacion_inicial = decimacion ? decimacion : 1;
+	politica_actual = politica;
+
+	sesion_iniciar();
+}
+
+/**
+ * @brief Esta función descarta la grabación anterior y
+ * 		  comienza una sesión nueva.
+ */
+void sesion_iniciar(void)
+{
+	inicio = 0;
+	cantidad = 0;
+	decimacion_actual = decimacion_inicial;
+	ticks = decimacion_actual - 1; // El primer tick se graba
+	volcando = 0;
+}
+
+/**
+ * @brief Esta función se llama una vez por segundo, a nivel de
+ * 		  tarea, con el estado actual del equipo.
+ *
+ * @details Se graba un registro cada decimacion_actual ticks. Con
+ * 			la grabación llena, SESION_SOBRESCRIBIR pisa el registro
+ * 			más viejo y SESION_COMPACTAR conserva la sesión completa
+ * 			con la mitad de resolución, por lo que una sesión larga
+ * 			nunca pierde el comienzo.
+ */
+void sesion_tick(const trama_registro_t *r)
+{
+	if (volcando) // No se mueven los índices durante el volcado
+		return;
+
+	if (++ticks < decimacion_actual)
+		return;
+
+	ticks = 0;
+
+	if (cantidad == SESION_CAPACIDAD)
+	{
+		if (politica_actual == SESION_COMPACTAR)
+		{
+			compactar(); // El registro nuevo queda a 2 * decimación del último conservado
+		}
+		else
+		{
+			inicio = (inicio + 1) % SESION_CAPACIDAD;
+			cantidad--;
+		}
+	}
+
+	trama_registro_serializar(r, registros[(inicio + cantidad) % SESION_CAPACIDAD]);
+
+	cantidad++;
+}
+
+uint32_t sesion_cantidad(void)
+{
+	return cantidad;
+}
+
+uint16_t sesion_decimacion(void)
+{
+	return decimacion_actual;
+}
+
+/**
+ * @brief Esta función comienza el volcado de la grabación por
+ * 		  UART2 en tramas de tipo TRAMA_TIPO_SESION.
+ *
+ * @details Cada trama lleva hasta TRAMA_SESION_REGISTROS registros
+ * 			y sale por GPDMA; el avance lo hace sesion_volcar_continuar
+ * 			cada vez que se libera un buffer de trama.
+ */
+void sesion_volcar(void)
+{
+	volcado_idx = 0;
+	volcado_total = cantidad;
+	volcado_seq = 0;
+	volcando = 1;
+
+	sesion_volcar_continuar();
+}
+
+/**
+ * @brief Esta función arma tramas de volcado mientras haya buffers
+ * 		  de trama libres. Se llama a nivel de tarea, al terminar
+ * 		  cada trama por DMA.
+ */
+void sesion_volcar_continuar(void)
+{
+	while (volcando && uart_tx_tramas_libres())
+	{
+		uint8_t payload[TRAMA_PAYLOAD_MAX];
+		uint32_t n = volcado_total - volcado_idx;
+
+		if (n > TRAMA_SESION_REGISTROS)
+			n = TRAMA_SESION_REGISTROS;
+
+		payload[0] = volcado_idx & 0xff;
+		payload[1] = volcado_idx >> 8;
+		payload[2] = volcado_total & 0xff;
+		payload[3] = volcado_total >> 8;
+		payload[4] = decimacion_actual & 0xff;
+		payload[5] = decimacion_actual >> 8;
+
+		uint8_t *p = &payload[TRAMA_SESION_ENCABEZADO];
+
+		for (uint32_t i = 0; i < n; i++)
+		{
+			const uint8_t *reg = registros[(inicio + volcado_idx + i) % SESION_CAPACIDAD];
+
+			for (uint8_t j = 0; j < TRAMA_REGISTRO_SIZE; j++)
+				*p++ = reg[j];
+		}
+
+		uint8_t *trama = uart_tx_trama_obtener();
+
+		uart_tx_trama_enviar(trama, trama_armar(trama, TRAMA_TIPO_SESION, volcado_seq++, payload,
+												TRAMA_SESION_ENCABEZADO + (n * TRAMA_REGISTRO_SIZE)));
+
+		volcado_idx += n;
+
+		if (volcado_idx >= volcado_total) // Una grabación vacía manda sólo el encabezado
+			volcando = 0;
+	}
+}
+
+uint8_t sesion_volcando(void)
+{
+	return volcando;
+}
+
+/**
+ * @brief Esta función conserva un registro de cada dos, en orden,
+ * 		  al comienzo del buffer, y duplica la decimación.
+ */
+static void compactar(void)
+{
+	for (uint32_t i = 0; i < (SESION_CAPACIDAD / 2); i++)
+	{
+		const uint8_t *origen = registros[(inicio + (2 * i)) % SESION_CAPACIDAD];
+
+		for (uint8_t j = 0; j < TRAMA_REGISTRO_SIZE; j++)
+			registros[i][j] = origen[j];
+	}
+
+	inicio = 0;
+	cantidad = SESION_CAPACIDAD / 2;
+	decimacion_actual *= 2;
+}
@@ -0,0 +1,36 @@
+/*
+===============================================================================
+ Nombre      : sesion.h
+ Description : Grabación de la sesión en la SRAM AHB y volcado por UART2
+===============================================================================
+*/
+
+#ifndef SESION_H_
+#define SESION_H_
+
+#include "lpc17xx.h"
+#include "trama.h"
+
+#define SESION_CAPACIDAD 2048 // Registros (16[KB] de SRAM AHB)
+#define SESION_DECIMACION 1 // Segundos entre registros por defecto
+
+/**
+ * @brief Política ante una grabación llena.
+ */
+typedef enum
+{
+	SESION_SOBRESCRIBIR = 0, // Buffer circular: se pisa el registro más viejo
+	SESION_COMPACTAR         // Se descarta un registro de cada dos y se duplica la decimación
+} sesion_politica_t;
+
+void sesion_init(uint16_t decimacion, sesion_politica_t politica);
+void sesion_iniciar(void);
+void sesion_tick(const trama_registro_t *r);
+uint32_t sesion_cantidad(void);
+uint16_t sesion_decimacion(void);
+
+void sesion_volcar(void);
+void sesion_volcar_continuar(void);
+uint8_t sesion_volcando(void);
+
+#endif /* SESION_H_ */
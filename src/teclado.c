@@ -0,0 +1,239 @@
+/*
+===============================================================================
+ Nombre      : teclado.c
+ Description : Teclado matricial 4x4 por barrido periódico con RIT
+===============================================================================
+*/
+
+#include "lpc17xx_gpio.h"
+#include "lpc17xx_rit.h"
+#include "teclado.h"
+#include "ciclos.h"
+
+#define PORT(x) x
+#define BIT(x) (1 << x)
+#define ROWS_MASK 0x0f // P2.0-3
+#define SIZE (ROWS * COLUMNS)
+#define COLA_MASK (TECLADO_COLA_SIZE - 1)
+
+static uint8_t fila = 0; // Fila que se está excitando en este tick
+static uint16_t estado = 0; // Mapa de teclas presionadas (ya sin rebote)
+static uint8_t contador[SIZE]; // Barridos consecutivos distintos del estado
+static uint8_t muestras_estables = TECLADO_MUESTRAS;
+static uint32_t t_ms = 0;
+
+static uint16_t rep_mascara = 0; // Teclas con repetición automática
+static uint16_t rep_retardo = 0;
+static uint16_t rep_periodo = 0;
+static uint32_t rep_prox[SIZE]; // Instante de la próxima repetición de cada tecla
+
+static teclado_evento_t cola[TECLADO_COLA_SIZE];
+static volatile uint32_t cabeza = 0; // Escribe RIT_IRQHandler
+static volatile uint32_t cola_idx = 0; // Lee la aplicación
+static volatile uint32_t perdidos = 0;
+static volatile uint32_t ciclos_max = 0;
+
+static void encolar(uint8_t tipo, uint8_t tecla);
+static void excitar_fila(uint8_t f);
+
+/**
+ * @brief Esta función inicializa el barrido del teclado y
+ * 		  arranca el RIT.
+ *
+ * @details Se asume que P2.0-3 (filas) están configurados como
+ * 			salidas y P2.4-7 (columnas) como entradas con pull-up.
+ *
+ * @param muestras Cantidad de barridos iguales consecutivos para
+ * 				   aceptar una presión o liberación.
+ */
+void teclado_init(uint8_t muestras)
+{
+	muestras_estables = muestras ? muestras : 1;
+	estado = 0;
+	fila = 0;
+	t_ms = 0;
+
+	for (uint8_t i = 0; i < SIZE; i++)
+		contador[i] = 0;
+
+	ciclos_init();
+
+	excitar_fila(fila);
+
+	RIT_Init(LPC_RIT);
+	teclado_reloj();
+
+	NVIC_SetPriority(RIT_IRQn, 14);
+	NVIC_EnableIRQ(RIT_IRQn);
+
+	RIT_Cmd(LPC_RIT, ENABLE);
+}
+
+/**
+ * @brief Esta función ajusta el período del RIT a la PCLK actual.
+ * 		  Se llama después de un cambio de reloj (ver reloj.h).
+ *
+ * @details El contador se vuelve a 0: si quedara por encima del nuevo
+ * 			valor de comparación, contaría hasta desbordar sin barrer
+ * 			el teclado.
+ */
+void teclado_reloj(void)
+{
+	RIT_TimerConfig(LPC_RIT, TECLADO_TICK_MS);
+
+	LPC_RIT->RICOUNTER = 0;
+}
+
+/**
+ * @brief Esta función configura la repetición automática.
+ *
+ * @details Las teclas de la máscara generan TECLADO_REPETICION
+ * 			mientras se mantienen presionadas: la primera luego de
+ * 			retardo_ms y las siguientes cada periodo_ms.
+ */
+void teclado_repeticion(uint16_t mascara, uint16_t retardo_ms, uint16_t periodo_ms)
+{
+	rep_retardo = retardo_ms;
+	rep_periodo = periodo_ms ? periodo_ms : 1;
+	rep_mascara = mascara;
+}
+
+/**
+ * @brief Esta función debe llamarse desde RIT_IRQHandler.
+ *
+ * @details En cada tick se leen las columnas de la fila excitada en
+ * 			el tick anterior (las líneas ya tuvieron un tick completo
+ * 			para estabilizarse, por lo que no se espera nada) y se
+ * 			excita la fila siguiente. Un barrido completo lleva
+ * 			ROWS ticks.
+ * 			Cada tecla de la fila leída tiene su propio contador de
+ * 			antirrebote, así que se detectan varias teclas a la vez.
+ * 			El costo por tick es fijo: COLUMNS teclas por llamada.
+ *
+ * @return Cantidad de eventos encolados en este tick.
+ */
+uint8_t teclado_rit_irq(void)
+{
+	uint32_t inicio = ciclos_leer();
+	uint32_t cabeza_inicial = cabeza;
+
+	t_ms += TECLADO_TICK_MS;
+
+	uint8_t cols = (~FIO_ByteReadValue(PORT(2), 0) >> 4) & 0xf; // '1' = presionada
+
+	for (uint8_t c = 0; c < COLUMNS; c++)
+	{
+		uint8_t k = (4 * fila) + c;
+		uint16_t bit = BIT(k);
+		uint8_t leida = (cols >> c) & 1;
+
+		if (leida != ((estado & bit) != 0))
+		{
+			if (++contador[k] >= muestras_estables)
+			{
+				contador[k] = 0;
+				estado ^= bit;
+
+				if (leida)
+				{
+					rep_prox[k] = t_ms + rep_retardo;
+
+					encolar(TECLADO_PRESION, k);
+				}
+				else
+					encolar(TECLADO_LIBERACION, k);
+			}
+		}
+		else
+		{
+			contador[k] = 0;
+
+			if ((estado & rep_mascara & bit) && ((int32_t)(t_ms - rep_prox[k]) >= 0))
+			{
+				rep_prox[k] += rep_periodo;
+
+				encolar(TECLADO_REPETICION, k);
+			}
+		}
+	}
+
+	fila = (fila + 1) % ROWS;
+
+	excitar_fila(fila);
+
+	uint32_t ciclos = ciclos_leer() - inicio;
+
+	if (ciclos > ciclos_max)
+		ciclos_max = ciclos;
+
+	return cabeza - cabeza_inicial;
+}
+
+/**
+ * @brief Esta función saca el próximo evento de la cola.
+ *
+ * @return 1 si había un evento, 0 si la cola estaba vacía.
+ */
+uint8_t teclado_leer(teclado_evento_t *ev)
+{
+	if (cola_idx == cabeza)
+		return 0;
+
+	*ev = cola[cola_idx & COLA_MASK];
+
+	cola_idx++;
+
+	return 1;
+}
+
+/**
+ * @brief Devuelve el mapa de bits de teclas presionadas (bit = tecla).
+ */
+uint16_t teclado_estado(void)
+{
+	return estado;
+}
+
+/**
+ * @brief Devuelve el peor costo medido de un tick de barrido [ciclos].
+ */
+uint32_t teclado_ciclos_max(void)
+{
+	return ciclos_max;
+}
+
+uint32_t teclado_eventos_perdidos(void)
+{
+	return perdidos;
+}
+
+/**
+ * @brief Esta función agrega un evento a la cola. Si la
+ * 		  aplicación no la vació a tiempo, se descarta.
+ */
+static void encolar(uint8_t tipo, uint8_t tecla)
+{
+	if ((cabeza - cola_idx) >= TECLADO_COLA_SIZE)
+	{
+		perdidos++;
+
+		return;
+	}
+
+	teclado_evento_t *ev = &cola[cabeza & COLA_MASK];
+
+	ev->tipo = tipo;
+	ev->tecla = tecla;
+	ev->t_ms = t_ms;
+
+	cabeza++;
+}
+
+/**
+ * @brief Esta función pone en '0' la fila indicada y en '1' el resto.
+ */
+static void excitar_fila(uint8_t f)
+{
+	FIO_ByteSetValue(PORT(2), 0, ROWS_MASK & ~BIT(f));
+	FIO_ByteClearValue(PORT(2), 0, BIT(f));
+}
@@ -0,0 +1,44 @@
+/*
+===============================================================================
+ Nombre      : teclado.h
+ Description : Teclado matricial 4x4 por barrido periódico con RIT
+===============================================================================
+*/
+
+#ifndef TECLADO_H_
+#define TECLADO_H_
+
+#include "lpc17xx.h"
+
+#define ROWS 4
+#define COLUMNS 4
+#define TECLADO_TICK_MS 1 // Período del RIT; se lee una fila por tick
+#define TECLADO_MUESTRAS 3 // Barridos estables por defecto (3 * 4[ms] = 12[ms])
+#define TECLADO_COLA_SIZE 16 // Debe ser potencia de 2
+
+// Eventos reportados a la aplicación
+#define TECLADO_PRESION 0
+#define TECLADO_LIBERACION 1
+#define TECLADO_REPETICION 2
+
+/**
+ * @brief Evento de teclado. tecla es la coordenada (4 * fila) + columna.
+ */
+typedef struct
+{
+	uint8_t tipo;
+	uint8_t tecla;
+	uint32_t t_ms; // Instante del evento [ms desde teclado_init]
+} teclado_evento_t;
+
+void teclado_init(uint8_t muestras);
+void teclado_reloj(void);
+void teclado_repeticion(uint16_t mascara, uint16_t retardo_ms, uint16_t periodo_ms);
+uint8_t teclado_rit_irq(void);
+uint8_t teclado_leer(teclado_evento_t *ev);
+uint16_t teclado_estado(void);
+
+uint32_t teclado_ciclos_max(void);
+uint32_t teclado_eventos_perdidos(void);
+
+#endif /* TECLADO_H_ */
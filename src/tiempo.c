@@ -0,0 +1,178 @@
+/*
+===============================================================================
+ Nombre      : tiempo.c
+ Description : Base de tiempo monotónica de 64 bits en [us] sobre TIMER1,
+               y tick de la rueda de timers (ver rueda.h)
+===============================================================================
+*/
+
+#include "lpc17xx_timer.h"
+#include "lpc17xx_clkpwr.h"
+#include "tiempo.h"
+#include "ram.h"
+
+#define MR_DESBORDE 0 // MR0 = 0xffffffff: el TC está por desbordar
+#define MR_TICK 1 // MR1 avanza TIEMPO_TICK_US en cada match
+
+static volatile uint32_t alto = 0; // 32 bits altos de la base de tiempo
+static volatile uint32_t ticks = 0; // Ticks de la rueda desde tiempo_init
+static uint32_t proximo_tick = TIEMPO_TICK_US;
+
+/**
+ * @brief Esta función arranca TIMER1 contando libremente de a 1[us].
+ *
+ * @details El TC nunca se resetea: MR0 interrumpe en 0xffffffff para
+ * 			contar los desbordes, y MR1 se corre TIEMPO_TICK_US en cada
+ * 			match para generar el tick de la rueda. Como el corrimiento
+ * 			es en aritmética de 32 bits, el tick sigue siendo exacto a
+ * 			través del desborde del TC.
+ */
+void tiempo_init(void)
+{
+	TIM_TIMERCFG_Type config;
+	TIM_MATCHCFG_Type config_match;
+
+	alto = 0;
+	ticks = 0;
+	proximo_tick = TIEMPO_TICK_US;
+
+	config.PrescaleOption = TIM_PRESCALE_USVAL;
+	config.PrescaleValue = 1;
+
+	TIM_Init(LPC_TIM1, TIM_TIMER_MODE, &config);
+
+	config_match.IntOnMatch = ENABLE;
+	config_match.StopOnMatch = DISABLE;
+	config_match.ResetOnMatch = DISABLE;
+	config_match.ExtMatchOutputType = TIM_EXTMATCH_NOTHING;
+
+	config_match.MatchChannel = MR_DESBORDE;
+	config_match.MatchValue = 0xffffffff;
+	TIM_ConfigMatch(LPC_TIM1, &config_match);
+
+	config_match.MatchChannel = MR_TICK;
+	config_match.MatchValue = proximo_tick;
+	TIM_ConfigMatch(LPC_TIM1, &config_match);
+
+	NVIC_SetPriority(TIMER1_IRQn, 5);
+	NVIC_EnableIRQ(TIMER1_IRQn);
+
+	TIM_Cmd(LPC_TIM1, ENABLE);
+}
+
+/**
+ * @brief Devuelve los microsegundos desde tiempo_init.
+ *
+ * @details Se puede llamar desde cualquier contexto. Si el TC ya
+ * 			desbordó pero TIMER1_IRQHandler todavía no contó el
+ * 			desborde (flag de MR0 pendiente y TC chico), se suma a mano.
+ */
+uint64_t tiempo_us(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	uint32_t h = alto;
+	uint32_t l = LPC_TIM1->TC;
+
+	if ((TIM_GetIntStatus(LPC_TIM1, TIM_MR0_INT) == SET) && (l < 0x80000000))
+		h++;
+
+	__set_PRIMASK(primask);
+
+	return ((uint64_t)h << 32) | l;
+}
+
+/**
+ * @brief Esta función debe llamarse desde TIMER1_IRQHandler.
+ *
+ * @return 1 si venció un tick de la rueda.
+ */
+uint8_t tiempo_irq(void)
+{
+	uint8_t tick = 0;
+
+	if (TIM_GetIntStatus(LPC_TIM1, TIM_MR0_INT) == SET)
+	{
+		alto++;
+
+		TIM_ClearIntPending(LPC_TIM1, TIM_MR0_INT);
+	}
+
+	if (TIM_GetIntStatus(LPC_TIM1, TIM_MR1_INT) == SET)
+	{
+		TIM_ClearIntPending(LPC_TIM1, TIM_MR1_INT);
+
+		proximo_tick += TIEMPO_TICK_US;
+		TIM_UpdateMatchValue(LPC_TIM1, MR_TICK, proximo_tick);
+
+		ticks++;
+		tick = 1;
+	}
+
+	return tick;
+}
+
+/**
+ * @brief Esta función reajusta el prescaler de un timer en marcha a
+ * 		  la PCLK actual, sin tocar el TC. Se llama después de un
+ * 		  cambio de reloj (ver reloj.h).
+ *
+ * @details El driver sólo calcula el prescaler en TIM_Init, que
+ * 			resetea el TC. El PC se vuelve a 0: si quedara por encima
+ * 			del nuevo PR contaría hasta desbordar antes de volver a
+ * 			incrementar el TC. Se pierde a lo sumo un tick del timer.
+ *
+ * @param pclksel Periférico del timer para CLKPWR_GetPCLK.
+ * @param tick_us Período del TC [us].
+ */
+void tiempo_reescalar(LPC_TIM_TypeDef *timer, uint32_t pclksel, uint32_t tick_us)
+{
+	uint32_t pr = ((CLKPWR_GetPCLK(pclksel) / 1000000) * tick_us) - 1;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	timer->PR = pr;
+	timer->PC = 0;
+
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Devuelve los ticks de la rueda vencidos desde tiempo_init.
+ */
+uint32_t tiempo_ticks(void)
+{
+	return ticks;
+}
+
+/**
+ * @brief Esta función devuelve el valor capturado por un canal de un
+ * 		  timer y limpia su interrupción. Se llama desde el handler
+ * 		  del timer.
+ *
+ * @details Accede a los registros sin pasar por el driver, que está
+ * 			en la flash: TIMER3_IRQHandler se sigue atendiendo mientras
+ * 			el IAP programa (ver ram.h).
+ *
+ * @param canal 0 (CAPn.0) o 1 (CAPn.1).
+ */
+EN_RAM uint32_t tiempo_captura(LPC_TIM_TypeDef *timer, uint8_t canal)
+{
+	uint32_t valor = canal ? timer->CR1 : timer->CR0;
+
+	timer->IR = TIM_IR_CLR(TIM_CR0_INT + canal);
+
+	return valor;
+}
+
+/**
+ * @brief Esta función devuelve el contador de un timer, en la misma
+ * 		  base de tiempo que sus capturas.
+ */
+uint32_t tiempo_contador(LPC_TIM_TypeDef *timer)
+{
+	return timer->TC;
+}
@@ -0,0 +1,25 @@
+/*
+===============================================================================
+ Nombre      : tiempo.h
+ Description : Base de tiempo monotónica de 64 bits en [us] sobre TIMER1,
+               y tick de la rueda de timers (ver rueda.h)
+===============================================================================
+*/
+
+#ifndef TIEMPO_H_
+#define TIEMPO_H_
+
+#include "lpc17xx.h"
+
+#define TIEMPO_TICK_US 10000 // Tick de la rueda de timers
+#define TIEMPO_TICKS_POR_S (1000000 / TIEMPO_TICK_US)
+
+void tiempo_init(void);
+uint64_t tiempo_us(void);
+uint8_t tiempo_irq(void);
+uint32_t tiempo_ticks(void);
+void tiempo_reescalar(LPC_TIM_TypeDef *timer, uint32_t pclksel, uint32_t tick_us);
+uint32_t tiempo_captura(LPC_TIM_TypeDef *timer, uint8_t canal);
+uint32_t tiempo_contador(LPC_TIM_TypeDef *timer);
+
+#endif /* TIEMPO_H_ */
@@ -0,0 +1,379 @@
+/*
+===============================================================================
+ Nombre      : trama.c
+ Description : Protocolo binario de telemetría (COBS + CRC-16)
+===============================================================================
+*/
+
+#include "trama.h"
+
+// Tabla de CRC-16/CCITT por nibble (16 entradas en lugar de 256)
+static const uint16_t crc_tabla[16] =
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+	0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef
+};
+
+/**
+ * @brief Esta función calcula el CRC-16/CCITT-FALSE de un bloque.
+ *
+ * @details Para comenzar un cálculo nuevo se pasa crc = 0xffff;
+ * 			para continuarlo, el valor devuelto por la llamada anterior.
+ */
+uint16_t trama_crc16(const uint8_t *datos, uint32_t len, uint16_t crc)
+{
+	for (uint32_t i = 0; i < len; i++)
+	{
+		crc = (crc << 4) ^ crc_tabla[((crc >> 12) ^ (datos[i] >> 4)) & 0xf];
+		crc = (crc << 4) ^ crc_tabla[((crc >> 12) ^ datos[i]) & 0xf];
+	}
+
+	return crc;
+}
+
+/**
+ * @brief Esta función codifica un bloque con COBS.
+ *
+ * @details La salida no contiene ningún 0x00 y ocupa como máximo
+ * 			len + len/254 + 1 bytes. No agrega el delimitador.
+ *
+ * @return Cantidad de bytes escritos en out.
+ */
+uint32_t trama_cobs_codificar(const uint8_t *in, uint32_t len, uint8_t *out)
+{
+	uint32_t escritos = 1;
+	uint32_t pos_codigo = 0;
+	uint8_t codigo = 1;
+
+	for (uint32_t i = 0; i < len; i++)
+	{
+		if (in[i] == 0)
+		{
+			out[pos_codigo] = codigo;
+			codigo = 1;
+			pos_codigo = escritos++;
+		}
+		else
+		{
+			out[escritos++] = in[i];
+			codigo++;
+
+			if (codigo == 0xff)
+			{
+				out[pos_codigo] = codigo;
+				codigo = 1;
+				pos_codigo = escritos++;
+			}
+		}
+	}
+
+	out[pos_codigo] = codigo;
+
+	return escritos;
+}
+
+/**
+ * @brief Esta función decodifica un bloque COBS (sin el delimitador).
+ *
+ * @return Cantidad de bytes decodificados, o 0 si el bloque es inválido.
+ */
+uint32_t trama_cobs_decodificar(const uint8_t *in, uint32_t len, uint8_t *out)
+{
+	uint32_t leidos = 0;
+	uint32_t escritos = 0;
+
+	while (leidos < len)
+	{
+		uint8_t codigo = in[leidos++];
+
+		if (codigo == 0)
+			return 0;
+
+		for (uint8_t i = 1; i < codigo; i++)
+		{
+			if ((leidos >= len) || (in[leidos] == 0))
+				return 0;
+
+			out[escritos++] = in[leidos++];
+		}
+
+		if ((codigo != 0xff) && (leidos < len))
+			out[escritos++] = 0;
+	}
+
+	return escritos;
+}
+
+/**
+ * @brief Esta función arma una trama completa lista para transmitir.
+ *
+ * @details out debe tener lugar para TRAMA_MAX_CODIFICADA(len) bytes.
+ *
+ * @return Cantidad de bytes de la trama codificada, incluyendo el
+ * 		   delimitador, o 0 si el payload es demasiado largo.
+ */
+uint32_t trama_armar(uint8_t *out, uint8_t tipo, uint8_t seq, const uint8_t *payload, uint32_t len)
+{
+	uint8_t cruda[TRAMA_PAYLOAD_MAX + TRAMA_OVERHEAD];
+
+	if (len > TRAMA_PAYLOAD_MAX)
+		return 0;
+
+	cruda[0] = (TRAMA_VERSION << 4) | (tipo & 0xf);
+	cruda[1] = seq;
+
+	for (uint32_t i = 0; i < len; i++)
+		cruda[2 + i] = payload[i];
+
+	uint16_t crc = trama_crc16(cruda, len + 2, 0xffff);
+
+	cruda[len + 2] = crc & 0xff;
+	cruda[len + 3] = crc >> 8;
+
+	uint32_t n = trama_cobs_codificar(cruda, len + TRAMA_OVERHEAD, out);
+
+	out[n++] = 0; // Delimitador
+
+	return n;
+}
+
+/**
+ * @brief Esta función valida y desarma una trama recibida.
+ *
+ * @details in es la trama codificada sin el delimitador final.
+ * 			payload debe tener lugar para TRAMA_PAYLOAD_MAX bytes.
+ *
+ * @return TRAMA_OK o el código de error correspondiente.
+ */
+uint8_t trama_abrir(const uint8_t *in, uint32_t len, uint8_t *tipo, uint8_t *seq, uint8_t *payload, uint32_t *plen)
+{
+	uint8_t cruda[TRAMA_PAYLOAD_MAX + TRAMA_OVERHEAD + 1];
+
+	if (len > TRAMA_MAX_CODIFICADA(TRAMA_PAYLOAD_MAX))
+		return TRAMA_ERR_LARGO;
+
+	uint32_t n = trama_cobs_decodificar(in, len, cruda);
+
+	if (n == 0)
+		return TRAMA_ERR_COBS;
+
+	if ((n < TRAMA_OVERHEAD) || (n > (TRAMA_PAYLOAD_MAX + TRAMA_OVERHEAD)))
+		return TRAMA_ERR_LARGO;
+
+	uint16_t crc = cruda[n - 2] | (cruda[n - 1] << 8);
+
+	if (trama_crc16(cruda, n - 2, 0xffff) != crc)
+		return TRAMA_ERR_CRC;
+
+	if ((cruda[0] >> 4) != TRAMA_VERSION)
+		return TRAMA_ERR_VERSION;
+
+	*tipo = cruda[0] & 0xf;
+	*seq = cruda[1];
+	*plen = n - TRAMA_OVERHEAD;
+
+	for (uint32_t i = 0; i < *plen; i++)
+		payload[i] = cruda[2 + i];
+
+	return TRAMA_OK;
+}
+
+/**
+ * @brief Esta función devuelve la cantidad de tramas perdidas
+ * 		  entre dos números de secuencia consecutivos recibidos.
+ */
+uint8_t trama_perdidas(uint8_t seq_anterior, uint8_t seq)
+{
+	return (uint8_t)(seq - seq_anterior - 1);
+}
+
+/**
+ * @brief Esta función escribe los campos de telemetría en el
+ * 		  payload (TRAMA_TELEMETRIA_SIZE bytes, little-endian).
+ */
+void trama_telemetria_serializar(const trama_telemetria_t *t, uint8_t *payload)
+{
+	payload[0] = t->ppm_x10 & 0xff;
+	payload[1] = t->ppm_x10 >> 8;
+	payload[2] = t->velocidad & 0xff;
+	payload[3] = t->velocidad >> 8;
+	payload[4] = (uint16_t)t->temperatura & 0xff;
+	payload[5] = (uint16_t)t->temperatura >> 8;
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		payload[6 + i] = (t->distancia >> (8 * i)) & 0xff;
+		payload[10 + i] = (t->tiempo_s >> (8 * i)) & 0xff;
+	}
+
+	payload[14] = t->velocidad_medida & 0xff;
+	payload[15] = t->velocidad_medida >> 8;
+	payload[16] = (uint16_t)t->error_velocidad & 0xff;
+	payload[17] = (uint16_t)t->error_velocidad >> 8;
+	payload[18] = t->energia & 0xff;
+	payload[19] = t->energia >> 8;
+	payload[20] = t->ppm_media & 0xff;
+	payload[21] = t->ppm_media >> 8;
+	payload[22] = t->ritmo & 0xff;
+	payload[23] = t->ritmo >> 8;
+}
+
+/**
+ * @brief Esta función lee los campos de telemetría de un payload.
+ */
+void trama_telemetria_deserializar(const uint8_t *payload, trama_telemetria_t *t)
+{
+	t->ppm_x10 = payload[0] | (payload[1] << 8);
+	t->velocidad = payload[2] | (payload[3] << 8);
+	t->temperatura = (int16_t)(payload[4] | (payload[5] << 8));
+	t->distancia = 0;
+	t->tiempo_s = 0;
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		t->distancia |= (uint32_t)payload[6 + i] << (8 * i);
+		t->tiempo_s |= (uint32_t)payload[10 + i] << (8 * i);
+	}
+
+	t->velocidad_medida = payload[14] | (payload[15] << 8);
+	t->error_velocidad = (int16_t)(payload[16] | (payload[17] << 8));
+	t->energia = payload[18] | (payload[19] << 8);
+	t->ppm_media = payload[20] | (payload[21] << 8);
+	t->ritmo = payload[22] | (payload[23] << 8);
+}
+
+/**
+ * @brief Esta función escribe los datos de estado en el payload
+ * 		  (TRAMA_ESTADO_SIZE bytes, little-endian).
+ */
+void trama_estado_serializar(const trama_estado_t *e, uint8_t *payload)
+{
+	payload[0] = e->encendida;
+	payload[1] = e->modo;
+	payload[2] = e->velocidad & 0xff;
+	payload[3] = e->velocidad >> 8;
+	payload[4] = e->velocidad_medida & 0xff;
+	payload[5] = e->velocidad_medida >> 8;
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		payload[6 + i] = (e->distancia >> (8 * i)) & 0xff;
+		payload[10 + i] = (e->tiempo_s >> (8 * i)) & 0xff;
+	}
+
+	payload[14] = e->energia & 0xff;
+	payload[15] = e->energia >> 8;
+	payload[16] = e->ppm_media & 0xff;
+	payload[17] = e->ppm_media >> 8;
+	payload[18] = e->latencia_max & 0xff;
+	payload[19] = e->latencia_max >> 8;
+
+	for (uint8_t i = 0; i < TRAMA_ESTADO_ZONAS; i++)
+	{
+		payload[20 + (2 * i)] = e->tiempo_zona[i] & 0xff;
+		payload[21 + (2 * i)] = e->tiempo_zona[i] >> 8;
+	}
+
+	payload[20 + (2 * TRAMA_ESTADO_ZONAS)] = e->reloj_mhz;
+	payload[21 + (2 * TRAMA_ESTADO_ZONAS)] = e->transicion_max_us & 0xff;
+	payload[22 + (2 * TRAMA_ESTADO_ZONAS)] = e->transicion_max_us >> 8;
+
+	uint8_t *p = payload + 23 + (2 * TRAMA_ESTADO_ZONAS); // Contadores
+
+	p[0] = e->plan_latencia_max_us & 0xff;
+	p[1] = e->plan_latencia_max_us >> 8;
+	p[2] = e->teclado_ciclos_max & 0xff;
+	p[3] = e->teclado_ciclos_max >> 8;
+	p[4] = e->pulso_rechazados & 0xff;
+	p[5] = e->pulso_rechazados >> 8;
+	p[6] = e->estado_reintentos & 0xff;
+	p[7] = e->estado_reintentos >> 8;
+	p[8] = e->uart_rx_descartadas & 0xff;
+	p[9] = e->uart_rx_descartadas >> 8;
+	p[10] = e->uart_rx_errores & 0xff;
+	p[11] = e->uart_rx_errores >> 8;
+	p[12] = e->uart_tx_descartadas & 0xff;
+	p[13] = e->uart_tx_descartadas >> 8;
+	p[14] = e->uart_tx_tramas_max;
+	p[15] = e->cmd_invalidos & 0xff;
+	p[16] = e->cmd_invalidos >> 8;
+	p[17] = e->cmd_fuera_de_plazo & 0xff;
+	p[18] = e->cmd_fuera_de_plazo >> 8;
+
+	for (uint8_t i = 0; i < 4; i++)
+		p[19 + i] = (e->recuperacion_us >> (8 * i)) & 0xff;
+}
+
+/**
+ * @brief Esta función lee los datos de estado de un payload.
+ */
+void trama_estado_deserializar(const uint8_t *payload, trama_estado_t *e)
+{
+	e->encendida = payload[0];
+	e->modo = payload[1];
+	e->velocidad = payload[2] | (payload[3] << 8);
+	e->velocidad_medida = payload[4] | (payload[5] << 8);
+	e->distancia = 0;
+	e->tiempo_s = 0;
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		e->distancia |= (uint32_t)payload[6 + i] << (8 * i);
+		e->tiempo_s |= (uint32_t)payload[10 + i] << (8 * i);
+	}
+
+	e->energia = payload[14] | (payload[15] << 8);
+	e->ppm_media = payload[16] | (payload[17] << 8);
+	e->latencia_max = payload[18] | (payload[19] << 8);
+
+	for (uint8_t i = 0; i < TRAMA_ESTADO_ZONAS; i++)
+		e->tiempo_zona[i] = payload[20 + (2 * i)] | (payload[21 + (2 * i)] << 8);
+
+	e->reloj_mhz = payload[20 + (2 * TRAMA_ESTADO_ZONAS)];
+	e->transicion_max_us = payload[21 + (2 * TRAMA_ESTADO_ZONAS)] | (payload[22 + (2 * TRAMA_ESTADO_ZONAS)] << 8);
+
+	const uint8_t *p = payload + 23 + (2 * TRAMA_ESTADO_ZONAS); // Contadores
+
+	e->plan_latencia_max_us = p[0] | (p[1] << 8);
+	e->teclado_ciclos_max = p[2] | (p[3] << 8);
+	e->pulso_rechazados = p[4] | (p[5] << 8);
+	e->estado_reintentos = p[6] | (p[7] << 8);
+	e->uart_rx_descartadas = p[8] | (p[9] << 8);
+	e->uart_rx_errores = p[10] | (p[11] << 8);
+	e->uart_tx_descartadas = p[12] | (p[13] << 8);
+	e->uart_tx_tramas_max = p[14];
+	e->cmd_invalidos = p[15] | (p[16] << 8);
+	e->cmd_fuera_de_plazo = p[17] | (p[18] << 8);
+	e->recuperacion_us = 0;
+
+	for (uint8_t i = 0; i < 4; i++)
+		e->recuperacion_us |= (uint32_t)p[19 + i] << (8 * i);
+}
+
+/**
+ * @brief Esta función escribe un registro de sesión
+ * 		  (TRAMA_REGISTRO_SIZE bytes, little-endian).
+ */
+void trama_registro_serializar(const trama_registro_t *r, uint8_t *payload)
+{
+	payload[0] = r->tiempo_s & 0xff;
+	payload[1] = r->tiempo_s >> 8;
+	payload[2] = r->ppm;
+	payload[3] = r->velocidad;
+	payload[4] = (uint16_t)r->temperatura & 0xff;
+	payload[5] = (uint16_t)r->temperatura >> 8;
+	payload[6] = r->distancia & 0xff;
+	payload[7] = r->distancia >> 8;
+}
+
+/**
+ * @brief Esta función lee un registro de sesión.
+ */
+void trama_registro_deserializar(const uint8_t *payload, trama_registro_t *r)
+{
+	r->tiempo_s = payload[0] | (payload[1] << 8);
+	r->ppm = payload[2];
+	r->velocidad = payload[3];
+	r->temperatura = (int16_t)(payload[4] | (payload[5] << 8));
+	r->distancia = payload[6] | (payload[7] << 8);
+}
@@ -0,0 +1,168 @@
+/*
+===============================================================================
+ Nombre      : trama.h
+ Description : Protocolo binario de telemetría (COBS + CRC-16)
+
+ Formato de una trama antes de codificar:
+
+   +----------------+-----+-----------+-----------+
+   | versión | tipo | seq | payload   | CRC-16    |
+   |  4 bits 4 bits | 1 B | 0..64 B   | 2 B (LE)  |
+   +----------------+-----+-----------+-----------+
+
+ El CRC es CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) sobre el
+ encabezado y el payload. La trama completa se codifica con COBS y
+ se termina con un 0x00, que funciona como delimitador. Todos los
+ campos multibyte son little-endian.
+
+ Este módulo no depende del hardware: el mismo código se puede
+ compilar en una PC para decodificar lo que envía el equipo.
+===============================================================================
+*/
+
+#ifndef TRAMA_H_
+#define TRAMA_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRAMA_VERSION 4 // 2: velocidad en décimas de Km/h; 3: métricas en la telemetría; 4: ppm en décimas y contadores en el estado
+#define TRAMA_PAYLOAD_MAX 64
+#define TRAMA_OVERHEAD 4 // Encabezado (2) + CRC (2)
+#define TRAMA_MAX_CODIFICADA(n) ((n) + TRAMA_OVERHEAD + (((n) + TRAMA_OVERHEAD) / 254) + 2)
+
+// Tipos de trama
+#define TRAMA_TIPO_TELEMETRIA 0x1
+#define TRAMA_TIPO_SESION 0x2
+#define TRAMA_TIPO_PERFIL 0x3
+#define TRAMA_TIPO_COMANDO 0x4 // Del receptor al equipo
+#define TRAMA_TIPO_RESPUESTA 0x5 // Lleva el seq del comando que responde
+#define TRAMA_TIPO_ARRANQUE 0x6 // Traza del arranque (ver arranque.h)
+#define TRAMA_TIPO_LATENCIA 0x7 // Latencia de entrada a interrupciones (ver latencia.h)
+
+/*
+ Payload de una trama de comando:
+   código (1 B) | argumentos
+ Payload de una trama de respuesta:
+   código (1 B) | resultado (1 B) | datos
+*/
+#define TRAMA_CMD_ARRANCAR 0x01 // Como 'A' seguido de 'D'
+#define TRAMA_CMD_DETENER 0x02 // Como 'C'
+#define TRAMA_CMD_VELOCIDAD 0x03 // velocidad (2 B) [décimas de Km/h]
+#define TRAMA_CMD_ESTADO 0x04 // Responde con trama_estado_t
+#define TRAMA_CMD_TELEMETRIA 0x05 // período (1 B) [décimas de s], 1..100
+#define TRAMA_CMD_PERFIL 0x06 // Vuelca la duración de los handlers en tramas TRAMA_TIPO_PERFIL (ver perfil.h)
+
+#define TRAMA_RESP_OK 0
+#define TRAMA_RESP_DESCONOCIDO 1
+#define TRAMA_RESP_ARGUMENTO 2 // Argumento ausente o fuera de rango
+#define TRAMA_RESP_APAGADA 3 // Requiere la cinta encendida
+#define TRAMA_RESP_ENCABEZADO 2
+
+// Resultados de trama_abrir
+#define TRAMA_OK 0
+#define TRAMA_ERR_COBS 1
+#define TRAMA_ERR_LARGO 2
+#define TRAMA_ERR_CRC 3
+#define TRAMA_ERR_VERSION 4
+
+/**
+ * @brief Campos de una trama de telemetría.
+ */
+typedef struct
+{
+	uint16_t ppm_x10;     // [décimas de pulsaciones/min], 0 sin medición
+	uint16_t velocidad;   // [décimas de Km/h]
+	int16_t temperatura;  // [centésimas de ºC]
+	uint32_t distancia;   // [m]
+	uint32_t tiempo_s;    // [s]
+	uint16_t velocidad_medida; // [m/h], por encoder
+	int16_t error_velocidad;   // [m/h], referencia - medida
+	uint16_t energia;     // [kcal]
+	uint16_t ppm_media;   // [pulsaciones/min]
+	uint16_t ritmo;       // [s/km], medio de la sesión
+} trama_telemetria_t;
+
+#define TRAMA_TELEMETRIA_SIZE 24
+
+#define TRAMA_ESTADO_ZONAS 7 // Sin pulso, debajo de la zona 1 y zonas 1 a 5
+
+/**
+ * @brief Datos de la respuesta a TRAMA_CMD_ESTADO.
+ */
+typedef struct
+{
+	uint8_t encendida;
+	uint8_t modo;         // 0: manual, 1: programa, 2: crucero
+	uint16_t velocidad;   // [décimas de Km/h]
+	uint16_t velocidad_medida; // [m/h]
+	uint32_t distancia;   // [m]
+	uint32_t tiempo_s;    // [s]
+	uint16_t energia;     // [kcal]
+	uint16_t ppm_media;   // [pulsaciones/min]
+	uint16_t latencia_max; // [us], del peor comando hasta su actuación
+	uint16_t tiempo_zona[TRAMA_ESTADO_ZONAS]; // [s]
+	uint8_t reloj_mhz;    // CCLK actual (ver reloj.h)
+	uint16_t transicion_max_us; // Cambio de perfil de reloj más largo
+	// Contadores de diagnóstico, saturados
+	uint16_t plan_latencia_max_us; // Peor espera de un evento hasta su handler (ver planificador.h)
+	uint16_t teclado_ciclos_max;   // Peor tick de barrido del teclado [ciclos]
+	uint16_t pulso_rechazados;     // Intervalos descartados por el filtro del pulso
+	uint16_t estado_reintentos;    // Lecturas del bloque de estado repetidas (ver estado.h)
+	uint16_t uart_rx_descartadas;  // Tramas recibidas descartadas (ver uart_rx.h)
+	uint16_t uart_rx_errores;      // Errores de línea de UART2
+	uint16_t uart_tx_descartadas;  // Tramas a transmitir sin buffer libre
+	uint8_t uart_tx_tramas_max;    // Máximo de tramas en vuelo a la vez (ver uart_tx.h)
+	uint16_t cmd_invalidos;        // Tramas que no son un comando válido
+	uint16_t cmd_fuera_de_plazo;   // Comandos que superaron el plazo hasta su actuación
+	uint32_t recuperacion_us;      // Recuperación de la bitácora al arrancar
+} trama_estado_t;
+
+#define TRAMA_ESTADO_SIZE (46 + (2 * TRAMA_ESTADO_ZONAS))
+
+/**
+ * @brief Registro de la grabación de una sesión (ver sesion.h).
+ */
+typedef struct
+{
+	uint16_t tiempo_s;    // [s]
+	uint8_t ppm;          // [pulsaciones/min]
+	uint8_t velocidad;    // [décimas de Km/h]
+	int16_t temperatura;  // [centésimas de ºC]
+	uint16_t distancia;   // [m]
+} trama_registro_t;
+
+#define TRAMA_REGISTRO_SIZE 8
+
+/*
+ Payload de una trama de sesión:
+   primero (2 B) | total (2 B) | decimación (2 B) | n registros (n * 8 B)
+ primero es el índice del primer registro de la trama dentro de la
+ grabación; la última trama cumple primero + n == total.
+*/
+#define TRAMA_SESION_ENCABEZADO 6
+#define TRAMA_SESION_REGISTROS ((TRAMA_PAYLOAD_MAX - TRAMA_SESION_ENCABEZADO) / TRAMA_REGISTRO_SIZE)
+
+uint16_t trama_crc16(const uint8_t *datos, uint32_t len, uint16_t crc);
+uint32_t trama_cobs_codificar(const uint8_t *in, uint32_t len, uint8_t *out);
+uint32_t trama_cobs_decodificar(const uint8_t *in, uint32_t len, uint8_t *out);
+
+uint32_t trama_armar(uint8_t *out, uint8_t tipo, uint8_t seq, const uint8_t *payload, uint32_t len);
+uint8_t trama_abrir(const uint8_t *in, uint32_t len, uint8_t *tipo, uint8_t *seq, uint8_t *payload, uint32_t *plen);
+uint8_t trama_perdidas(uint8_t seq_anterior, uint8_t seq);
+
+void trama_telemetria_serializar(const trama_telemetria_t *t, uint8_t *payload);
+void trama_telemetria_deserializar(const uint8_t *payload, trama_telemetria_t *t);
+void trama_estado_serializar(const trama_estado_t *e, uint8_t *payload);
+void trama_estado_deserializar(const uint8_t *payload, trama_estado_t *e);
+void trama_registro_serializar(const trama_registro_t *r, uint8_t *payload);
+void trama_registro_deserializar(const uint8_t *payload, trama_registro_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRAMA_H_ */
@@ -0,0 +1,194 @@
+/*
+===============================================================================
+ Nombre      : uart_rx.c
+ Description : Recepción de tramas por UART2 mediante buffer circular
+===============================================================================
+*/
+
+#include "lpc17xx_uart.h"
+#include "uart_rx.h"
+#include "ciclos.h"
+
+#define UART_RX_MASK (UART_RX_BUF_SIZE - 1)
+#define TRAMAS_MASK (UART_RX_TRAMAS - 1)
+#define DELIMITADOR 0x00
+#define LINESTAT_ERROR (UART_LINESTAT_OE | UART_LINESTAT_PE | UART_LINESTAT_FE | UART_LINESTAT_BI)
+
+static uint8_t buf[UART_RX_BUF_SIZE];
+static volatile uint32_t cabeza = 0; // Escribe UART2_IRQHandler
+static volatile uint32_t cola = 0; // Lee la tarea de comandos
+static uint32_t inicio = 0; // Comienzo de la trama que se está recibiendo
+static uint8_t descartando = 0; // Flag para ignorar bytes hasta el próximo delimitador
+
+static uint32_t llegada[UART_RX_TRAMAS]; // Ciclo en que llegó el delimitador de cada trama
+static volatile uint32_t tramas_cabeza = 0;
+static volatile uint32_t tramas_cola = 0;
+
+static volatile uint32_t descartadas = 0;
+static volatile uint32_t errores = 0;
+
+/**
+ * @brief Esta función inicializa la recepción y habilita las
+ * 		  interrupciones por dato recibido y por error de línea.
+ *
+ * @details Se asume que la UART2 ya fue configurada con cfg_uart2,
+ * 			con el nivel de disparo del FIFO de recepción elegido
+ * 			allí. La interrupción RBR cubre tanto el nivel de disparo
+ * 			(RDA) como el timeout de caracter (CTI), que vacía los
+ * 			bytes que quedaron por debajo del nivel cuando la línea
+ * 			se calla.
+ */
+void uart_rx_init(void)
+{
+	cabeza = 0;
+	cola = 0;
+	inicio = 0;
+	descartando = 0;
+	tramas_cabeza = 0;
+	tramas_cola = 0;
+	descartadas = 0;
+	errores = 0;
+
+	ciclos_init();
+
+	UART_IntConfig(LPC_UART2, UART_INTCFG_RBR, ENABLE);
+	UART_IntConfig(LPC_UART2, UART_INTCFG_RLS, ENABLE);
+
+	NVIC_SetPriority(UART2_IRQn, 12);
+	NVIC_EnableIRQ(UART2_IRQn);
+}
+
+/**
+ * @brief Esta función debe llamarse desde UART2_IRQHandler ante
+ * 		  RDA, CTI o RLS.
+ *
+ * @details Se vacía el FIFO de recepción en el buffer circular. Los
+ * 			bytes de la trama en curso quedan después del último
+ * 			delimitador, donde la tarea no lee, así que una trama que
+ * 			no entra (buffer lleno, demasiado larga, sin lugar en la
+ * 			cola de tramas) o que llega con un error de línea se
+ * 			descarta completa volviendo cabeza a su comienzo. Al
+ * 			recibir el delimitador se registra el ciclo de llegada,
+ * 			que es el origen de la latencia del comando.
+ * 			El costo es fijo por byte; con el nivel de disparo en 8
+ * 			bytes hay una interrupción cada 8 bytes en lugar de una
+ * 			por byte.
+ *
+ * @return Cantidad de tramas completas recibidas en esta llamada.
+ */
+uint8_t uart_rx_irq(void)
+{
+	uint8_t completas = 0;
+	uint8_t lsr;
+
+	while ((lsr = UART_GetLineStatus(LPC_UART2)) & UART_LINESTAT_RDR) // La lectura del LSR limpia los errores
+	{
+		uint8_t byte = UART_ReceiveByte(LPC_UART2);
+
+		if (lsr & LINESTAT_ERROR)
+		{
+			errores++;
+
+			descartando = 1;
+		}
+
+		if (byte == DELIMITADOR)
+		{
+			if (descartando)
+			{
+				descartadas++;
+
+				descartando = 0;
+				cabeza = inicio;
+			}
+			else if (cabeza != inicio) // Se ignoran los delimitadores repetidos
+			{
+				llegada[tramas_cabeza & TRAMAS_MASK] = ciclos_leer();
+
+				buf[cabeza & UART_RX_MASK] = DELIMITADOR;
+				cabeza++;
+				inicio = cabeza;
+				tramas_cabeza++;
+				completas++;
+			}
+
+			continue;
+		}
+
+		if (descartando)
+			continue;
+
+		if (((cabeza - cola) >= (UART_RX_BUF_SIZE - 1)) || ((cabeza - inicio) >= UART_RX_TRAMA_SIZE) ||
+			((tramas_cabeza - tramas_cola) >= UART_RX_TRAMAS))
+		{
+			descartando = 1;
+			cabeza = inicio;
+
+			continue;
+		}
+
+		buf[cabeza & UART_RX_MASK] = byte;
+		cabeza++;
+	}
+
+	if ((lsr & UART_LINESTAT_OE) && !descartando) // Se perdieron bytes por desborde del FIFO
+	{
+		errores++;
+
+		descartando = 1;
+		cabeza = inicio;
+	}
+
+	return completas;
+}
+
+/**
+ * @brief Esta función saca la próxima trama completa del buffer.
+ *
+ * @details Se llama desde una tarea. out debe tener lugar para
+ * 			UART_RX_TRAMA_SIZE bytes; la trama se copia sin el
+ * 			delimitador, lista para trama_abrir.
+ *
+ * @param t_llegada Ciclo del DWT en que llegó el delimitador.
+ *
+ * @return 1 si había una trama, 0 si no.
+ */
+uint8_t uart_rx_trama(uint8_t *out, uint32_t *len, uint32_t *t_llegada)
+{
+	if (tramas_cola == tramas_cabeza)
+		return 0;
+
+	uint32_t i = cola;
+	uint32_t n = 0;
+
+	while (buf[i & UART_RX_MASK] != DELIMITADOR)
+	{
+		out[n++] = buf[i & UART_RX_MASK];
+		i++;
+	}
+
+	*len = n;
+	*t_llegada = llegada[tramas_cola & TRAMAS_MASK];
+
+	cola = i + 1; // Se libera el lugar recién después de copiar
+	tramas_cola++;
+
+	return 1;
+}
+
+/**
+ * @brief Devuelve las tramas descartadas por falta de lugar, por
+ * 		  exceder UART_RX_TRAMA_SIZE o por errores de línea.
+ */
+uint32_t uart_rx_descartadas(void)
+{
+	return descartadas;
+}
+
+/**
+ * @brief Devuelve los errores de línea (desborde, paridad, framing, break).
+ */
+uint32_t uart_rx_errores(void)
+{
+	return errores;
+}
@@ -0,0 +1,24 @@
+/*
+===============================================================================
+ Nombre      : uart_rx.h
+ Description : Recepción de tramas por UART2 mediante buffer circular
+===============================================================================
+*/
+
+#ifndef UART_RX_H_
+#define UART_RX_H_
+
+#include "lpc17xx.h"
+
+#define UART_RX_BUF_SIZE 256 // Debe ser potencia de 2
+#define UART_RX_TRAMAS 8 // Tramas completas sin leer (debe ser potencia de 2)
+#define UART_RX_TRAMA_SIZE 80 // Tamaño máximo de una trama codificada, sin el delimitador
+
+void uart_rx_init(void);
+uint8_t uart_rx_irq(void);
+uint8_t uart_rx_trama(uint8_t *out, uint32_t *len, uint32_t *t_llegada);
+
+uint32_t uart_rx_descartadas(void);
+uint32_t uart_rx_errores(void);
+
+#endif /* UART_RX_H_ */
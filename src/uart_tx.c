@@ -0,0 +1,208 @@
+/*
+===============================================================================
+ Nombre      : uart_tx.c
+ Description : Transmisión no bloqueante de tramas completas por UART2
+               mediante GPDMA con doble buffer
+===============================================================================
+*/
+
+#include "lpc17xx_uart.h"
+#include "lpc17xx_gpdma.h"
+#include "uart_tx.h"
+
+// Estados de cada buffer de trama (doble buffer)
+#define TRAMA_LIBRE 0
+#define TRAMA_ARMANDO 1
+#define TRAMA_PENDIENTE 2
+#define TRAMA_EN_CURSO 3
+
+static uint8_t tramas[2][UART_TX_TRAMA_SIZE];
+static volatile uint8_t estado_trama[2] = { TRAMA_LIBRE, TRAMA_LIBRE };
+static volatile uint32_t len_trama[2] = { 0, 0 };
+static volatile uint8_t dma_activo = 0; // Flag para indicar que el DMA es dueño del FIFO
+static volatile uint32_t tramas_descartadas = 0;
+static volatile uint32_t tramas_max = 0; // Máximo de buffers ocupados a la vez
+
+static void arrancar_dma(uint8_t idx);
+static uint8_t trama_pendiente(void);
+
+/**
+ * @brief Esta función inicializa los buffers de trama.
+ *
+ * @details Se asume que la UART2 ya fue configurada con cfg_uart2
+ * 			(con el modo DMA del FIFO habilitado) y que el GPDMA
+ * 			ya fue inicializado. La transmisión no usa interrupciones
+ * 			de la UART: el fin de cada trama lo avisa el GPDMA.
+ */
+void uart_tx_init(void)
+{
+	estado_trama[0] = TRAMA_LIBRE;
+	estado_trama[1] = TRAMA_LIBRE;
+	dma_activo = 0;
+	tramas_descartadas = 0;
+	tramas_max = 0;
+}
+
+/**
+ * @brief Esta función devuelve un buffer de trama libre para
+ * 		  armar el próximo mensaje mientras el anterior sale por DMA.
+ *
+ * @details Se asume un único productor de tramas. Si ambos
+ * 			buffers están ocupados (uno en curso y otro pendiente),
+ * 			se devuelve NULL y la trama se cuenta como descartada.
+ * 			Al tomar un buffer se registra el máximo de tramas en
+ * 			vuelo (armándose, pendientes o saliendo por DMA).
+ */
+uint8_t *uart_tx_trama_obtener(void)
+{
+	uint8_t *trama = NULL;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	for (uint8_t i = 0; i < 2; i++)
+		if (estado_trama[i] == TRAMA_LIBRE)
+		{
+			estado_trama[i] = TRAMA_ARMANDO;
+			trama = tramas[i];
+
+			break;
+		}
+
+	uint32_t en_vuelo = 2 - uart_tx_tramas_libres();
+
+	if (trama == NULL)
+		tramas_descartadas++;
+	else if (en_vuelo > tramas_max)
+		tramas_max = en_vuelo;
+
+	__set_PRIMASK(primask);
+
+	return trama;
+}
+
+/**
+ * @brief Esta función entrega una trama armada (obtenida con
+ * 		  uart_tx_trama_obtener) para su envío por DMA.
+ *
+ * @details Si el DMA está libre, se arranca la transferencia de
+ * 			inmediato; si no, la trama queda pendiente y la lanza
+ * 			uart_tx_dma_irq al terminar la anterior.
+ */
+void uart_tx_trama_enviar(uint8_t *trama, uint32_t len)
+{
+	uint8_t idx = (trama == tramas[1]);
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	len_trama[idx] = (len > UART_TX_TRAMA_SIZE) ? UART_TX_TRAMA_SIZE : len;
+	estado_trama[idx] = TRAMA_PENDIENTE;
+
+	if (!dma_activo)
+		arrancar_dma(idx);
+
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Esta función debe llamarse desde DMA_IRQHandler ante
+ * 		  la finalización (o error) del canal UART_TX_DMA_CH.
+ *
+ * @details Se libera el buffer transmitido y se lanza la trama
+ * 			pendiente, si la hay.
+ */
+void uart_tx_dma_irq(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	for (uint8_t i = 0; i < 2; i++)
+		if (estado_trama[i] == TRAMA_EN_CURSO)
+			estado_trama[i] = TRAMA_LIBRE;
+
+	dma_activo = 0;
+
+	uint8_t idx = trama_pendiente();
+
+	if (idx < 2)
+		arrancar_dma(idx);
+
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Esta función devuelve la cantidad de buffers de trama
+ * 		  libres, para que un productor que envía muchas tramas
+ * 		  seguidas no las cuente como descartadas.
+ */
+uint8_t uart_tx_tramas_libres(void)
+{
+	return (estado_trama[0] == TRAMA_LIBRE) + (estado_trama[1] == TRAMA_LIBRE);
+}
+
+/**
+ * @brief Esta función configura el canal de GPDMA para copiar
+ * 		  la trama indicada al FIFO de transmisión de UART2.
+ */
+static void arrancar_dma(uint8_t idx)
+{
+	GPDMA_Channel_CFG_Type dma_cfg;
+
+	dma_cfg.ChannelNum = UART_TX_DMA_CH;
+	dma_cfg.SrcMemAddr = (uint32_t)tramas[idx];
+	dma_cfg.DstMemAddr = 0;
+	dma_cfg.TransferSize = len_trama[idx];
+	dma_cfg.TransferWidth = GPDMA_WIDTH_BYTE;
+	dma_cfg.TransferType = GPDMA_TRANSFERTYPE_M2P;
+	dma_cfg.SrcConn = 0;
+	dma_cfg.DstConn = GPDMA_CONN_UART2_Tx;
+	dma_cfg.DMALLI = 0;
+
+	GPDMA_Setup(&dma_cfg);
+
+	estado_trama[idx] = TRAMA_EN_CURSO;
+	dma_activo = 1;
+
+	GPDMA_ChannelCmd(UART_TX_DMA_CH, ENABLE);
+}
+
+/**
+ * @brief Esta función devuelve el índice de la trama pendiente
+ * 		  de envío, o 2 si no hay ninguna.
+ */
+static uint8_t trama_pendiente(void)
+{
+	for (uint8_t i = 0; i < 2; i++)
+		if (estado_trama[i] == TRAMA_PENDIENTE)
+			return i;
+
+	return 2;
+}
+
+/**
+ * @brief Devuelve 1 si no queda nada por transmitir: ninguna trama
+ * 		  pendiente ni saliendo por DMA, y el último byte ya salió
+ * 		  del registro de desplazamiento.
+ */
+uint8_t uart_tx_ocioso(void)
+{
+	return !dma_activo && (uart_tx_tramas_libres() == 2) && (UART_CheckBusy(LPC_UART2) == RESET);
+}
+
+/**
+ * @brief Devuelve las tramas descartadas por no haber buffer libre.
+ */
+uint32_t uart_tx_tramas_descartadas(void)
+{
+	return tramas_descartadas;
+}
+
+/**
+ * @brief Devuelve el máximo de tramas en vuelo a la vez (hasta 2).
+ */
+uint32_t uart_tx_tramas_max(void)
+{
+	return tramas_max;
+}
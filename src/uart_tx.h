@@ -0,0 +1,28 @@
+/*
+===============================================================================
+ Nombre      : uart_tx.h
+ Description : Transmisión no bloqueante de tramas completas por UART2
+               mediante GPDMA con doble buffer
+===============================================================================
+*/
+
+#ifndef UART_TX_H_
+#define UART_TX_H_
+
+#include "lpc17xx.h"
+
+#define UART_TX_TRAMA_SIZE 80 // Tamaño máximo de una trama enviada por DMA
+#define UART_TX_DMA_CH 1 // Canal de GPDMA asociado a UART2 TX
+
+void uart_tx_init(void);
+
+uint8_t *uart_tx_trama_obtener(void);
+void uart_tx_trama_enviar(uint8_t *trama, uint32_t len);
+void uart_tx_dma_irq(void);
+uint8_t uart_tx_tramas_libres(void);
+
+uint8_t uart_tx_ocioso(void);
+uint32_t uart_tx_tramas_descartadas(void);
+uint32_t uart_tx_tramas_max(void);
+
+#endif /* UART_TX_H_ */